@@ -98,12 +98,11 @@ ASTConverter::convertExpression(const std::string &src, TSNode node) {
             }
         }
 
-        // check for method calls (builtin + argument_list)
+        // check for method calls (target + builtin + argument_list)
         for (uint32_t i = 0; i < namedCount; ++i) {
             TSNode child = ts_node_named_child(node, i);
             if (ts_node_symbol(child) == NodeType::BUILTIN) {
-                std::string methodName = slice(src, child);
-                throw std::runtime_error("Method call ." + methodName + "() not supported by interpreter yet");
+                return convertMethodCall(src, node, i);
             }
         }
 
@@ -142,6 +141,91 @@ ASTConverter::convertExpression(const std::string &src, TSNode node) {
     throw std::runtime_error("Unknown expression type: " + std::string(ts_node_type(node)));
 }
 
+std::unique_ptr<ast::Expression>
+ASTConverter::convertMethodCall(const std::string &src, TSNode node, uint32_t builtinIndex) {
+    if (builtinIndex == 0) {
+        throw std::runtime_error("Method call has no target");
+    }
+    std::string methodName = slice(src, ts_node_named_child(node, builtinIndex));
+    auto target = convertExpression(src, ts_node_named_child(node, 0));
+
+    // argument_list wraps an optional expression_list of the arguments
+    std::vector<TSNode> argNodes;
+    if (builtinIndex + 1 < ts_node_named_child_count(node)) {
+        TSNode argList = ts_node_named_child(node, builtinIndex + 1);
+        for (uint32_t i = 0; i < ts_node_named_child_count(argList); ++i) {
+            TSNode arg = ts_node_named_child(argList, i);
+            if (ts_node_symbol(arg) == NodeType::EXPRESSION_LIST) {
+                for (uint32_t j = 0; j < ts_node_named_child_count(arg); ++j) {
+                    argNodes.push_back(ts_node_named_child(arg, j));
+                }
+            } else {
+                argNodes.push_back(arg);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<ast::Expression>> args;
+    if (methodName == "size" || methodName == "upfrom" || methodName == "contains") {
+        for (TSNode arg : argNodes) {
+            args.push_back(convertExpression(src, arg));
+        }
+        ast::Callable::Kind kind = methodName == "size" ? ast::Callable::Kind::SIZE
+                                 : methodName == "upfrom" ? ast::Callable::Kind::UP_FROM
+                                 : ast::Callable::Kind::CONTAINS;
+        if (args.size() != ast::builtinArity(kind)) {
+            throw std::runtime_error("Wrong number of arguments to ." + methodName + "()");
+        }
+        return ast::makeCallable(std::move(target), std::move(args), kind);
+    }
+
+    if (methodName == "collect") {
+        // collect(element, condition) keeps the elements the condition holds
+        // for. Conditions on one attribute of the element run natively:
+        // element.attr = value, or just element.attr for a Boolean attribute.
+        if (argNodes.size() != 2) {
+            throw std::runtime_error(".collect() takes an element name and a condition");
+        }
+        std::string element = slice(src, argNodes[0]);
+        auto condition = convertExpression(src, argNodes[1]);
+
+        auto elementAttribute = [&element](ast::Expression* expr) -> const ast::Attribute* {
+            auto attribute = ast::castExpressionToAttribute(expr);
+            if (!attribute) {
+                return nullptr;
+            }
+            auto base = ast::castExpressionToVariable(attribute->getBase());
+            return base && base->getName().name == element ? attribute : nullptr;
+        };
+
+        std::unique_ptr<ast::Expression> expected;
+        const ast::Attribute* attribute = elementAttribute(condition.get());
+        if (attribute) {
+            expected = ast::makeConstant(Value{Boolean{true}});
+        } else if (auto comparison = ast::castExpressionToComparison(condition.get());
+                   comparison && comparison->getKind() == ast::Comparison::Kind::EQ) {
+            attribute = elementAttribute(comparison->getLeft());
+            // The value is evaluated once, before any element is looked at
+            if (attribute && ast::mentionsVariable(comparison->getRight(), Name{element})) {
+                attribute = nullptr;
+            }
+            if (attribute) {
+                expected = ast::cloneExpression(comparison->getRight());
+            }
+        }
+        if (!attribute) {
+            throw std::runtime_error(".collect() condition must be " + element + ".<attribute> or "
+                                     + element + ".<attribute> = <value>");
+        }
+
+        args.push_back(ast::makeConstant(Value{attribute->getAttr()}));
+        args.push_back(std::move(expected));
+        return ast::makeCallable(std::move(target), std::move(args), ast::Callable::Kind::FILTER);
+    }
+
+    throw std::runtime_error("Method call ." + methodName + "() not supported by interpreter yet");
+}
+
 std::unique_ptr<ast::Constant>
 ASTConverter::convertConstant(const std::string &src, TSNode node) {
     TSSymbol symbol = ts_node_symbol(node);
@@ -293,7 +377,12 @@ ASTConverter::convertStatement(const std::string &src, TSNode node) {
     const auto& converters = getStatementConverters();
     auto it = converters.find(symbol);
     if (it != converters.end()) {
-        return it->second(src, node);
+        auto statement = it->second(src, node);
+
+        // carry the source position over for profiling and diagnostics
+        TSPoint start = ts_node_start_point(node);
+        statement->setLocation(ast::SourceLocation{start.row + 1, start.column + 1});
+        return statement;
     }
 
     throw std::runtime_error("Unknown statement type: " + std::string(ts_node_type(node)));
@@ -643,17 +732,115 @@ ASTConverter::convertForLoop(const std::string &src, TSNode node) {
 
 std::unique_ptr<ast::Statement>
 ASTConverter::convertParallelFor(const std::string &src, TSNode node) {
-    throw std::runtime_error("ParallelFor not supported by interpreter yet");
+    TSSymbol symbol = ts_node_symbol(node);
+
+    if (symbol != NodeType::PARALLEL_FOR) {
+        throw std::runtime_error("Expected PARALLEL_FOR node");
+    }
+
+    uint32_t childCount = ts_node_named_child_count(node);
+    if (childCount != 3) {
+        throw std::runtime_error("PARALLEL_FOR should have 3 named children (element, target, body)");
+    }
+
+    // Child 0: identifier (loop variable)
+    TSNode elementNode = ts_node_named_child(node, 0);
+    std::string elementName = extractText(src, elementNode);
+    auto elementVar = std::make_unique<ast::Variable>(Name{elementName});
+
+    // Child 1: expression (target list)
+    TSNode targetNode = ts_node_named_child(node, 1);
+    auto targetExpr = convertExpression(src, targetNode);
+
+    // Child 2: body (loop body statements)
+    TSNode bodyNode = ts_node_named_child(node, 2);
+    std::vector<std::unique_ptr<ast::Statement>> statements;
+
+    if (ts_node_symbol(bodyNode) == NodeType::BODY) {
+        uint32_t stmtCount = ts_node_named_child_count(bodyNode);
+        for (uint32_t i = 0; i < stmtCount; ++i) {
+            TSNode stmtNode = ts_node_named_child(bodyNode, i);
+            auto stmt = convertStatement(src, stmtNode);
+            statements.push_back(std::move(stmt));
+        }
+    }
+
+    return ast::makeParallelFor(std::move(elementVar), std::move(targetExpr), std::move(statements));
 }
 
 std::unique_ptr<ast::Statement>
 ASTConverter::convertMessage(const std::string &src, TSNode node) {
-    throw std::runtime_error("Message not supported by interpreter yet");
+    // message has 2 named children: player_set, quoted_string
+    if (ts_node_named_child_count(node) < 2) {
+        throw std::runtime_error("Message requires 2 children");
+    }
+
+    TSNode playersNode = ts_node_named_child(node, 0);
+    TSNode contentNode = ts_node_named_child(node, 1);
+
+    // "all" is anonymous, anything else is an expression for the players
+    std::unique_ptr<ast::Expression> players;
+    if (ts_node_named_child_count(playersNode) > 0) {
+        players = convertExpression(src, ts_node_named_child(playersNode, 0));
+    } else if (slice(src, playersNode) != "all") {
+        players = convertExpression(src, playersNode);
+    }
+
+    // Split the template once, here: literal text is whatever lies between
+    // the interpolations, so spacing in the source is kept exactly
+    std::vector<ast::Message::Segment> segments;
+    uint32_t textStart = ts_node_start_byte(contentNode) + 1; // past the opening quote
+    uint32_t contentEnd = ts_node_end_byte(contentNode) - 1;  // before the closing quote
+
+    uint32_t partCount = ts_node_named_child_count(contentNode);
+    for (uint32_t i = 0; i < partCount; ++i) {
+        TSNode part = ts_node_named_child(contentNode, i);
+        if (ts_node_symbol(part) != NodeType::STRING_INTERPOLATION) {
+            continue;
+        }
+
+        uint32_t partStart = ts_node_start_byte(part);
+        if (partStart > textStart) {
+            segments.push_back({src.substr(textStart, partStart - textStart), nullptr});
+        }
+        if (ts_node_named_child_count(part) == 0) {
+            throw std::runtime_error("Empty interpolation in message");
+        }
+        segments.push_back({"", convertExpression(src, ts_node_named_child(part, 0))});
+        textStart = ts_node_end_byte(part);
+    }
+    if (contentEnd > textStart) {
+        segments.push_back({src.substr(textStart, contentEnd - textStart), nullptr});
+    }
+
+    return ast::makeMessage(std::move(players), std::move(segments));
 }
 
 std::unique_ptr<ast::Statement>
 ASTConverter::convertScores(const std::string &src, TSNode node) {
-    throw std::runtime_error("Scores not supported by interpreter yet");
+    // scores has 1 named child: the list of attribute names to show
+    if (ts_node_named_child_count(node) < 1) {
+        throw std::runtime_error("Scores requires a list of attributes");
+    }
+
+    auto keysExpr = convertExpression(src, ts_node_named_child(node, 0));
+    auto* keysConstant = ast::castExpressionToConstant(keysExpr.get());
+    if (!keysConstant || !keysConstant->getValue().isList()) {
+        throw std::runtime_error("Scores attributes must be a list literal");
+    }
+
+    std::vector<String> keys;
+    for (const Value& key : keysConstant->getValue().asList().value) {
+        if (!key.isString()) {
+            throw std::runtime_error("Scores attributes must be strings");
+        }
+        keys.push_back(key.asString());
+    }
+    if (keys.empty()) {
+        throw std::runtime_error("Scores requires at least one attribute");
+    }
+
+    return ast::makeScores(std::move(keys));
 }
 
 std::unique_ptr<ast::Statement>
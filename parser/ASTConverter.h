@@ -78,6 +78,10 @@ private:
     static std::unique_ptr<ast::Attribute>
     convertQualifiedIdentifier(const std::string& src, TSNode node);
 
+    // target.builtin(args), where the builtin is named child builtinIndex
+    static std::unique_ptr<ast::Expression>
+    convertMethodCall(const std::string& src, TSNode node, uint32_t builtinIndex);
+
     // Value conversions for constants
     static Value convertValue(const std::string& src, TSNode node);
     static Value convertListLiteral(const std::string& src, TSNode node);
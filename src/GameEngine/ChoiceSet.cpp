@@ -0,0 +1,118 @@
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "ChoiceSet.h"
+
+
+namespace
+{
+    // Interned sets by content hash. Entries don't keep their set alive,
+    // each is erased by its set's deleter.
+    std::mutex internMutex;
+    std::unordered_multimap<size_t, std::pair<const void*, std::weak_ptr<const void>>> interned;
+
+    std::string
+    choiceText(const Value& choice)
+    {
+        if (choice.isString())
+        {
+            return choice.asString().value;
+        }
+        std::ostringstream text;
+        text << choice;
+        return text.str();
+    }
+
+    size_t
+    hashChoice(const Value& choice)
+    {
+        if (choice.isString())
+        {
+            return std::hash<String>{}(choice.asString());
+        }
+        if (choice.isInteger())
+        {
+            return std::hash<int>{}(choice.asInteger().value);
+        }
+        if (choice.isBoolean())
+        {
+            return std::hash<bool>{}(choice.asBoolean().value);
+        }
+        return std::hash<std::string>{}(choiceText(choice));
+    }
+}
+
+ChoiceSet::ChoiceSet()
+{
+    static const auto noChoices = std::make_shared<const Data>();
+    m_data = noChoices;
+}
+
+ChoiceSet
+ChoiceSet::intern(const List<Value>& choices)
+{
+    if (choices.value.empty())
+    {
+        return ChoiceSet{};
+    }
+
+    size_t hash = choices.value.size();
+    for (const auto& choice : choices.value)
+    {
+        hash = hash * 31 + hashChoice(choice);
+    }
+
+    // Sets found alive are released after the lock, in case one is the last
+    // holder and its deleter needs the lock too
+    std::vector<std::shared_ptr<const void>> candidates;
+    std::lock_guard lock(internMutex);
+
+    auto [first, last] = interned.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        auto candidate = std::static_pointer_cast<const Data>(it->second.second.lock());
+        if (candidate && candidate->choices == choices)
+        {
+            return ChoiceSet{std::move(candidate)};
+        }
+        candidates.push_back(std::move(candidate));
+    }
+
+    auto data = new Data{choices, {}, hash};
+    data->texts.reserve(choices.value.size());
+    for (const auto& choice : choices.value)
+    {
+        data->texts.push_back(choiceText(choice));
+    }
+
+    std::shared_ptr<const Data> shared{data, &ChoiceSet::release};
+    interned.emplace(hash, std::pair{data, std::weak_ptr<const void>{shared}});
+    return ChoiceSet{std::move(shared)};
+}
+
+void
+ChoiceSet::release(const Data* data)
+{
+    {
+        std::lock_guard lock(internMutex);
+        auto [first, last] = interned.equal_range(data->hash);
+        for (auto it = first; it != last; ++it)
+        {
+            if (it->second.first == data)
+            {
+                interned.erase(it);
+                break;
+            }
+        }
+    }
+    delete data;
+}
+
+size_t
+ChoiceSet::getInternedCount()
+{
+    std::lock_guard lock(internMutex);
+    return interned.size();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+
+
+/**
+ * An immutable list of choices, shared by every input request that offers
+ * it.
+ *
+ * Copying a ChoiceSet copies a reference, so a vote sent to many players
+ * holds one list between all their requests. intern() deduplicates by
+ * content: equal lists get the same set for as long as any request still
+ * holds it, and the set is freed with its last holder. The text a player
+ * sends to pick each choice is worked out once, when the set is made.
+ */
+class ChoiceSet
+{
+    public:
+        /// The set with no choices
+        ChoiceSet();
+
+        /// The shared set with these choices, made if there isn't one yet
+        static ChoiceSet intern(const List<Value>& choices);
+
+        const List<Value>& getChoices() const { return m_data->choices; }
+        const List<Value>& operator*() const { return m_data->choices; }
+        const List<Value>* operator->() const { return &m_data->choices; }
+
+        size_t size() const { return m_data->choices.value.size(); }
+        bool empty() const { return m_data->choices.value.empty(); }
+
+        /// What a player sends to pick each choice, in order: a String
+        /// choice as is, anything else as it prints
+        const std::vector<std::string>& getTexts() const { return m_data->texts; }
+        /// The same texts, held for as long as the caller keeps them
+        std::shared_ptr<const std::vector<std::string>> shareTexts() const { return {m_data, &m_data->texts}; }
+
+        /// Interned sets are equal exactly when they're the same set
+        bool operator==(const ChoiceSet& other) const { return m_data == other.m_data; }
+
+        /// Sets made by intern() that are still held, for tests
+        static size_t getInternedCount();
+
+    private:
+        struct Data
+        {
+            List<Value> choices;
+            std::vector<std::string> texts;
+            size_t hash = 0;
+        };
+
+        explicit ChoiceSet(std::shared_ptr<const Data> data) : m_data(std::move(data)) {}
+
+        static void release(const Data* data);
+
+    private:
+        std::shared_ptr<const Data> m_data;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+
+
+/**
+ * A value that copies share until one of them changes it.
+ *
+ * Copying costs the same however much the value holds, as a VariableMap's
+ * table does. Reads never copy; edit() first gives this copy a value of
+ * its own if another copy still shares it. A moved-from CopyOnWrite keeps
+ * sharing the value, so it never ends up empty.
+ */
+template <typename T>
+class CopyOnWrite
+{
+    public:
+        CopyOnWrite() : m_value(std::make_shared<T>()) {}
+        CopyOnWrite(const CopyOnWrite&) = default;
+        CopyOnWrite& operator=(const CopyOnWrite&) = default;
+
+        const T& operator*() const { return *m_value; }
+        const T* operator->() const { return m_value.get(); }
+
+        /// The value, to be changed
+        T& edit()
+        {
+            if (m_value.use_count() > 1)
+            {
+                m_value = std::make_shared<T>(*m_value);
+            }
+            return *m_value;
+        }
+
+    private:
+        std::shared_ptr<T> m_value;
+};
@@ -0,0 +1,61 @@
+#include <bit>
+
+#include "ExecutionTrace.h"
+
+
+ExecutionTrace::ExecutionTrace(size_t capacity)
+    : m_events(std::make_unique<Event[]>(std::bit_ceil(std::max<size_t>(capacity, 1))))
+    , m_mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1)
+{
+}
+
+std::vector<ExecutionTrace::Event>
+ExecutionTrace::getEvents() const
+{
+    uint64_t count = std::min<uint64_t>(m_recorded, getCapacity());
+
+    std::vector<Event> events;
+    events.reserve(count);
+    for (uint64_t i = m_recorded - count; i < m_recorded; ++i)
+    {
+        events.push_back(m_events[i & m_mask]);
+    }
+    return events;
+}
+
+void
+ExecutionTrace::dump(std::ostream& out) const
+{
+    std::vector<Event> events = getEvents();
+    out << "Last " << events.size() << " of " << m_recorded << " events:\n";
+
+    uint64_t number = m_recorded - events.size();
+    for (const Event& event : events)
+    {
+        out << "  #" << ++number << ' ';
+
+        auto player = event.getText().empty() ? std::string_view{"the group"} : event.getText();
+        switch (event.kind)
+        {
+            case Kind::STATEMENT:
+                out << "statement at " << event.location.line << ':' << event.location.column;
+                break;
+            case Kind::MATCH_ARM:
+                out << "match arm " << event.detail;
+                break;
+            case Kind::INPUT_REQUESTED:
+                out << "input requested from " << player;
+                break;
+            case Kind::INPUT_RECEIVED:
+                out << "input received from " << player;
+                break;
+            case Kind::VARIABLE_WRITTEN:
+                out << "wrote " << event.getText();
+                break;
+            case Kind::ATTRIBUTE_WRITTEN:
+                out << "wrote ." << event.getText();
+                break;
+        }
+        out << '\n';
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "Rules.h"
+
+
+/**
+ * A fixed-size ring of what an interpreter did last: statements entered,
+ * match arms taken, inputs requested and received, variables written.
+ *
+ * Recording copies one small Event into the next slot, overwriting the
+ * oldest once the ring is full. There's no locking and no allocation, so
+ * it's always on; dump() decodes the events only when they're wanted, e.g.
+ * after a runtime error. It has one writer and isn't synchronized, so read
+ * it from the thread running its interpreter.
+ */
+class ExecutionTrace
+{
+    public:
+        enum class Kind : uint8_t
+        {
+            STATEMENT,         // location is the statement's
+            MATCH_ARM,         // detail is the candidate's index
+            INPUT_REQUESTED,   // text is the player ID, empty for a group vote
+            INPUT_RECEIVED,    // likewise
+            VARIABLE_WRITTEN,  // text is the variable's name
+            ATTRIBUTE_WRITTEN, // text is the attribute's name
+        };
+
+        static constexpr size_t MAX_TEXT = 16;
+
+        struct Event
+        {
+            Kind kind = Kind::STATEMENT;
+            uint8_t textSize = 0;
+            uint32_t detail = 0;
+            ast::SourceLocation location;
+            char text[MAX_TEXT]; // truncated to MAX_TEXT, not null-terminated
+
+            std::string_view getText() const { return {text, textSize}; }
+        };
+        static_assert(sizeof(Event) == 32);
+
+        /// Keeps the last `capacity` events, rounded up to a power of two
+        explicit ExecutionTrace(size_t capacity = 256);
+
+        void
+        record(Kind kind, std::string_view text = {}, uint32_t detail = 0, ast::SourceLocation location = {})
+        {
+            Event& event = m_events[m_recorded++ & m_mask];
+            event.kind = kind;
+            event.textSize = static_cast<uint8_t>(std::min(text.size(), MAX_TEXT));
+            event.detail = detail;
+            event.location = location;
+            std::memcpy(event.text, text.data(), event.textSize);
+        }
+
+        /// The events still in the ring, oldest first
+        std::vector<Event> getEvents() const;
+
+        /// Events recorded since construction or clear(), including overwritten ones
+        uint64_t getRecordedCount() const { return m_recorded; }
+
+        size_t getCapacity() const { return m_mask + 1; }
+
+        void clear() { m_recorded = 0; }
+
+        /// Writes the events still in the ring, oldest first, one per line
+        void dump(std::ostream& out) const;
+
+    private:
+        std::unique_ptr<Event[]> m_events;
+        size_t m_mask;
+        uint64_t m_recorded = 0;
+};
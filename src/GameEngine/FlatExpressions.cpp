@@ -0,0 +1,228 @@
+#include <algorithm>
+
+#include "FlatExpressions.h"
+
+
+bool
+ast::FlatExpressions::canFlatten(ast::Expression* expr)
+{
+    if (!expr)
+    {
+        return false;
+    }
+    if (ast::castExpressionToConstant(expr) || ast::castExpressionToVariable(expr))
+    {
+        return true;
+    }
+    if (auto attribute = ast::castExpressionToAttribute(expr))
+    {
+        // Evaluated as a reference, like the interpreter requires
+        ast::Expression* base = attribute->getBase();
+        return (ast::castExpressionToVariable(base) || ast::castExpressionToAttribute(base)) && canFlatten(base);
+    }
+    if (auto comparison = dynamic_cast<ast::Comparison*>(expr))
+    {
+        return canFlatten(comparison->getLeft()) && canFlatten(comparison->getRight());
+    }
+    if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+    {
+        return canFlatten(logicalOp->getLeft()) && canFlatten(logicalOp->getRight());
+    }
+    if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+    {
+        return canFlatten(arithmeticOp->getLeft()) && canFlatten(arithmeticOp->getRight());
+    }
+    if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+    {
+        return canFlatten(unaryOp->getTarget());
+    }
+    if (auto callable = dynamic_cast<ast::Callable*>(expr))
+    {
+        if (callable->getArgCount() != ast::builtinArity(callable->getKind()))
+        {
+            return false;
+        }
+        return std::ranges::all_of(callable->getArgs(), canFlatten) && canFlatten(callable->getLeft());
+    }
+    return false;
+}
+
+uint32_t
+ast::FlatExpressions::add(ast::Expression* expr)
+{
+    if (!canFlatten(expr))
+    {
+        return FlatNode::NONE;
+    }
+    return append(expr);
+}
+
+uint32_t
+ast::FlatExpressions::append(ast::Expression* expr)
+{
+    // Parents come before their children, so walking down moves forward
+    auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    expr->setFlatIndex(index);
+
+    FlatNode node;
+    node.staticType = expr->getStaticType();
+
+    if (auto constant = ast::castExpressionToConstant(expr))
+    {
+        node.kind = NodeKind::CONSTANT;
+        node.operand = static_cast<uint32_t>(m_constants.size());
+        m_constants.push_back(constant->getValue());
+    }
+    else if (auto variable = ast::castExpressionToVariable(expr))
+    {
+        node.kind = NodeKind::VARIABLE;
+        node.operand = static_cast<uint32_t>(m_names.size());
+        m_names.push_back(variable->getName());
+    }
+    else if (auto attribute = ast::castExpressionToAttribute(expr))
+    {
+        node.kind = NodeKind::ATTRIBUTE;
+        node.operand = static_cast<uint32_t>(m_attributes.size());
+        m_attributes.push_back(attribute->getAttr());
+        node.left = append(attribute->getBase());
+    }
+    else if (auto comparison = dynamic_cast<ast::Comparison*>(expr))
+    {
+        node.kind = NodeKind::COMPARISON;
+        node.op = static_cast<uint8_t>(comparison->getKind());
+        node.left = append(comparison->getLeft());
+        node.right = append(comparison->getRight());
+    }
+    else if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+    {
+        node.kind = NodeKind::LOGICAL_OPERATION;
+        node.op = static_cast<uint8_t>(logicalOp->getKind());
+        node.left = append(logicalOp->getLeft());
+        node.right = append(logicalOp->getRight());
+    }
+    else if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+    {
+        node.kind = NodeKind::ARITHMETIC_OPERATION;
+        node.op = static_cast<uint8_t>(arithmeticOp->getKind());
+        node.left = append(arithmeticOp->getLeft());
+        node.right = append(arithmeticOp->getRight());
+    }
+    else if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+    {
+        node.kind = NodeKind::UNARY_OPERATION;
+        node.op = static_cast<uint8_t>(unaryOp->getKind());
+        node.left = append(unaryOp->getTarget());
+    }
+    else if (auto callable = dynamic_cast<ast::Callable*>(expr))
+    {
+        node.kind = NodeKind::CALLABLE;
+        node.op = static_cast<uint8_t>(callable->getKind());
+        node.left = append(callable->getLeft());
+
+        // Reserve the slots first, since the arguments may be callables too
+        node.operand = static_cast<uint32_t>(m_arguments.size());
+        m_arguments.resize(m_arguments.size() + callable->getArgCount());
+        for (size_t i = 0; i < callable->getArgCount(); ++i)
+        {
+            m_arguments[node.operand + i] = append(callable->getArg(i));
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+namespace
+{
+    void
+    flattenStatements(ast::FlatExpressions& flat, std::span<ast::Statement* const> statements)
+    {
+        for (ast::Statement* statement : statements)
+        {
+            if (auto assignment = dynamic_cast<ast::Assignment*>(statement))
+            {
+                flat.add(assignment->getTarget());
+                flat.add(assignment->getValue());
+            }
+            else if (auto extend = dynamic_cast<ast::Extend*>(statement))
+            {
+                flat.add(extend->getTarget());
+                flat.add(extend->getValue());
+            }
+            else if (auto reverse = dynamic_cast<ast::Reverse*>(statement))
+            {
+                flat.add(reverse->getTarget());
+            }
+            else if (auto shuffle = dynamic_cast<ast::Shuffle*>(statement))
+            {
+                flat.add(shuffle->getTarget());
+            }
+            else if (auto discard = dynamic_cast<ast::Discard*>(statement))
+            {
+                flat.add(discard->getTarget());
+                flat.add(discard->getAmount());
+            }
+            else if (auto sort = dynamic_cast<ast::Sort*>(statement))
+            {
+                flat.add(sort->getTarget());
+            }
+            else if (auto match = ast::castStatementToMatch(statement))
+            {
+                flat.add(match->getTarget());
+                for (const auto& candidate : match->getCandidates())
+                {
+                    flat.add(candidate.expressionCandidate);
+                    flattenStatements(flat, candidate.statements);
+                }
+            }
+            else if (auto forLoop = ast::castStatementToForLoop(statement))
+            {
+                flat.add(forLoop->getTarget());
+                flattenStatements(flat, forLoop->getStatements());
+            }
+            else if (auto parallelFor = ast::castStatementToParallelFor(statement))
+            {
+                flat.add(parallelFor->getTarget());
+                flattenStatements(flat, parallelFor->getStatements());
+            }
+            else if (auto inputChoice = dynamic_cast<ast::InputChoice*>(statement))
+            {
+                flat.add(inputChoice->getChoices());
+            }
+            else if (auto inputRange = dynamic_cast<ast::InputRange*>(statement))
+            {
+                flat.add(inputRange->getMinValue());
+                flat.add(inputRange->getMaxValue());
+            }
+            else if (auto inputVote = dynamic_cast<ast::InputVote*>(statement))
+            {
+                flat.add(inputVote->getPlayer());
+                flat.add(inputVote->getChoices());
+            }
+            else if (auto message = ast::castStatementToMessage(statement))
+            {
+                if (message->getPlayers())
+                {
+                    flat.add(message->getPlayers());
+                }
+                for (const auto& segment : message->getSegments())
+                {
+                    if (segment.expression)
+                    {
+                        flat.add(segment.expression.get());
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+ast::FlatExpressions
+ast::flattenExpressions(std::span<ast::Statement* const> statements)
+{
+    FlatExpressions flat;
+    flattenStatements(flat, statements);
+    return flat;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Rules.h"
+
+
+namespace ast
+{
+    /// One expression node, with children referenced by index
+    struct FlatNode
+    {
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        NodeKind kind = NodeKind::CONSTANT;
+        uint8_t op = 0; // the node's own Kind (e.g. Comparison::Kind), if it has one
+        ValueType staticType = ValueType::UNKNOWN;
+        uint32_t left = NONE;    // first operand, attribute base or callable's target
+        uint32_t right = NONE;   // second operand
+        uint32_t operand = NONE; // index into the constant, name or attribute pool,
+                                 // or a callable's first entry in the argument pool
+    };
+
+    /**
+     * @brief A program's expressions, stored contiguously.
+     *
+     * The tree of Expression nodes is convenient to build but each node is
+     * its own allocation reached through a virtual call. This keeps a copy of
+     * every expression in one array, children by 32-bit index, so evaluating
+     * one walks adjacent memory and dispatches on FlatNode::kind. Each
+     * flattened Expression records its index with setFlatIndex().
+     *
+     * Only well-formed trees of operators, constants, variables, attributes
+     * and builtins are flattened; anything else stays tree-only.
+     */
+    class FlatExpressions
+    {
+        public:
+            /// Flattens `expr` and its children. Returns its index, or
+            /// FlatNode::NONE (storing nothing) if it can't be flattened.
+            uint32_t add(Expression* expr);
+
+            const FlatNode& getNode(uint32_t index) const { return m_nodes[index]; }
+            const Value& getConstant(uint32_t index) const { return m_constants[index]; }
+            const Name& getName(uint32_t index) const { return m_names[index]; }
+            const String& getAttribute(uint32_t index) const { return m_attributes[index]; }
+            uint32_t getArgument(uint32_t index) const { return m_arguments[index]; }
+
+            size_t size() const { return m_nodes.size(); }
+
+        private:
+            static bool canFlatten(Expression* expr);
+            uint32_t append(Expression* expr);
+
+        private:
+            std::vector<FlatNode> m_nodes;
+            std::vector<Value> m_constants;
+            std::vector<Name> m_names;
+            std::vector<String> m_attributes;
+            std::vector<uint32_t> m_arguments; // node indices of callables' arguments
+    };
+
+    /**
+     * @brief Flattens every expression in a program, see FlatExpressions.
+     *
+     * Run after inferTypes(), since the static types are copied. The
+     * statements are annotated in place and must outlive the result.
+     */
+    FlatExpressions
+    flattenExpressions(std::span<Statement* const> statements);
+}
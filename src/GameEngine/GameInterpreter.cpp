@@ -2,6 +2,15 @@
 #include <vector>
 #include <variant>
 #include <optional>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <charconv>
+#include <iterator>
+#include <sstream>
+#include <array>
+#include <string_view>
+#include <unordered_set>
 
 #include "GameInterpreter.h"
 
@@ -9,12 +18,14 @@
 VisitResult
 GameInterpreter::visit(const ast::ASTNode& node)
 {
-    throw std::runtime_error("Invalid node during evaluation");
+    return VisitResult::fail("Invalid node during evaluation");
 }
 
 VisitResult
 GameInterpreter::visit(const ast::Constant& constant)
 {
+    auto profile = profileNode(ast::NodeKind::CONSTANT);
+
     Value value = constant.getValue();
     return VisitResult{value};
 }
@@ -22,44 +33,96 @@ GameInterpreter::visit(const ast::Constant& constant)
 VisitResult
 GameInterpreter::visit(const ast::Variable& variable)
 {
-    Value* value = m_variableMap.load(variable.getName());
-    return VisitResult{value};
+    auto profile = profileNode(ast::NodeKind::VARIABLE);
+
+    return lookupVariable(variable.getName());
 }
 
 VisitResult
 GameInterpreter::visit(const ast::Attribute& attribute)
 {
+    auto profile = profileNode(ast::NodeKind::ATTRIBUTE);
+
     auto baseExpr = attribute.getBase();
-    if (!baseExpr)
+    if (!m_verified)
     {
-        throw std::runtime_error("Attribute base cannot be null");
+        if (!baseExpr)
+        {
+            return VisitResult::fail("Attribute base cannot be null");
+        }
+
+        if(!castExpressionToVariable(baseExpr)
+           && !castExpressionToAttribute(baseExpr))
+        {
+            return VisitResult::fail("Attribute base must be a Variable or Attribute");
+        }
     }
 
-    if(!castExpressionToVariable(baseExpr)
-       && !castExpressionToAttribute(baseExpr))
+    VisitResult baseResult = referenceExpression(*baseExpr);
+    if (baseResult.hasError())
     {
-        throw std::runtime_error("Attribute base must be a Variable or Attribute");
+        return baseResult;
     }
 
-    VisitResult baseResult = resolveExpression(*baseExpr);
-    Value& baseValue = baseResult.getValue();
-    Value& attrValue = baseValue.getAttribute(attribute.getAttr());
-
-    return VisitResult{&attrValue};
+    auto attrValue = baseResult.getValue().findAttribute(attribute.getAttr());
+    if (!attrValue)
+    {
+        return VisitResult::fail(std::move(attrValue.error()));
+    }
+    return VisitResult{*attrValue};
 }
 
 VisitResult
 GameInterpreter::visit(const ast::Comparison& comparison)
 {
-    Value left = evaluateExpression(*comparison.getLeft()).getValue();
-    Value right = evaluateExpression(*comparison.getRight()).getValue();
+    auto profile = profileNode(ast::NodeKind::COMPARISON);
+
+    VisitResult leftResult = evaluateExpression(*comparison.getLeft());
+    if (leftResult.hasError())
+    {
+        return leftResult;
+    }
+    VisitResult rightResult = evaluateExpression(*comparison.getRight());
+    if (rightResult.hasError())
+    {
+        return rightResult;
+    }
+
+    bool integers = comparison.getLeft()->getStaticType() == ValueType::INTEGER
+                    && comparison.getRight()->getStaticType() == ValueType::INTEGER;
+    return applyComparison(comparison.getKind(), leftResult.getValue(), rightResult.getValue(), integers);
+}
+
+VisitResult
+GameInterpreter::applyComparison(ast::Comparison::Kind kind, const Value& left, const Value& right, bool integers)
+{
+    if (integers)
+    {
+        int leftInt = left.asUnchecked<Integer>().value;
+        int rightInt = right.asUnchecked<Integer>().value;
+
+        switch (kind)
+        {
+            case ast::Comparison::Kind::EQ: return VisitResult{Value{Boolean{leftInt == rightInt}}};
+            case ast::Comparison::Kind::LT: return VisitResult{Value{Boolean{leftInt < rightInt}}};
+        }
+    }
 
     Boolean boolResult;
 
-    switch (comparison.getKind())
+    switch (kind)
     {
         case ast::Comparison::Kind::EQ: boolResult = isEqual(left, right); break;
-        case ast::Comparison::Kind::LT: boolResult = isLessThan(left, right); break;
+        case ast::Comparison::Kind::LT:
+        {
+            auto isLess = isLessThan(left, right);
+            if (!isLess)
+            {
+                return VisitResult::fail(std::move(isLess.error()));
+            }
+            boolResult = *isLess;
+            break;
+        }
     }
 
     return VisitResult{Value{boolResult}};
@@ -68,103 +131,527 @@ GameInterpreter::visit(const ast::Comparison& comparison)
 VisitResult
 GameInterpreter::visit(const ast::LogicalOperation& logicalOp)
 {
-    Value left = evaluateExpression(*logicalOp.getLeft()).getValue();
-    Value right = evaluateExpression(*logicalOp.getRight()).getValue();
+    auto profile = profileNode(ast::NodeKind::LOGICAL_OPERATION);
 
-    Boolean boolResult;
+    VisitResult leftResult = evaluateExpression(*logicalOp.getLeft());
+    if (leftResult.hasError())
+    {
+        return leftResult;
+    }
+    VisitResult rightResult = evaluateExpression(*logicalOp.getRight());
+    if (rightResult.hasError())
+    {
+        return rightResult;
+    }
+
+    bool booleans = logicalOp.getLeft()->getStaticType() == ValueType::BOOLEAN
+                    && logicalOp.getRight()->getStaticType() == ValueType::BOOLEAN;
+    return applyLogicalOperation(logicalOp.getKind(), leftResult.getValue(), rightResult.getValue(), booleans);
+}
+
+VisitResult
+GameInterpreter::applyLogicalOperation(ast::LogicalOperation::Kind kind, const Value& left, const Value& right, bool booleans)
+{
+    if (booleans)
+    {
+        bool leftBool = left.asUnchecked<Boolean>().value;
+        bool rightBool = right.asUnchecked<Boolean>().value;
+
+        switch (kind)
+        {
+            case ast::LogicalOperation::Kind::OR: return VisitResult{Value{Boolean{leftBool || rightBool}}};
+        }
+    }
+
+    Result<bool> boolResult;
 
-    switch (logicalOp.getKind())
+    switch (kind)
     {
-        case ast::LogicalOperation::Kind::OR: boolResult = Boolean{doLogicalOr(left, right)}; break;
+        case ast::LogicalOperation::Kind::OR: boolResult = tryLogicalOr(left, right); break;
     }
 
-    return VisitResult{Value{boolResult}};
+    if (!boolResult)
+    {
+        return VisitResult::fail(std::move(boolResult.error()));
+    }
+    return VisitResult{Value{Boolean{*boolResult}}};
 }
 
 VisitResult
 GameInterpreter::visit(const ast::UnaryOperation& unaryOp)
 {
-    Value target = evaluateExpression(*unaryOp.getTarget()).getValue();
+    auto profile = profileNode(ast::NodeKind::UNARY_OPERATION);
 
-    Boolean boolResult;
+    VisitResult targetResult = evaluateExpression(*unaryOp.getTarget());
+    if (targetResult.hasError())
+    {
+        return targetResult;
+    }
+
+    bool boolean = unaryOp.getTarget()->getStaticType() == ValueType::BOOLEAN;
+    return applyUnaryOperation(unaryOp.getKind(), targetResult.getValue(), boolean);
+}
+
+VisitResult
+GameInterpreter::applyUnaryOperation(ast::UnaryOperation::Kind kind, const Value& target, bool boolean)
+{
+    if (boolean)
+    {
+        bool targetBool = target.asUnchecked<Boolean>().value;
+
+        switch (kind)
+        {
+            case ast::UnaryOperation::Kind::NOT: return VisitResult{Value{Boolean{!targetBool}}};
+        }
+    }
 
-    switch (unaryOp.getKind())
+    Result<bool> boolResult;
+
+    switch (kind)
     {
-        case ast::UnaryOperation::Kind::NOT: boolResult = Boolean{doUnaryNot(target)}; break;
+        case ast::UnaryOperation::Kind::NOT: boolResult = tryUnaryNot(target); break;
     }
 
-    return VisitResult{Value{boolResult}};
+    if (!boolResult)
+    {
+        return VisitResult::fail(std::move(boolResult.error()));
+    }
+    return VisitResult{Value{Boolean{*boolResult}}};
 }
 
 VisitResult
 GameInterpreter::visit(const ast::ArithmeticOperation& arithmeticOp)
 {
-    Value left = evaluateExpression(*arithmeticOp.getLeft()).getValue();
-    Value right = evaluateExpression(*arithmeticOp.getRight()).getValue();
+    auto profile = profileNode(ast::NodeKind::ARITHMETIC_OPERATION);
+
+    VisitResult leftResult = evaluateExpression(*arithmeticOp.getLeft());
+    if (leftResult.hasError())
+    {
+        return leftResult;
+    }
+    VisitResult rightResult = evaluateExpression(*arithmeticOp.getRight());
+    if (rightResult.hasError())
+    {
+        return rightResult;
+    }
+
+    bool integers = arithmeticOp.getLeft()->getStaticType() == ValueType::INTEGER
+                    && arithmeticOp.getRight()->getStaticType() == ValueType::INTEGER;
+    return applyArithmeticOperation(arithmeticOp.getKind(), leftResult.getValue(), rightResult.getValue(), integers);
+}
+
+VisitResult
+GameInterpreter::applyArithmeticOperation(ast::ArithmeticOperation::Kind kind, const Value& left, const Value& right, bool integers)
+{
+    if (integers)
+    {
+        int leftInt = left.asUnchecked<Integer>().value;
+        int rightInt = right.asUnchecked<Integer>().value;
+
+        switch (kind)
+        {
+            case ast::ArithmeticOperation::Kind::ADD: return VisitResult{Value{Integer{leftInt + rightInt}}};
+        }
+    }
 
-    Value result;
+    Result<Value> result;
 
-    switch (arithmeticOp.getKind())
+    switch (kind)
     {
-        case ast::ArithmeticOperation::Kind::ADD: result = doArithmeticAdd(left, right); break;
+        case ast::ArithmeticOperation::Kind::ADD: result = tryArithmeticAdd(left, right); break;
     }
 
-    return VisitResult{result};
+    if (!result)
+    {
+        return VisitResult::fail(std::move(result.error()));
+    }
+    return VisitResult{std::move(*result)};
 }
 
 VisitResult
 GameInterpreter::visit(const ast::Callable& callable)
 {
-    Value result;
+    auto profile = profileNode(ast::NodeKind::CALLABLE);
+
+    size_t arity = ast::builtinArity(callable.getKind());
+    if (!m_verified && callable.getArgCount() != arity)
+    {
+        return VisitResult::fail(std::format(
+            "{}() expects {} arg(s), got {}",
+            ast::builtinName(callable.getKind()), arity, callable.getArgCount()
+        ));
+    }
+
+    // Arguments first, then the target, e.g. upfrom's lower bound
+    std::array<VisitResult, 2> argResults;
+    std::array<const Value*, 2> args{};
+    for (size_t i = 0; i < arity; ++i)
+    {
+        argResults[i] = evaluateExpression(*callable.getArg(i));
+        if (argResults[i].hasError())
+        {
+            return std::move(argResults[i]);
+        }
+        args[i] = &argResults[i].getValue();
+    }
 
-    switch (callable.getKind())
+    VisitResult targetResult = evaluateExpression(*callable.getLeft());
+    if (targetResult.hasError())
     {
-        case ast::Callable::Kind::SIZE: result = callSizeBuiltin(callable); break;
-        case ast::Callable::Kind::UP_FROM: result = callUpFromBuiltin(callable); break;
-        default: throw std::runtime_error("Unknown callable kind");
+        return targetResult;
     }
 
-    return VisitResult{result};
+    return applyBuiltin(
+        callable.getKind(), targetResult.getValue(), callable.getLeft()->getStaticType(),
+        std::span<const Value* const>{args.data(), arity}
+    );
 }
 
-Value
-GameInterpreter::callSizeBuiltin(const ast::Callable& callable)
+VisitResult
+GameInterpreter::applySize(const Value& list, bool isList)
 {
-    auto args = callable.getArgs();
+    if (isList)
+    {
+        return VisitResult{Value{Integer{static_cast<int>(list.asUnchecked<List<Value>>().value.size())}}};
+    }
 
-    if (args.size() != 0)
+    auto checkedList = list.tryAs<List<Value>>();
+    if (!checkedList)
     {
-        throw std::runtime_error(
-            std::format("size() expects 0 args, got {}", args.size())
-        );
+        return VisitResult::fail(std::move(checkedList.error()));
+    }
+    return VisitResult{Value{Integer{static_cast<int>((*checkedList)->value.size())}}};
+}
+
+VisitResult
+GameInterpreter::applyUpFrom(const Value& from, const Value& to)
+{
+    auto fromParam = from.tryAs<Integer>();
+    if (!fromParam)
+    {
+        return VisitResult::fail(std::move(fromParam.error()));
+    }
+    auto toParam = to.tryAs<Integer>();
+    if (!toParam)
+    {
+        return VisitResult::fail(std::move(toParam.error()));
+    }
+
+    auto list = tryUpFrom((*fromParam)->value, (*toParam)->value);
+    if (!list)
+    {
+        return VisitResult::fail(std::move(list.error()));
     }
+    return VisitResult{Value{std::move(*list)}};
+}
 
-    List<Value> list = evaluateExpression(*callable.getLeft()).getValue().asList();
+namespace
+{
+    // Keeps the first of each value, in order. Strings, integers and
+    // booleans are hashed; anything else falls back to a linear search.
+    List<Value>
+    uniqueValues(const std::vector<Value>& values)
+    {
+        List<Value> unique;
+        std::unordered_set<std::string_view> strings;
+        std::unordered_set<int> integers;
+        std::array<bool, 2> booleans{};
 
-    return Value{Integer{static_cast<int>(list.size())}};
+        for (const Value& value : values)
+        {
+            bool isNew = false;
+            if (value.isString())
+            {
+                isNew = strings.insert(value.asString().value).second;
+            }
+            else if (value.isInteger())
+            {
+                isNew = integers.insert(value.asInteger().value).second;
+            }
+            else if (value.isBoolean())
+            {
+                isNew = !std::exchange(booleans[value.asBoolean().value], true);
+            }
+            else
+            {
+                isNew = std::ranges::find(unique.value, value) == unique.value.end();
+            }
+
+            if (isNew)
+            {
+                unique.value.push_back(value);
+            }
+        }
+        return unique;
+    }
 }
 
-Value
-GameInterpreter::callUpFromBuiltin(const ast::Callable& callable)
+VisitResult
+GameInterpreter::applyBuiltin(ast::Callable::Kind kind, const Value& target, ValueType targetType,
+                              std::span<const Value* const> args)
 {
-    auto args = callable.getArgs();
+    switch (kind)
+    {
+        case ast::Callable::Kind::SIZE: return applySize(target, targetType == ValueType::LIST);
+        case ast::Callable::Kind::UP_FROM: return applyUpFrom(*args[0], target);
+        default: break;
+    }
 
-    if (callable.getArgs().size() != 1)
+    // The rest query a list, in one pass and without copying it
+    const List<Value>* list = nullptr;
+    if (targetType == ValueType::LIST)
     {
-        throw std::runtime_error(
-            std::format("upfrom() expects 1 arg, got {}", args.size())
-        );
+        list = &target.asUnchecked<List<Value>>();
+    }
+    else
+    {
+        auto checkedList = target.tryAs<List<Value>>();
+        if (!checkedList)
+        {
+            return VisitResult::fail(std::move(checkedList.error()));
+        }
+        list = *checkedList;
+    }
+    const std::vector<Value>& elements = list->value;
+
+    if (kind == ast::Callable::Kind::CONTAINS)
+    {
+        return VisitResult{Value{Boolean{std::ranges::find(elements, *args[0]) != elements.end()}}};
+    }
+    if (kind == ast::Callable::Kind::UNIQUE)
+    {
+        return VisitResult{Value{uniqueValues(elements)}};
+    }
+
+    // The rest look at one attribute of each element
+    auto attrName = args[0]->tryAs<String>();
+    if (!attrName)
+    {
+        return VisitResult::fail(std::move(attrName.error()));
+    }
+    const String& attr = **attrName;
+
+    switch (kind)
+    {
+        case ast::Callable::Kind::COLLECT:
+        {
+            List<Value> collected;
+            collected.value.reserve(elements.size());
+            for (const Value& element : elements)
+            {
+                auto attrValue = element.findAttribute(attr);
+                if (!attrValue)
+                {
+                    return VisitResult::fail(std::move(attrValue.error()));
+                }
+                collected.value.push_back(**attrValue);
+            }
+            return VisitResult{Value{std::move(collected)}};
+        }
+
+        case ast::Callable::Kind::FILTER:
+        case ast::Callable::Kind::COUNT:
+        {
+            List<Value> matches;
+            int count = 0;
+            for (const Value& element : elements)
+            {
+                auto attrValue = element.findAttribute(attr);
+                if (!attrValue)
+                {
+                    return VisitResult::fail(std::move(attrValue.error()));
+                }
+                if (**attrValue == *args[1])
+                {
+                    ++count;
+                    if (kind == ast::Callable::Kind::FILTER)
+                    {
+                        matches.value.push_back(element);
+                    }
+                }
+            }
+            if (kind == ast::Callable::Kind::COUNT)
+            {
+                return VisitResult{Value{Integer{count}}};
+            }
+            return VisitResult{Value{std::move(matches)}};
+        }
+
+        case ast::Callable::Kind::MAX_BY:
+        case ast::Callable::Kind::MIN_BY:
+        {
+            if (elements.empty())
+            {
+                return VisitResult::fail(std::format("{}() of an empty list", ast::builtinName(kind)));
+            }
+
+            // The first of equal elements wins
+            const Value* best = nullptr;
+            const Value* bestKey = nullptr;
+            for (const Value& element : elements)
+            {
+                auto attrValue = element.findAttribute(attr);
+                if (!attrValue)
+                {
+                    return VisitResult::fail(std::move(attrValue.error()));
+                }
+                if (!best)
+                {
+                    best = &element;
+                    bestKey = *attrValue;
+                    continue;
+                }
+
+                auto better = kind == ast::Callable::Kind::MAX_BY
+                    ? maybeCompareValues(*bestKey, **attrValue)
+                    : maybeCompareValues(**attrValue, *bestKey);
+                if (!better)
+                {
+                    return VisitResult::fail("Values are not less-than comparable");
+                }
+                if (*better)
+                {
+                    best = &element;
+                    bestKey = *attrValue;
+                }
+            }
+            return VisitResult{*best};
+        }
+
+        default:
+            break;
+    }
+    return VisitResult::fail("Unknown callable kind");
+}
+
+VisitResult
+GameInterpreter::evaluateFlat(const ast::FlatExpressions& flat, uint32_t index)
+{
+    // Mirrors the visit() overloads above, reading operands by index
+    const ast::FlatNode& node = flat.getNode(index);
+    auto profile = profileNode(node.kind);
+
+    switch (node.kind)
+    {
+        case ast::NodeKind::CONSTANT:
+            return VisitResult{flat.getConstant(node.operand)};
+
+        case ast::NodeKind::VARIABLE:
+        {
+            return lookupVariable(flat.getName(node.operand));
+        }
+
+        case ast::NodeKind::ATTRIBUTE:
+        {
+            // The base is a Variable or Attribute, so this is a reference
+            VisitResult baseResult = evaluateFlat(flat, node.left);
+            if (baseResult.hasError())
+            {
+                return baseResult;
+            }
+            auto attrValue = baseResult.getValue().findAttribute(flat.getAttribute(node.operand));
+            if (!attrValue)
+            {
+                return VisitResult::fail(std::move(attrValue.error()));
+            }
+            return VisitResult{*attrValue};
+        }
+
+        case ast::NodeKind::UNARY_OPERATION:
+        {
+            VisitResult targetResult = evaluateFlat(flat, node.left);
+            if (targetResult.hasError())
+            {
+                return targetResult;
+            }
+            return applyUnaryOperation(
+                static_cast<ast::UnaryOperation::Kind>(node.op),
+                targetResult.getValue(),
+                flat.getNode(node.left).staticType == ValueType::BOOLEAN
+            );
+        }
+
+        case ast::NodeKind::CALLABLE:
+        {
+            auto kind = static_cast<ast::Callable::Kind>(node.op);
+            size_t arity = ast::builtinArity(kind);
+
+            std::array<VisitResult, 2> argResults;
+            std::array<const Value*, 2> args{};
+            for (size_t i = 0; i < arity; ++i)
+            {
+                argResults[i] = evaluateFlat(flat, flat.getArgument(node.operand + i));
+                if (argResults[i].hasError())
+                {
+                    return std::move(argResults[i]);
+                }
+                args[i] = &argResults[i].getValue();
+            }
+
+            VisitResult targetResult = evaluateFlat(flat, node.left);
+            if (targetResult.hasError())
+            {
+                return targetResult;
+            }
+            return applyBuiltin(
+                kind, targetResult.getValue(), flat.getNode(node.left).staticType,
+                std::span<const Value* const>{args.data(), arity}
+            );
+        }
+
+        default:
+            break;
+    }
+
+    // The rest are binary operators
+    VisitResult leftResult = evaluateFlat(flat, node.left);
+    if (leftResult.hasError())
+    {
+        return leftResult;
+    }
+    VisitResult rightResult = evaluateFlat(flat, node.right);
+    if (rightResult.hasError())
+    {
+        return rightResult;
     }
-    Integer fromParam = evaluateExpression(*args[0]).getValue().asInteger();
-    Integer toParam = evaluateExpression(*callable.getLeft()).getValue().asInteger();
+    const Value& left = leftResult.getValue();
+    const Value& right = rightResult.getValue();
+    ValueType leftType = flat.getNode(node.left).staticType;
+    ValueType rightType = flat.getNode(node.right).staticType;
 
-    return Value{upFrom(fromParam.value, toParam.value)};
+    switch (node.kind)
+    {
+        case ast::NodeKind::COMPARISON:
+            return applyComparison(
+                static_cast<ast::Comparison::Kind>(node.op), left, right,
+                leftType == ValueType::INTEGER && rightType == ValueType::INTEGER
+            );
+        case ast::NodeKind::LOGICAL_OPERATION:
+            return applyLogicalOperation(
+                static_cast<ast::LogicalOperation::Kind>(node.op), left, right,
+                leftType == ValueType::BOOLEAN && rightType == ValueType::BOOLEAN
+            );
+        case ast::NodeKind::ARITHMETIC_OPERATION:
+            return applyArithmeticOperation(
+                static_cast<ast::ArithmeticOperation::Kind>(node.op), left, right,
+                leftType == ValueType::INTEGER && rightType == ValueType::INTEGER
+            );
+        default:
+            return VisitResult::fail("Invalid node during evaluation");
+    }
 }
 
 VisitResult
 GameInterpreter::visit(const ast::Assignment& assignment)
 {
-    Value valueToAssign = assignment.getValue()->accept(*this).getValue();
+    auto profile = profileNode(ast::NodeKind::ASSIGNMENT);
+
+    VisitResult valueResult = evaluateExpression(*assignment.getValue());
+    if (valueResult.hasError())
+    {
+        return valueResult;
+    }
+    Value valueToAssign = valueResult.getValue();
     auto targetExpr = assignment.getTarget();
 
     if (auto varTarget = castExpressionToVariable(targetExpr))
@@ -173,11 +660,11 @@ GameInterpreter::visit(const ast::Assignment& assignment)
     }
     else if (auto attrTarget = castExpressionToAttribute(targetExpr))
     {
-        doAttributeAssignment(*attrTarget, valueToAssign);
+        return doAttributeAssignment(*attrTarget, valueToAssign);
     }
     else
     {
-        throw std::runtime_error("Assignment target must be a Variable or an Attribute");
+        return VisitResult::fail("Assignment target must be a Variable or an Attribute");
     }
     return {};
 }
@@ -185,13 +672,33 @@ GameInterpreter::visit(const ast::Assignment& assignment)
 VisitResult
 GameInterpreter::visit(const ast::Extend& extend)
 {
-    VisitResult targetResult = resolveExpression(*extend.getTarget());
-    Value& target = targetResult.getValue();
+    auto profile = profileNode(ast::NodeKind::EXTEND);
+
+    auto target = resolveList(*extend.getTarget());
+    if (!target)
+    {
+        return VisitResult::fail(std::move(target.error()));
+    }
 
     VisitResult valueResult = evaluateExpression(*extend.getValue());
-    Value value = valueResult.getValue();
+    if (valueResult.hasError())
+    {
+        return valueResult;
+    }
+    auto value = valueResult.getValue().tryAs<List<Value>>();
+    if (!value)
+    {
+        return VisitResult::fail(std::move(value.error()));
+    }
 
-    target.asList().extend(value.asList());
+    (*target)->extend(**value);
+    if (auto variable = castExpressionToVariable(extend.getTarget()))
+    {
+        for (Leaderboard& board : m_leaderboards.edit())
+        {
+            board.add(variable->getName(), **value);
+        }
+    }
 
     return {};
 }
@@ -199,10 +706,15 @@ GameInterpreter::visit(const ast::Extend& extend)
 VisitResult
 GameInterpreter::visit(const ast::Reverse& reverse)
 {
-    VisitResult targetResult = resolveExpression(*reverse.getTarget());
-    Value& target = targetResult.getValue();
+    auto profile = profileNode(ast::NodeKind::REVERSE);
+
+    auto target = resolveList(*reverse.getTarget());
+    if (!target)
+    {
+        return VisitResult::fail(std::move(target.error()));
+    }
 
-    target.asList().reverse();
+    (*target)->reverse();
 
     return {};
 }
@@ -210,10 +722,15 @@ GameInterpreter::visit(const ast::Reverse& reverse)
 VisitResult
 GameInterpreter::visit(const ast::Shuffle& shuffle)
 {
-    VisitResult targetResult = resolveExpression(*shuffle.getTarget());
-    Value& target = targetResult.getValue();
+    auto profile = profileNode(ast::NodeKind::SHUFFLE);
 
-    target.asList().shuffle();
+    auto target = resolveList(*shuffle.getTarget());
+    if (!target)
+    {
+        return VisitResult::fail(std::move(target.error()));
+    }
+
+    (*target)->shuffle();
 
     return {};
 }
@@ -221,13 +738,33 @@ GameInterpreter::visit(const ast::Shuffle& shuffle)
 VisitResult
 GameInterpreter::visit(const ast::Discard& discard)
 {
-    VisitResult targetResult = resolveExpression(*discard.getTarget());
-    Value& target = targetResult.getValue();
+    auto profile = profileNode(ast::NodeKind::DISCARD);
+
+    auto target = resolveList(*discard.getTarget());
+    if (!target)
+    {
+        return VisitResult::fail(std::move(target.error()));
+    }
 
     VisitResult amountResult = evaluateExpression(*discard.getAmount());
-    Value amount = amountResult.getValue();
+    if (amountResult.hasError())
+    {
+        return amountResult;
+    }
+    auto amount = amountResult.getValue().tryAs<Integer>();
+    if (!amount)
+    {
+        return VisitResult::fail(std::move(amount.error()));
+    }
 
-    target.asList().discard(amount.asInteger());
+    (*target)->discard(**amount);
+    if (auto variable = castExpressionToVariable(discard.getTarget()))
+    {
+        if (const Value* held = findVariable(variable->getName()); held && !m_leaderboards->empty())
+        {
+            trackScores(variable->getName(), *held);
+        }
+    }
 
     return {};
 }
@@ -235,12 +772,21 @@ GameInterpreter::visit(const ast::Discard& discard)
 VisitResult
 GameInterpreter::visit(const ast::Sort& sort)
 {
-    VisitResult targetResult = resolveExpression(*sort.getTarget());
-    Value& target = targetResult.getValue();
+    auto profile = profileNode(ast::NodeKind::SORT);
+
+    auto target = resolveList(*sort.getTarget());
+    if (!target)
+    {
+        return VisitResult::fail(std::move(target.error()));
+    }
 
-    List<Value> sortedTarget = sortList(target.asList(), sort.getKey());
+    auto sortedTarget = trySortList(**target, sort.getKey());
+    if (!sortedTarget)
+    {
+        return VisitResult::fail(std::move(sortedTarget.error()));
+    }
 
-    target = Value{sortedTarget};
+    **target = std::move(*sortedTarget);
 
     return {};
 }
@@ -248,23 +794,29 @@ GameInterpreter::visit(const ast::Sort& sort)
 VisitResult
 GameInterpreter::visit(const ast::Match& match)
 {
+    auto profile = profileNode(ast::NodeKind::MATCH);
+
     auto ctx = getCurrentMatchExecutionContext();
     bool isFirstVisit = !ctx.has_value();
 
     if (isFirstVisit)
     {
-        auto maybeCandidate = findMatch(match);
-        if (!maybeCandidate.has_value())
+        auto maybeCandidateIndex = findMatch(match);
+        if (!maybeCandidateIndex)
+        {
+            return VisitResult::fail(std::move(maybeCandidateIndex.error()));
+        }
+        if (!maybeCandidateIndex->has_value())
         {
             // No match, we're done
             return {};
         }
+        size_t candidateIndex = **maybeCandidateIndex;
+        m_trace.record(ExecutionTrace::Kind::MATCH_ARM, {}, static_cast<uint32_t>(candidateIndex));
 
-        auto iterator = std::make_unique<ProgramIterator>(
-            ProgramRaw{{maybeCandidate.value().statements}}
-        );
+        auto iterator = m_framePool.acquire(match.getCandidates()[candidateIndex].statements);
         setCurrentStatementContext(
-            ProgramIterator::MatchExecutionContext{std::move(iterator)}
+            ProgramIterator::MatchExecutionContext{std::move(iterator), candidateIndex}
         );
     }
 
@@ -279,17 +831,27 @@ GameInterpreter::visit(const ast::Match& match)
     return {};
 }
 
-std::optional<ast::Match::CandidateRaw>
+Result<std::optional<size_t>>
 GameInterpreter::findMatch(const ast::Match& match)
 {
-    Value targetValue = evaluateExpression(*match.getTarget()).getValue();
+    VisitResult targetResult = evaluateExpression(*match.getTarget());
+    if (targetResult.hasError())
+    {
+        return std::unexpected(targetResult.getError());
+    }
+    const Value& targetValue = targetResult.getValue();
 
-    for (auto& candidate : match.getCandidates())
+    auto candidates = match.getCandidates();
+    for (size_t i = 0; i < candidates.size(); i++)
     {
-        Value candidateValue = evaluateExpression(*(candidate.expressionCandidate)).getValue();
-        if (isEqual(targetValue, candidateValue).value)
+        VisitResult candidateResult = evaluateExpression(*(candidates[i].expressionCandidate));
+        if (candidateResult.hasError())
+        {
+            return std::unexpected(candidateResult.getError());
+        }
+        if (isEqual(targetValue, candidateResult.getValue()).value)
         {
-            return candidate;
+            return i;
         }
     }
 
@@ -299,20 +861,22 @@ GameInterpreter::findMatch(const ast::Match& match)
 VisitResult
 GameInterpreter::visit(const ast::ForLoop& forLoop)
 {
+    auto profile = profileNode(ast::NodeKind::FOR_LOOP);
+
     auto ctx = getCurrentForLoopExecutionContext();
     bool isFirstVisit = !ctx.has_value();
 
-    List<Value> target = evaluateExpression(*forLoop.getTarget())
-                        .getValue()
-                        .asList();
-
     if (isFirstVisit)
     {
-        auto iterator = std::make_unique<ProgramIterator>(
-            ProgramRaw{{forLoop.getStatements()}}
-        );
+        auto target = evaluateLoopTarget(*forLoop.getTarget());
+        if (!target)
+        {
+            return VisitResult::fail(std::move(target.error()));
+        }
+
+        auto iterator = m_framePool.acquire(forLoop.getStatements());
         setCurrentStatementContext(
-            ProgramIterator::ForLoopExecutionContext{std::move(iterator)}
+            ProgramIterator::ForLoopExecutionContext{std::move(iterator), std::move(*target)}
         );
     }
 
@@ -322,9 +886,11 @@ GameInterpreter::visit(const ast::ForLoop& forLoop)
         throw std::runtime_error("ForLoop execution context not found");
     }
 
-    while (ctx.value()->listIndex < target.size() && !needsIO())
+    List<Value>& target = ctx.value()->target;
+
+    while (ctx.value()->listIndex < target.size() && !shouldPause())
     {
-        doVariableAssignment(*forLoop.getElement(), target.atIndex(ctx.value()->listIndex));
+        doVariableAssignment(*forLoop.getElement(), target.value[ctx.value()->listIndex]);
 
         executeProgram(*(ctx.value()->iterator));
 
@@ -344,64 +910,822 @@ GameInterpreter::visit(const ast::ForLoop& forLoop)
     return {};
 }
 
-void
-GameInterpreter::doVariableAssignment(ast::Variable& varTarget, Value valueToAssign)
+VisitResult
+GameInterpreter::visit(const ast::ParallelFor& parallelFor)
 {
-    m_variableMap.store(varTarget.getName(), valueToAssign);
-}
+    auto profile = profileNode(ast::NodeKind::PARALLEL_FOR);
 
-void
-GameInterpreter::doAttributeAssignment(ast::Attribute& attrTarget, Value valueToAssign)
-{
-    auto baseExpr = attrTarget.getBase();
-    if (!baseExpr)
+    auto ctx = getCurrentParallelForExecutionContext();
+    bool isFirstVisit = !ctx.has_value();
+
+    if (isFirstVisit)
     {
-        throw std::runtime_error("Attribute base cannot be null");
-    }
+        auto target = evaluateLoopTarget(*parallelFor.getTarget());
+        if (!target)
+        {
+            return VisitResult::fail(std::move(target.error()));
+        }
+        ProgramIterator::ParallelForExecutionContext newCtx{std::move(*target)};
 
-    VisitResult baseResult = resolveExpression(*baseExpr);
-    Value& baseValue = baseResult.getValue();
-    baseValue.setAttribute(attrTarget.getAttr(), valueToAssign);
-}
+        auto statements = parallelFor.getStatements();
+        for (size_t i = 0; i < newCtx.target.size(); i++)
+        {
+            newCtx.iterations.push_back({m_framePool.acquire(statements)});
+        }
+        setCurrentStatementContext(std::move(newCtx));
+    }
 
-void
-GameInterpreter::storeVariable(const Name& name, Value value) {
-    m_variableMap.store(name, value);
-}
+    ctx = getCurrentParallelForExecutionContext();
+    if (!ctx.has_value())
+    {
+        throw std::runtime_error("ParallelFor execution context not found");
+    }
 
-void
-GameInterpreter::deleteVariable(ast::Variable& variable)
-{
-    m_variableMap.del(variable.getName());
-}
+    List<Value>& target = ctx.value()->target;
+    std::vector<InputWaitKey> waitKeys;
 
-void
-GameInterpreter::execute()
-{
-    m_waitingForInput = false;
-    if (!m_program.has_value())
+    for (size_t i = 0; i < target.size() && !m_preempted && !m_error; i++)
+    {
+        auto& iteration = ctx.value()->iterations[i];
+        if (iteration.iterator->isDone())
+        {
+            continue;
+        }
+
+        // Still parked, don't re-enter it just to block again
+        if (!iteration.waitKeys.empty() && !hasAnyResponse(iteration.waitKeys))
+        {
+            waitKeys.insert(waitKeys.end(), iteration.waitKeys.begin(), iteration.waitKeys.end());
+            continue;
+        }
+
+        m_waitKeys.clear();
+        m_resumedKeys = std::move(iteration.waitKeys);
+
+        // The element belongs to the enclosing scope, as a ForLoop's does.
+        // An iteration that ran before gets it back from its locals below,
+        // as it left it.
+        const Name& elementName = parallelFor.getElement()->getName();
+        if (iteration.locals.empty())
+        {
+            doVariableAssignment(*parallelFor.getElement(), target.value[i]);
+        }
+
+        // Each iteration has its own body variables: bring back the ones it
+        // left, run it, then put away the ones it made
+        std::vector<Name> createdNames;
+        auto* outerCreatedNames = std::exchange(m_createdNames, &createdNames);
+        for (auto& [name, value] : iteration.locals)
+        {
+            trackScores(name, value);
+            m_variableMap.store(name, std::move(value));
+            if (name != elementName)
+            {
+                createdNames.push_back(std::move(name));
+            }
+        }
+        iteration.locals.clear();
+
+        executeProgram(*iteration.iterator);
+        m_createdNames = outerCreatedNames;
+
+        bool parked = !iteration.iterator->isDone();
+        for (Name& name : createdNames)
+        {
+            // Nested loops delete their own elements
+            const Value* local = findVariable(name);
+            if (!local)
+            {
+                continue;
+            }
+            untrackScores(name);
+            if (parked)
+            {
+                iteration.locals.emplace_back(name, *local);
+            }
+            m_variableMap.del(std::move(name));
+        }
+        if (const Value* element = findVariable(elementName); element && parked)
+        {
+            iteration.locals.emplace_back(elementName, *element);
+        }
+
+        iteration.waitKeys = std::exchange(m_waitKeys, {});
+        waitKeys.insert(waitKeys.end(), iteration.waitKeys.begin(), iteration.waitKeys.end());
+    }
+
+    if (m_preempted || m_error)
+    {
+        // Out of budget, the remaining iterations run next time (or failed,
+        // and nothing runs). Don't park, or execute() would wait on input
+        // before resuming them.
+        m_waitKeys.clear();
+        return {};
+    }
+
+    if (waitKeys.empty())
+    {
+        // every iteration is done, clean up
+        deleteVariable(*parallelFor.getElement());
+    }
+    m_waitKeys = std::move(waitKeys);
+
+    return {};
+}
+
+Result<List<Value>>
+GameInterpreter::evaluateLoopTarget(ast::Expression& target)
+{
+    VisitResult targetResult = evaluateExpression(target);
+    if (targetResult.hasError())
+    {
+        return std::unexpected(targetResult.getError());
+    }
+
+    auto targetList = targetResult.getValue().tryAs<List<Value>>();
+    if (!targetList)
+    {
+        return std::unexpected(std::move(targetList.error()));
+    }
+
+    // Copy referenced lists, but take ownership of temporaries
+    return targetResult.isReference()
+         ? **targetList
+         : std::move(**targetList);
+}
+
+Result<List<Value>*>
+GameInterpreter::resolveList(ast::Expression& expr)
+{
+    VisitResult result = resolveExpression(expr);
+    if (result.hasError())
+    {
+        return std::unexpected(result.getError());
+    }
+    return result.getValue().tryAs<List<Value>>();
+}
+
+void
+GameInterpreter::doVariableAssignment(ast::Variable& varTarget, Value valueToAssign)
+{
+    const Name& name = varTarget.getName();
+    trackScores(name, valueToAssign);
+    m_trace.record(ExecutionTrace::Kind::VARIABLE_WRITTEN, name.name);
+    if (m_variableMap.store(name, std::move(valueToAssign)) && m_createdNames)
+    {
+        m_createdNames->push_back(name);
+    }
+}
+
+VisitResult
+GameInterpreter::doAttributeAssignment(ast::Attribute& attrTarget, Value valueToAssign)
+{
+    auto baseExpr = attrTarget.getBase();
+    if (!m_verified && !baseExpr)
+    {
+        return VisitResult::fail("Attribute base cannot be null");
+    }
+
+    VisitResult baseResult = resolveExpression(*baseExpr);
+    if (baseResult.hasError())
+    {
+        return baseResult;
+    }
+
+    auto baseMap = baseResult.getValue().tryAs<Map<String, Value>>();
+    if (!baseMap)
+    {
+        return VisitResult::fail("Only Maps have attributes");
+    }
+    (*baseMap)->setAttribute(attrTarget.getAttr(), std::move(valueToAssign));
+    m_trace.record(ExecutionTrace::Kind::ATTRIBUTE_WRITTEN, attrTarget.getAttr().value);
+
+    // A player's score changed: move them in the rankings that show it,
+    // as the copy held by the variable written
+    ast::Expression* root = baseExpr;
+    while (auto attribute = castExpressionToAttribute(root))
+    {
+        root = attribute->getBase();
+    }
+    if (auto rootVariable = castExpressionToVariable(root))
+    {
+        for (Leaderboard& board : m_leaderboards.edit())
+        {
+            if (board.tracks(attrTarget.getAttr()))
+            {
+                board.update(baseResult.getValue(), rootVariable->getName());
+            }
+        }
+    }
+
+    return {};
+}
+
+void
+GameInterpreter::storeVariable(const Name& name, Value value) {
+    // The program's type-specialized operations rely on these
+    if (!fitsVariableType(name, value))
+    {
+        throw std::runtime_error(
+            "Can't store variable '" + name.name + "': the program gives it values of another type"
+        );
+    }
+    trackScores(name, value);
+    m_trace.record(ExecutionTrace::Kind::VARIABLE_WRITTEN, name.name);
+    m_variableMap.store(name, value);
+}
+
+const Value*
+GameInterpreter::findVariable(const Name& name) const {
+    const auto& entries = m_variableMap.entries();
+    auto it = entries.find(name);
+    return it == entries.end() ? nullptr : it->second.get();
+}
+
+VisitResult
+GameInterpreter::lookupVariable(const Name& name)
+{
+    if (m_resolving)
+    {
+        auto value = m_variableMap.find(name);
+        if (!value)
+        {
+            return VisitResult::fail(std::move(value.error()));
+        }
+        return VisitResult{*value};
+    }
+
+    auto value = m_variableMap.read(name);
+    if (!value)
+    {
+        return VisitResult::fail(std::move(value.error()));
+    }
+    // Expressions read through a reference without changing what it
+    // refers to, only resolved ones are changed
+    return VisitResult{const_cast<Value*>(*value)};
+}
+
+void
+GameInterpreter::deleteVariable(ast::Variable& variable)
+{
+    untrackScores(variable.getName());
+    m_variableMap.del(variable.getName());
+}
+
+bool
+GameInterpreter::fitsVariableType(const Name& name, const Value& value) const
+{
+    if (!m_program)
+    {
+        return true;
+    }
+    auto it = m_program->variableTypes.find(name.name);
+    return it == m_program->variableTypes.end() || it->second == value.getType();
+}
+
+void
+GameInterpreter::execute()
+{
+    if (!m_program)
     {
         throw std::runtime_error("No program to execute");
     }
 
-    executeProgram(*m_iterator.get());
+    // A failed program can't continue
+    if (m_error)
+    {
+        return;
+    }
+
+    // Parked: nothing can change until an awaited response arrives,
+    // so don't re-enter the program just to block again.
+    if (isBlocked() && !hasAnyResponse(m_waitKeys))
+    {
+        return;
+    }
+    std::swap(m_resumedKeys, m_waitKeys);
+    m_waitKeys.clear();
+
+    bool isResuming = m_preempted;
+    m_preempted = false;
+    m_stepsRemaining = m_stepBudget.value_or(0);
+
+    executeProgram(*m_iterator.get());
+
+    if (m_preempted)
+    {
+        m_stats.yields++;
+        if (!isResuming)
+        {
+            m_stats.budgetExceeded++;
+        }
+    }
+}
+
+void
+GameInterpreter::setProfiler(Profiler* profiler)
+{
+    m_profiler = profiler;
+}
+
+const ExecutionTrace&
+GameInterpreter::getTrace() const
+{
+    return m_trace;
+}
+
+namespace
+{
+    enum class ContextTag : uint8_t { NONE, MATCH, FOR_LOOP, PARALLEL_FOR };
+
+    void
+    writeWaitKeys(SnapshotWriter& writer, const std::vector<InputWaitKey>& keys)
+    {
+        writer.writeUInt(keys.size());
+        for (const auto& key : keys)
+        {
+            writer.writeString(key.playerID.value);
+            writer.writeString(key.prompt.value);
+            writer.writeUInt(key.requestID);
+        }
+    }
+
+    std::vector<InputWaitKey>
+    readWaitKeys(SnapshotReader& reader)
+    {
+        std::vector<InputWaitKey> keys(reader.readCount());
+        for (auto& key : keys)
+        {
+            key.playerID = String{reader.readString()};
+            key.prompt = String{reader.readString()};
+            key.requestID = static_cast<RequestID>(reader.readUInt());
+        }
+        return keys;
+    }
+
+    List<Value>
+    readList(SnapshotReader& reader)
+    {
+        Value value = reader.readValue();
+        if (!value.isList())
+        {
+            throw std::runtime_error("Snapshot loop target is not a list");
+        }
+        return std::move(value.asList());
+    }
+}
+
+std::vector<uint8_t>
+GameInterpreter::saveSnapshot() const
+{
+    if (!m_iterator)
+    {
+        throw std::runtime_error("No program to snapshot");
+    }
+
+    SnapshotWriter writer;
+    writer.writeUInt(SNAPSHOT_MAGIC);
+    writer.writeUInt(SNAPSHOT_VERSION);
+
+    const auto& variables = m_variableMap.entries();
+    writer.writeUInt(variables.size());
+    for (const auto& [name, value] : variables)
+    {
+        writer.writeString(name.name);
+        writer.writeValue(*value);
+    }
+
+    saveIterator(writer, *m_iterator);
+    writeWaitKeys(writer, m_waitKeys);
+    writeWaitKeys(writer, m_prefetchedKeys);
+    writer.writeBool(m_preempted);
+    writer.writeBool(m_error.has_value());
+    if (m_error)
+    {
+        writer.writeString(m_error->message);
+    }
+
+    writer.writeUInt(m_stats.steps);
+    writer.writeUInt(m_stats.yields);
+    writer.writeUInt(m_stats.budgetExceeded);
+
+    m_inputManager.saveSnapshot(writer);
+
+    return writer.take();
+}
+
+void
+GameInterpreter::restoreSnapshot(std::span<const uint8_t> snapshot)
+{
+    if (!m_program)
+    {
+        throw std::runtime_error("No program to restore a snapshot into");
+    }
+
+    SnapshotReader reader{snapshot};
+    if (reader.readUInt() != SNAPSHOT_MAGIC)
+    {
+        throw std::runtime_error("Not an interpreter snapshot");
+    }
+    if (reader.readUInt() != SNAPSHOT_VERSION)
+    {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+
+    // Restore into locals, so a bad snapshot leaves this interpreter as it was
+    VariableMap variableMap;
+    size_t variableCount = reader.readCount();
+    for (size_t i = 0; i < variableCount; i++)
+    {
+        Name name{reader.readString()};
+        Value value = reader.readValue();
+        if (!fitsVariableType(name, value))
+        {
+            throw std::runtime_error("Snapshot doesn't match the program");
+        }
+        variableMap.store(std::move(name), std::move(value));
+    }
+
+    auto iterator = std::make_unique<ProgramIterator>(m_programRaw.statements);
+    restoreIterator(reader, *iterator);
+    auto waitKeys = readWaitKeys(reader);
+    auto prefetchedKeys = readWaitKeys(reader);
+    bool preempted = reader.readBool();
+    std::optional<RuntimeError> error;
+    if (reader.readBool())
+    {
+        error = RuntimeError{reader.readString()};
+    }
+
+    ExecutionStats stats;
+    stats.steps = reader.readUInt();
+    stats.yields = reader.readUInt();
+    stats.budgetExceeded = reader.readUInt();
+
+    InputManager inputManager;
+    inputManager.restoreSnapshot(reader);
+
+    if (!reader.atEnd())
+    {
+        throw std::runtime_error("Snapshot has trailing data");
+    }
+
+    m_variableMap = std::move(variableMap);
+    m_iterator = std::move(iterator);
+    m_currentIterator = nullptr;
+    m_waitKeys = std::move(waitKeys);
+    m_prefetchedKeys = std::move(prefetchedKeys);
+    m_preempted = preempted;
+    m_error = std::move(error); // a failed game stays failed
+    m_stats = stats;
+    m_leaderboards = {}; // rebuilt from the variables by the next scores statement
+    m_inputManager = std::move(inputManager);
+}
+
+void
+GameInterpreter::forkFrom(const GameInterpreter& source)
+{
+    if (!m_program || m_program != source.m_program)
+    {
+        throw std::runtime_error("Can only fork an interpreter running the same program");
+    }
+    if (&source == this)
+    {
+        return;
+    }
+
+    auto iterator = std::make_unique<ProgramIterator>(m_programRaw.statements);
+    cloneIterator(*source.m_iterator, *iterator);
+
+    m_variableMap = source.m_variableMap;
+    m_iterator = std::move(iterator);
+    m_currentIterator = nullptr;
+    m_waitKeys = source.m_waitKeys;
+    m_prefetchedKeys = source.m_prefetchedKeys;
+    m_preempted = source.m_preempted;
+    m_error = source.m_error;
+    m_stats = source.m_stats;
+    m_leaderboards = source.m_leaderboards;
+    m_inputManager = source.m_inputManager;
+}
+
+const SharedProgram&
+GameInterpreter::getProgram() const
+{
+    return m_program;
+}
+
+void
+GameInterpreter::saveIterator(SnapshotWriter& writer, const ProgramIterator& iterator) const
+{
+    writer.writeUInt(iterator.getStatementIndex());
+
+    std::visit([&writer, this](const auto& context) {
+        using Context = std::decay_t<decltype(context)>;
+
+        if constexpr (std::is_same_v<Context, ProgramIterator::MatchExecutionContext>)
+        {
+            writer.writeUInt(static_cast<uint8_t>(ContextTag::MATCH));
+            writer.writeUInt(context.candidateIndex);
+            saveIterator(writer, *context.iterator);
+        }
+        else if constexpr (std::is_same_v<Context, ProgramIterator::ForLoopExecutionContext>)
+        {
+            writer.writeUInt(static_cast<uint8_t>(ContextTag::FOR_LOOP));
+            writer.writeValue(Value{context.target});
+            writer.writeUInt(context.listIndex);
+            saveIterator(writer, *context.iterator);
+        }
+        else if constexpr (std::is_same_v<Context, ProgramIterator::ParallelForExecutionContext>)
+        {
+            writer.writeUInt(static_cast<uint8_t>(ContextTag::PARALLEL_FOR));
+            writer.writeValue(Value{context.target});
+            for (const auto& iteration : context.iterations)
+            {
+                saveIterator(writer, *iteration.iterator);
+                writeWaitKeys(writer, iteration.waitKeys);
+                writer.writeUInt(iteration.locals.size());
+                for (const auto& [name, value] : iteration.locals)
+                {
+                    writer.writeString(name.name);
+                    writer.writeValue(value);
+                }
+            }
+        }
+        else
+        {
+            writer.writeUInt(static_cast<uint8_t>(ContextTag::NONE));
+        }
+    }, iterator.getContext());
+}
+
+void
+GameInterpreter::restoreIterator(SnapshotReader& reader, ProgramIterator& iterator)
+{
+    iterator.seek(reader.readUInt());
+
+    auto tag = static_cast<ContextTag>(reader.readUInt());
+    if (tag == ContextTag::NONE)
+    {
+        return;
+    }
+
+    ast::Statement* statement = iterator.currentStatement();
+    if (!statement)
+    {
+        throw std::runtime_error("Snapshot doesn't match the program");
+    }
+
+    if (auto match = ast::castStatementToMatch(statement); match && tag == ContextTag::MATCH)
+    {
+        size_t candidateIndex = reader.readUInt();
+        auto candidates = match->getCandidates();
+        if (candidateIndex >= candidates.size())
+        {
+            throw std::runtime_error("Snapshot doesn't match the program");
+        }
+
+        auto candidateIterator = m_framePool.acquire(candidates[candidateIndex].statements);
+        restoreIterator(reader, *candidateIterator);
+        iterator.setCurrentContext(
+            ProgramIterator::MatchExecutionContext{std::move(candidateIterator), candidateIndex}
+        );
+    }
+    else if (auto forLoop = ast::castStatementToForLoop(statement); forLoop && tag == ContextTag::FOR_LOOP)
+    {
+        List<Value> target = readList(reader);
+        size_t listIndex = reader.readUInt();
+        auto bodyIterator = m_framePool.acquire(forLoop->getStatements());
+        restoreIterator(reader, *bodyIterator);
+
+        iterator.setCurrentContext(
+            ProgramIterator::ForLoopExecutionContext{std::move(bodyIterator), std::move(target), listIndex}
+        );
+    }
+    else if (auto parallelFor = ast::castStatementToParallelFor(statement);
+             parallelFor && tag == ContextTag::PARALLEL_FOR)
+    {
+        ProgramIterator::ParallelForExecutionContext context{readList(reader)};
+        auto statements = parallelFor->getStatements();
+        for (size_t i = 0; i < context.target.size(); i++)
+        {
+            auto bodyIterator = m_framePool.acquire(statements);
+            restoreIterator(reader, *bodyIterator);
+            auto& iteration = context.iterations.emplace_back(std::move(bodyIterator), readWaitKeys(reader));
+            iteration.locals.resize(reader.readCount());
+            for (auto& [name, value] : iteration.locals)
+            {
+                name = Name{reader.readString()};
+                value = reader.readValue();
+                if (!fitsVariableType(name, value))
+                {
+                    throw std::runtime_error("Snapshot doesn't match the program");
+                }
+            }
+        }
+        iterator.setCurrentContext(std::move(context));
+    }
+    else
+    {
+        throw std::runtime_error("Snapshot doesn't match the program");
+    }
+}
+
+void
+GameInterpreter::cloneIterator(const ProgramIterator& source, ProgramIterator& iterator)
+{
+    iterator.seek(source.getStatementIndex());
+
+    // Nested frames come from this interpreter's pool, not the source's
+    auto cloneFrame = [this](const FramePool::Frame& frame) {
+        auto clone = m_framePool.acquire(frame->getStatements());
+        cloneIterator(*frame, *clone);
+        return clone;
+    };
+
+    std::visit([&](const auto& context) {
+        using Context = std::decay_t<decltype(context)>;
+
+        if constexpr (std::is_same_v<Context, ProgramIterator::MatchExecutionContext>)
+        {
+            iterator.setCurrentContext(
+                ProgramIterator::MatchExecutionContext{cloneFrame(context.iterator), context.candidateIndex}
+            );
+        }
+        else if constexpr (std::is_same_v<Context, ProgramIterator::ForLoopExecutionContext>)
+        {
+            iterator.setCurrentContext(
+                ProgramIterator::ForLoopExecutionContext{cloneFrame(context.iterator), context.target, context.listIndex}
+            );
+        }
+        else if constexpr (std::is_same_v<Context, ProgramIterator::ParallelForExecutionContext>)
+        {
+            ProgramIterator::ParallelForExecutionContext clone{context.target};
+            clone.iterations.reserve(context.iterations.size());
+            for (const auto& iteration : context.iterations)
+            {
+                clone.iterations.push_back({cloneFrame(iteration.iterator), iteration.waitKeys, iteration.locals});
+            }
+            iterator.setCurrentContext(std::move(clone));
+        }
+    }, source.getContext());
+}
+
+void
+GameInterpreter::setStepBudget(std::optional<size_t> budget)
+{
+    // It could never run a statement, so the game would hang without an error
+    if (budget == 0)
+    {
+        throw std::invalid_argument("A step budget must allow at least one statement");
+    }
+    m_stepBudget = budget;
+}
+
+std::optional<size_t>
+GameInterpreter::getStepBudget() const
+{
+    return m_stepBudget;
+}
+
+const GameInterpreter::ExecutionStats&
+GameInterpreter::getExecutionStats() const
+{
+    return m_stats;
 }
 
 void
 GameInterpreter::executeProgram(ProgramIterator& iterator)
 {
-    while (iterator.currentStatement() != nullptr && !needsIO())
+    while (iterator.currentStatement() != nullptr && !shouldPause())
     {
+        if (!takeStep())
+        {
+            break;
+        }
+
         m_currentIterator = &iterator;
-        iterator.currentStatement()->accept(*this);
+        m_trace.record(ExecutionTrace::Kind::STATEMENT, {}, 0, iterator.currentStatement()->getLocation());
+        VisitResult result;
+        {
+            auto profile = profileStatement(*iterator.currentStatement());
+            result = iterator.currentStatement()->accept(*this);
+        }
+
+        if (result.hasError())
+        {
+            // Stay on the failed statement, every enclosing loop stops too
+            m_error = result.getError();
+            m_waitKeys.clear();
+            break;
+        }
 
-        if (!needsIO())
+        if (m_error)
+        {
+            break;
+        }
+        else if (isBlocked())
+        {
+            prefetchInputs(iterator);
+        }
+        else if (!m_preempted)
         {
             iterator.goNext();
         }
     }
 }
 
+void
+GameInterpreter::prefetchInputs(const ProgramIterator& iterator)
+{
+    auto remaining = iterator.remainingStatements();
+    if (remaining.empty())
+    {
+        return;
+    }
+
+    auto [run, isNew] = m_prefetchRuns.try_emplace(remaining.front());
+    if (isNew)
+    {
+        run->second = ast::findPrefetchableInputs(remaining);
+    }
+
+    for (const auto& input : run->second)
+    {
+        // Only speculative, the input statement itself reports any error
+        if (auto request = makeInputRequest(input))
+        {
+            InputWaitKey key = InputManager::getRequestKey(*request);
+            key.requestID = m_inputManager.prefetchRequest(std::move(*request));
+            if (key.requestID != NO_REQUEST_ID)
+            {
+                m_prefetchedKeys.push_back(std::move(key));
+            }
+        }
+    }
+}
+
+Result<GameMessage>
+GameInterpreter::makeInputRequest(const ast::InputRequestSpec& input)
+{
+    using Kind = ast::InputRequestSpec::Kind;
+
+    auto playerID = getPlayerID(*input.player);
+    if (!playerID)
+    {
+        return std::unexpected(std::move(playerID.error()));
+    }
+
+    switch (input.kind)
+    {
+        case Kind::TEXT:
+            return GameMessage{GetTextInputMessage{*playerID, input.prompt}};
+        case Kind::CHOICE:
+        case Kind::VOTE:
+        {
+            auto choices = evaluateAs<List<Value>>(*input.operands[0]);
+            if (!choices)
+            {
+                return std::unexpected(std::move(choices.error()));
+            }
+            ChoiceSet choiceSet = getChoiceSet(*input.statement, *choices);
+            if (input.kind == Kind::CHOICE)
+            {
+                return GameMessage{GetChoiceInputMessage{*playerID, input.prompt, std::move(choiceSet)}};
+            }
+            return GameMessage{GetVoteInputMessage{*playerID, input.prompt, std::move(choiceSet)}};
+        }
+        case Kind::RANGE:
+        {
+            auto minValue = evaluateAs<Integer>(*input.operands[0]);
+            if (!minValue)
+            {
+                return std::unexpected(std::move(minValue.error()));
+            }
+            auto maxValue = evaluateAs<Integer>(*input.operands[1]);
+            if (!maxValue)
+            {
+                return std::unexpected(std::move(maxValue.error()));
+            }
+            return GameMessage{GetRangeInputMessage{*playerID, input.prompt, *minValue, *maxValue}};
+        }
+    }
+    return std::unexpected(RuntimeError{"Unknown input kind"});
+}
+
+ChoiceSet
+GameInterpreter::getChoiceSet(const ast::Statement& statement, const List<Value>& choices)
+{
+    // Comparing with the statement's last set is cheaper than interning,
+    // which hashes the whole list under a lock shared by every session
+    auto [cached, isNew] = m_choiceSets.try_emplace(&statement);
+    if (isNew || cached->second.getChoices() != choices)
+    {
+        cached->second = ChoiceSet::intern(choices);
+    }
+    return cached->second;
+}
+
 void
 GameInterpreter::assertCurrentIterator()
 {
@@ -427,6 +1751,13 @@ GameInterpreter::getCurrentMatchExecutionContext()
     return m_currentIterator->currentContext<ProgramIterator::MatchExecutionContext>();
 }
 
+std::optional<ProgramIterator::ParallelForExecutionContext*>
+GameInterpreter::getCurrentParallelForExecutionContext()
+{
+    assertCurrentIterator();
+    return m_currentIterator->currentContext<ProgramIterator::ParallelForExecutionContext>();
+}
+
 void
 GameInterpreter::setCurrentStatementContext(ProgramIterator::StatementContext ctx)
 {
@@ -436,10 +1767,15 @@ GameInterpreter::setCurrentStatementContext(ProgramIterator::StatementContext ct
 VisitResult
 GameInterpreter::evaluateExpression(ast::Expression& expr)
 {
+    if (uint32_t index = expr.getFlatIndex(); index != ast::Expression::NOT_FLAT && m_flat)
+    {
+        return evaluateFlat(*m_flat, index);
+    }
+
     VisitResult result = expr.accept(*this);
-    if (!result.hasValue())
+    if (!m_verified && !result.hasValue() && !result.hasError())
     {
-        throw std::runtime_error("Expression did not evaluate to a value");
+        return VisitResult::fail("Expression did not evaluate to a value");
     }
     return result;
 }
@@ -447,19 +1783,52 @@ GameInterpreter::evaluateExpression(ast::Expression& expr)
 VisitResult
 GameInterpreter::resolveExpression(ast::Expression& expr)
 {
-    VisitResult result = expr.accept(*this);
+    bool wasResolving = std::exchange(m_resolving, true);
+    VisitResult result = referenceExpression(expr);
+    m_resolving = wasResolving;
+    return result;
+}
+
+VisitResult
+GameInterpreter::referenceExpression(ast::Expression& expr)
+{
+    uint32_t index = expr.getFlatIndex();
+    VisitResult result = index != ast::Expression::NOT_FLAT && m_flat ? evaluateFlat(*m_flat, index) : expr.accept(*this);
+    // Verified targets are Variables or Attributes, which always give a
+    // reference when they don't fail
+    if (m_verified || result.hasError())
+    {
+        return result;
+    }
     if (!result.hasValue())
     {
-        throw std::runtime_error("Expression did not resolve to a Value");
+        return VisitResult::fail("Expression did not resolve to a Value");
     }
     if (!result.isReference())
     {
-        throw std::runtime_error("Expression did not resolve to a Value reference");
+        return VisitResult::fail("Expression did not resolve to a Value reference");
     }
 
     return result;
 }
 
+template <typename T>
+Result<T>
+GameInterpreter::evaluateAs(ast::Expression& expr)
+{
+    VisitResult result = evaluateExpression(expr);
+    if (result.hasError())
+    {
+        return std::unexpected(result.getError());
+    }
+    auto value = result.getValue().tryAs<T>();
+    if (!value)
+    {
+        return std::unexpected(std::move(value.error()));
+    }
+    return **value;
+}
+
 Boolean
 GameInterpreter::isEqual(const Value& a, const Value& b)
 {
@@ -467,7 +1836,7 @@ GameInterpreter::isEqual(const Value& a, const Value& b)
     return Boolean{isEqual};
 }
 
-Boolean
+Result<Boolean>
 GameInterpreter::isLessThan(const Value& left, const Value& right)
 {
     auto maybeIsLessThan = maybeCompareValues(left, right);
@@ -475,18 +1844,88 @@ GameInterpreter::isLessThan(const Value& left, const Value& right)
     {
         return Boolean{*maybeIsLessThan};
     }
-    throw std::runtime_error("Values are not less-than comparable");
+    return std::unexpected(RuntimeError{"Values are not less-than comparable"});
 }
 
 bool
 GameInterpreter::needsIO() const
 {
-    return m_inputManager.getPendingRequests().size() > 0 || m_waitingForInput;
+    return m_inputManager.hasPendingRequests() || isBlocked();
+}
+
+void
+GameInterpreter::waitForInput(String playerID, String prompt, RequestID requestID)
+{
+    m_trace.record(ExecutionTrace::Kind::INPUT_REQUESTED, playerID.value);
+    m_waitKeys.clear();
+    m_waitKeys.push_back(InputWaitKey{std::move(playerID), std::move(prompt), requestID});
+}
+
+RequestID
+GameInterpreter::takeResumedRequestID(const String& playerID, const String& prompt)
+{
+    // The statement that parked is the first one resumed, and only the run
+    // after it is prefetched, so both are short
+    for (auto* keys : {&m_resumedKeys, &m_prefetchedKeys})
+    {
+        auto key = std::ranges::find_if(*keys, [&playerID, &prompt](const InputWaitKey& key) {
+            return key.playerID == playerID && key.prompt == prompt;
+        });
+        if (key != keys->end())
+        {
+            RequestID requestID = key->requestID;
+            keys->erase(key);
+            return requestID;
+        }
+    }
+    return NO_REQUEST_ID;
+}
+
+bool
+GameInterpreter::isBlocked() const
+{
+    return !m_waitKeys.empty();
+}
+
+bool
+GameInterpreter::shouldPause() const
+{
+    return isBlocked() || m_preempted || m_error.has_value();
+}
+
+bool
+GameInterpreter::takeStep()
+{
+    if (m_stepBudget.has_value())
+    {
+        if (m_stepsRemaining == 0)
+        {
+            m_preempted = true;
+            return false;
+        }
+        m_stepsRemaining--;
+    }
+    m_stats.steps++;
+    return true;
+}
+
+bool
+GameInterpreter::hasAnyResponse(const std::vector<InputWaitKey>& keys) const
+{
+    return std::ranges::any_of(keys, [this](const InputWaitKey& key) {
+        return m_inputManager.hasResponse(key);
+    });
+}
+
+const std::optional<RuntimeError>&
+GameInterpreter::getError() const
+{
+    return m_error;
 }
 
 bool
 GameInterpreter::isDone() const {
-    if(!m_program.has_value()) return true;
+    if(!m_program) return true;
 
     if(!m_iterator) return true;
 
@@ -496,151 +1935,412 @@ GameInterpreter::isDone() const {
 VisitResult
 GameInterpreter::visit(const ast::InputText& inputText)
 {
+    auto profile = profileNode(ast::NodeKind::INPUT_TEXT);
+
     auto playerVar = inputText.getPlayer();
     auto targetExpr = inputText.getTarget();
     String prompt = inputText.getPrompt();
-    String playerID = getPlayerAttribute(*playerVar, String{"id"}).asString();
 
-    auto maybeText = m_inputManager.getTextInput(playerID, prompt);
+    auto playerID = getPlayerID(*playerVar);
+    if (!playerID)
+    {
+        return VisitResult::fail(std::move(playerID.error()));
+    }
+
+    RequestID requestID = takeResumedRequestID(*playerID, prompt);
+    auto maybeText = m_inputManager.getTextInput(*playerID, prompt, requestID);
     if (!maybeText)
     {
-        m_waitingForInput = true;
+        waitForInput(std::move(*playerID), prompt, requestID);
         return {};
     }
 
-    m_waitingForInput = false;
-
-    Value input{*maybeText};
-    auto assignment = ast::makeAssignment(
-        ast::cloneExpression(targetExpr),
-        ast::makeConstant(input)
-    );
-    assignment->accept(*this);
+    m_waitKeys.clear();
+    m_trace.record(ExecutionTrace::Kind::INPUT_RECEIVED, playerID->value);
 
-    return {};
+    return assignInput(targetExpr, Value{*maybeText});
 }
 
 VisitResult
 GameInterpreter::visit(const ast::InputChoice& inputChoice)
 {
+    auto profile = profileNode(ast::NodeKind::INPUT_CHOICE);
+
     auto playerVar = inputChoice.getPlayer();
     auto targetExpr = inputChoice.getTarget();
     String prompt = inputChoice.getPrompt();
     auto choicesExpr = inputChoice.getChoices();
-    String playerID = getPlayerAttribute(*playerVar, String{"id"}).asString();
+
+    auto playerID = getPlayerID(*playerVar);
+    if (!playerID)
+    {
+        return VisitResult::fail(std::move(playerID.error()));
+    }
 
     VisitResult choicesResult = evaluateExpression(*choicesExpr);
+    if (choicesResult.hasError())
+    {
+        return choicesResult;
+    }
     Value& choicesValue = choicesResult.getValue();
 
     if (!choicesValue.isList())
     {
-        throw std::runtime_error("Choices must evaluate to a list");
+        return VisitResult::fail("Choices must evaluate to a list");
     }
 
-    List<Value> choices = choicesValue.asList();
-
-    auto maybeChoice = m_inputManager.getChoiceInput(playerID, prompt, choices);
+    RequestID requestID = takeResumedRequestID(*playerID, prompt);
+    auto maybeChoice = m_inputManager.getChoiceInput(
+        *playerID, prompt, getChoiceSet(inputChoice, choicesValue.asList()), requestID);
     if (!maybeChoice)
     {
-        m_waitingForInput = true;
+        waitForInput(std::move(*playerID), prompt, requestID);
         return {};
     }
-    m_waitingForInput = false;
+    m_waitKeys.clear();
+    m_trace.record(ExecutionTrace::Kind::INPUT_RECEIVED, playerID->value);
 
-    Value choiceValue{*maybeChoice};
-    auto assignment = ast::makeAssignment(
-        ast::cloneExpression(targetExpr),
-        ast::makeConstant(choiceValue)
-    );
-    assignment->accept(*this);
-
-    return {};
+    return assignInput(targetExpr, Value{*maybeChoice});
 }
 
 VisitResult
 GameInterpreter::visit(const ast::InputRange& inputRange)
 {
+    auto profile = profileNode(ast::NodeKind::INPUT_RANGE);
+
     auto playerVar = inputRange.getPlayer();
     auto targetExpr = inputRange.getTarget();
     String prompt = inputRange.getPrompt();
     auto minExpr = inputRange.getMinValue();
     auto maxExpr = inputRange.getMaxValue();
 
-    String playerID = getPlayerAttribute(*playerVar, String{"id"}).asString();
+    auto playerID = getPlayerID(*playerVar);
+    if (!playerID)
+    {
+        return VisitResult::fail(std::move(playerID.error()));
+    }
 
-    Value minValue = evaluateExpression(*minExpr).getValue();
-    Value maxValue = evaluateExpression(*maxExpr).getValue();
+    auto minValue = evaluateAs<Integer>(*minExpr);
+    if (!minValue)
+    {
+        return VisitResult::fail(std::move(minValue.error()));
+    }
+    auto maxValue = evaluateAs<Integer>(*maxExpr);
+    if (!maxValue)
+    {
+        return VisitResult::fail(std::move(maxValue.error()));
+    }
 
-    auto maybeRange = m_inputManager.getRangeInput(
-        playerID, prompt, minValue.asInteger(), maxValue.asInteger()
-    );
+    // An invalid number is re-requested by the input manager, so it
+    // just looks like the response hasn't arrived yet
+    RequestID requestID = takeResumedRequestID(*playerID, prompt);
+    auto maybeRange = m_inputManager.getRangeInput(*playerID, prompt, *minValue, *maxValue, requestID);
 
     if (!maybeRange)
     {
-        m_waitingForInput = true;
+        waitForInput(std::move(*playerID), prompt, requestID);
         return {};
     }
-    m_waitingForInput = false;
-
-    auto assignment = ast::makeAssignment(
-        ast::cloneExpression(targetExpr),
-        ast::makeConstant(Value{*maybeRange})
-    );
-    assignment->accept(*this);
+    m_waitKeys.clear();
+    m_trace.record(ExecutionTrace::Kind::INPUT_RECEIVED, playerID->value);
 
-    return {};
+    return assignInput(targetExpr, Value{*maybeRange});
 }
 
 VisitResult
 GameInterpreter::visit(const ast::InputVote& inputVote)
 {
+    auto profile = profileNode(ast::NodeKind::INPUT_VOTE);
+
     auto playerVar = inputVote.getPlayer();
     auto targetExpr = inputVote.getTarget();
     String prompt = inputVote.getPrompt();
     auto choicesExpr = inputVote.getChoices();
 
-    String playerID = getPlayerAttribute(*playerVar, String{"id"}).asString();
+    VisitResult playersResult = evaluateExpression(*playerVar);
+    if (playersResult.hasError())
+    {
+        return playersResult;
+    }
 
     VisitResult choicesResult = evaluateExpression(*choicesExpr);
+    if (choicesResult.hasError())
+    {
+        return choicesResult;
+    }
     Value& choicesValue = choicesResult.getValue();
 
     if (!choicesValue.isList())
     {
-        throw std::runtime_error("Vote choices must evaluate to a list");
+        return VisitResult::fail("Vote choices must evaluate to a list");
+    }
+
+    if (playersResult.getValue().isList())
+    {
+        return doGroupVote(playersResult.getValue().asList(), targetExpr, std::move(prompt), choicesValue.asList());
     }
 
-    List<Value> choices = choicesValue.asList();
+    auto playerID = getPlayerID(playersResult.getValue());
+    if (!playerID)
+    {
+        return VisitResult::fail(std::move(playerID.error()));
+    }
 
-    auto maybeVote = m_inputManager.getVoteInput(playerID, prompt, choices);
+    RequestID requestID = takeResumedRequestID(*playerID, prompt);
+    auto maybeVote = m_inputManager.getVoteInput(
+        *playerID, prompt, getChoiceSet(inputVote, choicesValue.asList()), requestID);
 
     if (!maybeVote)
     {
-        m_waitingForInput = true;
+        waitForInput(std::move(*playerID), prompt, requestID);
+        return {};
+    }
+    m_waitKeys.clear();
+    m_trace.record(ExecutionTrace::Kind::INPUT_RECEIVED, playerID->value);
+
+    return assignInput(targetExpr, Value{*maybeVote});
+}
+
+VisitResult
+GameInterpreter::doGroupVote(List<Value>& players, ast::Expression* targetExpr, String prompt, const List<Value>& choices)
+{
+    std::vector<String> voterIDs;
+    voterIDs.reserve(players.size());
+    for (Value& player : players.value)
+    {
+        auto playerID = getPlayerID(player);
+        if (!playerID)
+        {
+            return VisitResult::fail(std::move(playerID.error()));
+        }
+        voterIDs.push_back(std::move(*playerID));
+    }
+
+    if (choices.value.empty() || !std::ranges::all_of(choices.value, &Value::isString))
+    {
+        return VisitResult::fail("Vote choices must be a non-empty list of strings");
+    }
+
+    // Counted by the input manager as the votes arrive
+    RequestID voteID = takeResumedRequestID(String{}, prompt);
+    auto tally = m_inputManager.getGroupVote(voterIDs, prompt, choices, voteID);
+    if (!tally)
+    {
+        waitForInput(String{}, std::move(prompt), voteID);
         return {};
     }
-    m_waitingForInput = false;
+    m_waitKeys.clear();
+    m_trace.record(ExecutionTrace::Kind::INPUT_RECEIVED);
 
-    Value voteValue{*maybeVote};
+    return assignInput(targetExpr, Value{tally->getWinner()});
+}
+
+VisitResult
+GameInterpreter::assignInput(ast::Expression* targetExpr, Value input)
+{
     auto assignment = ast::makeAssignment(
         ast::cloneExpression(targetExpr),
-        ast::makeConstant(voteValue)
+        ast::makeConstant(std::move(input))
     );
-    assignment->accept(*this);
+    return assignment->accept(*this);
+}
+
+namespace
+{
+    /// Appends a value as players should read it: strings without quotes
+    void
+    appendText(std::string& out, const Value& value)
+    {
+        if (value.isString())
+        {
+            out += value.asString().value;
+        }
+        else if (value.isInteger())
+        {
+            char digits[16];
+            auto [end, error] = std::to_chars(std::begin(digits), std::end(digits), value.asInteger().value);
+            out.append(digits, end);
+        }
+        else if (value.isBoolean())
+        {
+            out += value.asBoolean().value ? "true" : "false";
+        }
+        else
+        {
+            std::ostringstream text;
+            text << value;
+            out += text.str();
+        }
+    }
+}
+
+VisitResult
+GameInterpreter::visit(const ast::Message& message)
+{
+    auto profile = profileNode(ast::NodeKind::MESSAGE);
+
+    std::vector<String> playerIDs;
+    if (ast::Expression* players = message.getPlayers())
+    {
+        VisitResult playersResult = evaluateExpression(*players);
+        if (playersResult.hasError())
+        {
+            return playersResult;
+        }
+
+        Value& recipients = playersResult.getValue();
+        if (recipients.isList())
+        {
+            for (Value& player : recipients.asList().value)
+            {
+                auto playerID = getPlayerID(player);
+                if (!playerID)
+                {
+                    return VisitResult::fail(std::move(playerID.error()));
+                }
+                playerIDs.push_back(std::move(*playerID));
+            }
+        }
+        else
+        {
+            auto playerID = getPlayerID(recipients);
+            if (!playerID)
+            {
+                return VisitResult::fail(std::move(playerID.error()));
+            }
+            playerIDs.push_back(std::move(*playerID));
+        }
+
+        // An empty list of players means there's nobody to tell
+        if (playerIDs.empty())
+        {
+            return {};
+        }
+    }
+
+    m_messageBuffer.clear();
+    for (const auto& segment : message.getSegments())
+    {
+        if (!segment.expression)
+        {
+            m_messageBuffer += segment.text;
+            continue;
+        }
+
+        VisitResult result = evaluateExpression(*segment.expression);
+        if (result.hasError())
+        {
+            return result;
+        }
+
+        appendText(m_messageBuffer, result.getValue());
+    }
+
+    m_inputManager.sendOutput(m_messageBuffer, std::move(playerIDs));
 
     return {};
 }
 
-Value
-GameInterpreter::getPlayerAttribute(const ast::Variable& playerVar, String attr)
+VisitResult
+GameInterpreter::visit(const ast::Scores& scores)
 {
-    auto playerAttr = ast::makeAttribute(ast::makeVariable(playerVar.getName()), attr);
-    VisitResult result = playerAttr->accept(*this);
+    auto profile = profileNode(ast::NodeKind::SCORES);
 
-    if (!result.hasValue())
+    const auto& keys = scores.getKeys();
+    if (!m_verified && keys.empty())
     {
-        throw std::runtime_error(
-            "Failed to get player attribute: " + attr.value
-        );
+        return VisitResult::fail("Scores needs at least one attribute");
+    }
+
+    auto board = std::find_if(m_leaderboards->begin(), m_leaderboards->end(), [&keys](const Leaderboard& board) {
+        return board.getKeys() == keys;
+    });
+    if (board == m_leaderboards->end())
+    {
+        // First time these scores are shown: rank everyone once, then keep
+        // up. Which of several differing copies was written last isn't known
+        // here, so the first variable by name is shown, not the first hashed.
+        Leaderboard& added = m_leaderboards.edit().emplace_back(keys);
+        board = std::prev(m_leaderboards->end());
+        std::vector<const VariableMap::Entries::value_type*> variables;
+        for (const auto& entry : m_variableMap.entries())
+        {
+            variables.push_back(&entry);
+        }
+        std::sort(variables.begin(), variables.end(), [](const auto* a, const auto* b) {
+            return a->first.name < b->first.name;
+        });
+        for (const auto* variable : variables)
+        {
+            added.hold(variable->first, *variable->second);
+        }
+    }
+
+    m_messageBuffer.assign("Scores:");
+    size_t rank = 0;
+    board->forEachTop(board->size(), [this, &keys, &rank](const Leaderboard::Row& row) {
+        m_messageBuffer += '\n';
+        appendText(m_messageBuffer, Value{Integer{static_cast<int>(++rank)}});
+        m_messageBuffer += ". ";
+        m_messageBuffer += row.name.value;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            m_messageBuffer += i == 0 ? " - " : ", ";
+            m_messageBuffer += keys[i].value;
+            m_messageBuffer += ": ";
+            if (row.values[i])
+            {
+                appendText(m_messageBuffer, *row.values[i]);
+            }
+            else
+            {
+                m_messageBuffer += '-';
+            }
+        }
+    });
+
+    m_inputManager.sendOutput(m_messageBuffer, {});
+
+    return {};
+}
+
+void
+GameInterpreter::trackScores(const Name& name, const Value& value)
+{
+    for (Leaderboard& board : m_leaderboards.edit())
+    {
+        board.hold(name, value);
+    }
+}
+
+void
+GameInterpreter::untrackScores(const Name& name)
+{
+    for (Leaderboard& board : m_leaderboards.edit())
+    {
+        board.remove(name);
+    }
+}
+
+Result<String>
+GameInterpreter::getPlayerID(const ast::Variable& playerVar)
+{
+    auto playerAttr = ast::makeAttribute(ast::makeVariable(playerVar.getName()), String{"id"});
+    return evaluateAs<String>(*playerAttr);
+}
+
+Result<String>
+GameInterpreter::getPlayerID(Value& player)
+{
+    auto id = player.findAttribute(String{"id"});
+    if (!id)
+    {
+        return std::unexpected(std::move(id.error()));
+    }
+    auto idString = (*id)->tryAs<String>();
+    if (!idString)
+    {
+        return std::unexpected(std::move(idString.error()));
     }
-    return result.getValue();
+    return **idString;
 }
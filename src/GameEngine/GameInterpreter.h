@@ -1,12 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include "Types.h"
+#include "CopyOnWrite.h"
 #include "VariableMap.h"
 #include "InputManager.h"
+#include "Leaderboard.h"
 #include "GameMessage.h"
 #include "Rules.h"
+#include "InputPrefetch.h"
+#include "TypeInference.h"
+#include "Verifier.h"
+#include "FlatExpressions.h"
+#include "Profiler.h"
+#include "ExecutionTrace.h"
+#include "Snapshot.h"
 
 
 struct ProgramRaw
@@ -15,22 +29,61 @@ struct ProgramRaw
 };
 
 
+/**
+ * A compiled game. Execution never modifies the AST, so one Program can be
+ * shared (see SharedProgram) by every session running the same game, each
+ * keeping only its own variables and iterator state.
+ */
 struct Program
 {
     std::vector<std::unique_ptr<ast::Statement>> statements;
-
-    ProgramRaw raw()
+    // Types inferTypes() found, if it was run on the statements
+    ast::VariableTypes variableTypes;
+    // The expressions again, stored contiguously, if flattenExpressions() was run
+    ast::FlatExpressions flatExpressions;
+    // Set when verifyStructure() passed, so the interpreter can skip its
+    // structural checks. Leave unset for hand-built or unchecked programs.
+    bool verified = false;
+
+    ProgramRaw raw() const
     {
-        std::vector<ast::Statement*> statementsRaw;
-        for (auto &statement : statements)
-        {
-            statementsRaw.push_back(statement.get());
-        }
-        ProgramRaw programRaw{statementsRaw};
-        return programRaw;
+        return ProgramRaw{ast::rawStatements(statements)};
     }
 };
 
+using SharedProgram = std::shared_ptr<const Program>;
+
+
+class ProgramIterator;
+
+/**
+ * Recycles the iterators that match arms and loop bodies run on.
+ *
+ * Frames are handed out by acquire() and come back to the pool when their
+ * owning statement context is cleared, so once the pool has grown to the
+ * rules' nesting depth, entering a match arm or loop body doesn't allocate.
+ * The pool must outlive every frame it hands out.
+ */
+class FramePool
+{
+    public:
+        struct Release
+        {
+            FramePool* pool;
+            void operator()(ProgramIterator* frame) const;
+        };
+
+        using Frame = std::unique_ptr<ProgramIterator, Release>;
+
+        /// A frame positioned at the first of `statements`, which must outlive it
+        Frame acquire(std::span<ast::Statement* const> statements);
+
+        size_t freeFrames() const { return m_free.size(); }
+
+    private:
+        std::vector<std::unique_ptr<ProgramIterator>> m_free;
+};
+
 
 /**
  * Keeps track of the current statement of a Program.
@@ -51,29 +104,54 @@ class ProgramIterator
     public:
         struct MatchExecutionContext
         {
-            std::unique_ptr<ProgramIterator> iterator; // candidate statements iterator
+            FramePool::Frame iterator; // candidate statements iterator
+            size_t candidateIndex = 0; // which candidate matched
         };
 
         struct ForLoopExecutionContext
         {
-            std::unique_ptr<ProgramIterator> iterator; // statements iterator
+            FramePool::Frame iterator; // statements iterator
+            List<Value> target; // evaluated once, on first visit
             size_t listIndex = 0;
         };
 
+        struct ParallelForExecutionContext
+        {
+            struct Iteration
+            {
+                FramePool::Frame iterator; // statements iterator
+                std::vector<InputWaitKey> waitKeys; // inputs this iteration is parked on
+                std::vector<std::pair<Name, Value>> locals; // its element and the variables its body made, put away while others run
+            };
+
+            List<Value> target; // evaluated once, on first visit
+            std::vector<Iteration> iterations; // one per target element
+        };
+
         using StatementContext = std::variant<std::monostate,
                                               MatchExecutionContext,
-                                              ForLoopExecutionContext>;
+                                              ForLoopExecutionContext,
+                                              ParallelForExecutionContext>;
 
     public:
-        ProgramIterator(ProgramRaw program) : m_statementIndex(0)
+        /// Walks `statements` without copying them, so they must outlive the iterator
+        ProgramIterator(std::span<ast::Statement* const> statements)
         {
-            if (program.statements.empty())
+            assign(statements);
+        }
+
+        /// Starts over on other statements, see FramePool
+        void assign(std::span<ast::Statement* const> statements)
+        {
+            if (statements.empty())
             {
                 throw std::runtime_error(
                     "Can't create iterator: program must have at least one statement"
                 );
             }
-            m_program = program;
+            m_statements = statements;
+            m_statementIndex = 0;
+            m_context = {};
         }
 
         void setCurrentContext(StatementContext context)
@@ -87,9 +165,9 @@ class ProgramIterator
 
         ast::Statement* currentStatement()
         {
-            if (m_statementIndex < m_program.statements.size())
+            if (m_statementIndex < m_statements.size())
             {
-                return m_program.statements[m_statementIndex];
+                return m_statements[m_statementIndex];
             }
             return nullptr;
         }
@@ -128,36 +206,123 @@ class ProgramIterator
             return !currentStatement();
         }
 
+        // The current statement followed by the rest of the program
+        std::span<ast::Statement* const> remainingStatements() const
+        {
+            return m_statements.subspan(std::min(m_statementIndex, m_statements.size()));
+        }
+
         void reset()
         {
             m_statementIndex = 0;
             m_context = {};
         }
 
+        std::span<ast::Statement* const> getStatements() const
+        {
+            return m_statements;
+        }
+
+        size_t getStatementIndex() const
+        {
+            return m_statementIndex;
+        }
+
+        /// Moves to statement `index` (the end is allowed) and clears its context
+        void seek(size_t index)
+        {
+            if (index > m_statements.size())
+            {
+                throw std::runtime_error("Can't seek: index is past the end of the program");
+            }
+            m_statementIndex = index;
+            m_context = {};
+        }
+
+        const StatementContext& getContext() const
+        {
+            return m_context;
+        }
+
     private:
-        ProgramRaw m_program;
-        size_t m_statementIndex;
+        std::span<ast::Statement* const> m_statements;
+        size_t m_statementIndex = 0;
         StatementContext m_context;
 };
 
 
+inline void
+FramePool::Release::operator()(ProgramIterator* frame) const
+{
+    // Hands back the frames nested in this one first
+    frame->reset();
+    pool->m_free.emplace_back(frame);
+}
+
+inline FramePool::Frame
+FramePool::acquire(std::span<ast::Statement* const> statements)
+{
+    if (m_free.empty())
+    {
+        return Frame{new ProgramIterator(statements), Release{this}};
+    }
+
+    Frame frame{m_free.back().release(), Release{this}};
+    m_free.pop_back();
+    frame->assign(statements);
+    return frame;
+}
+
+
 class GameInterpreter : public ast::ASTVisitor
 {
+    public:
+        /// How much work execute() has done, for spotting heavy games
+        struct ExecutionStats
+        {
+            size_t steps = 0; // statements run
+            size_t yields = 0; // execute() calls cut short by the step budget
+            size_t budgetExceeded = 0; // runs that needed more than one budget to get through
+        };
+
     public:
         GameInterpreter(InputManager& inputManager, std::optional<Program> program)
+            : GameInterpreter(
+                inputManager,
+                program.has_value()
+                    ? std::make_shared<const Program>(std::move(*program))
+                    : SharedProgram{}
+            )
+        {}
+
+        /// Runs a program that may be shared with other interpreters.
+        /// (A template only so that `{}` still picks the overload above.)
+        template <std::same_as<SharedProgram> P>
+        GameInterpreter(InputManager& inputManager, P program)
             : m_inputManager(inputManager)
             , m_program(std::move(program))
+            , m_verified(m_program && m_program->verified)
+            , m_flat(m_program && m_program->flatExpressions.size() > 0 ? &m_program->flatExpressions : nullptr)
             , m_currentIterator(nullptr)
         {
-            if (m_program.has_value())
+            if (m_program)
             {
-                m_iterator = std::make_unique<ProgramIterator>(m_program.value().raw());
+                m_programRaw = m_program->raw();
+                m_iterator = std::make_unique<ProgramIterator>(m_programRaw.statements);
             }
         }
 
+        // Frames point back at this interpreter's pool
+        GameInterpreter(GameInterpreter&&) = delete;
+        GameInterpreter& operator=(GameInterpreter&&) = delete;
+
         void
         storeVariable(const Name& name, Value value);
 
+        /// The variable's current value, or nullptr if it isn't set
+        const Value*
+        findVariable(const Name& name) const;
+
         VisitResult visit(const ast::ASTNode& node) override;
 
         /**
@@ -328,14 +493,38 @@ class GameInterpreter : public ast::ASTVisitor
          * Note: Be careful with the name for the `element` variable, it will be deleted after
          *       the forLoop finishes executing.
          *
+         * The `target` is evaluated once, when the loop is first entered. Resuming
+         * after an input pause continues over that same list, so changes made to
+         * the target by the loop body don't affect the iteration.
+         *
          * @param forLoop The ForLoop node to visit.
          * @return VisitResult
          *
          * @pre `target` resolves to a List.
-         * @pre `target` elements are not added/removed/re-ordered during execution.
          */
         VisitResult visit(const ast::ForLoop& forLoop) override;
 
+        /**
+         * @brief For each element in the `target` expression (list), execute `statements`,
+         * with all elements' iterations in flight at once.
+         *
+         * Each iteration runs until it finishes or blocks on input, then the next one
+         * starts, so every iteration's input requests go out in the same pass. Blocked
+         * iterations resume independently as their responses arrive. The statement
+         * completes once every iteration has finished.
+         *
+         * As with ForLoop, the `target` is evaluated once and the `element` variable
+         * is deleted when the statement completes. Unlike ForLoop, variables the body
+         * creates belong to their iteration: each iteration sees only its own, and
+         * they're deleted when it finishes rather than kept after the loop.
+         *
+         * @param parallelFor The ParallelFor node to visit.
+         * @return VisitResult
+         *
+         * @pre `target` resolves to a List.
+         */
+        VisitResult visit(const ast::ParallelFor& parallelFor) override;
+
         /**
          * @brief Prompts and stores player text input.
          */
@@ -353,46 +542,261 @@ class GameInterpreter : public ast::ASTVisitor
          */
         VisitResult visit(const ast::InputVote& inputVote) override;
 
+        /**
+         * @brief Renders the message's template and queues it on the input
+         * manager, once, for the players it's addressed to (everyone if none).
+         */
+        VisitResult visit(const ast::Message& message) override;
+
+        /**
+         * @brief Sends everyone the players ranked by the first listed
+         * attribute. The ranking is kept up to date as variables holding
+         * players are written (see Leaderboard), so this only walks it. A
+         * board is built from the variables the first time its scores are
+         * shown, and again after a restore.
+         */
+        VisitResult visit(const ast::Scores& scores) override;
+
+        /**
+         * @brief Runs the program until it finishes, blocks on input, or uses
+         * up its step budget.
+         *
+         * If the program is parked on an input statement, this is a no-op
+         * until the response it is waiting for has arrived. If it ran out of
+         * budget, the next call resumes where it left off.
+         */
         void execute();
 
+        /**
+         * @brief Caps how many statements a single execute() call may run.
+         *
+         * Every statement counts, including those nested in loops and matches.
+         * No budget (the default) runs until the program finishes or blocks.
+         * Throws std::invalid_argument for a budget of 0.
+         */
+        void setStepBudget(std::optional<size_t> budget);
+
+        std::optional<size_t> getStepBudget() const;
+
+        const ExecutionStats& getExecutionStats() const;
+
+        /**
+         * @brief Records per node kind and per statement stats into `profiler`
+         * while executing. The profiler must outlive the interpreter, or be
+         * unset first. Null (the default) turns profiling off. Records
+         * nothing in builds without GAMEENGINE_PROFILING.
+         */
+        void setProfiler(Profiler* profiler);
+
+        /// What this interpreter did last, always recorded (see ExecutionTrace).
+        /// Like the profiler, it isn't copied by forkFrom() or snapshots.
+        const ExecutionTrace& getTrace() const;
+
+        /**
+         * @brief Serializes everything needed to resume this game: variables, the
+         * paused position in the program (including loop and match progress),
+         * the inputs it's waiting on, and the input manager's state.
+         *
+         * The program itself isn't included; a snapshot can only be restored
+         * into an interpreter built from the same rules.
+         */
+        std::vector<uint8_t> saveSnapshot() const;
+
+        /**
+         * @brief Replaces this interpreter's and its input manager's state with a
+         * snapshot from saveSnapshot, resuming at the same paused statement.
+         *
+         * Throws std::runtime_error, leaving the state untouched, if the snapshot
+         * is malformed, from another version, or doesn't fit this program.
+         */
+        void restoreSnapshot(std::span<const uint8_t> snapshot);
+
+        /**
+         * @brief Makes this interpreter a fork of `source`: the same game, paused
+         * at the same statement, played on from there independently.
+         *
+         * Variables, leaderboards and the input manager's requests, responses
+         * and votes are shared copy-on-write, so a fork costs about the same
+         * however much state the game holds; only the iterator stack and the
+         * queued requests and outputs are copied. Neither game sees what the
+         * other does afterwards. The step budget and profiler stay this
+         * interpreter's.
+         *
+         * Both must run the same SharedProgram, or std::runtime_error is thrown.
+         */
+        void forkFrom(const GameInterpreter& source);
+
+        const SharedProgram& getProgram() const;
+
+        /**
+         * @brief The error that stopped the program, if any.
+         *
+         * Runtime errors in the game (a missing variable, a type mismatch)
+         * are returned up through evaluation rather than thrown. The first
+         * one halts the program at the failed statement, and later execute()
+         * calls do nothing.
+         */
+        const std::optional<RuntimeError>& getError() const;
+
         bool needsIO() const;
 
         bool isDone() const;
 
     private:
-        Value
-        getPlayerAttribute(const ast::Variable& playerVar, String attr);
+        Result<String>
+        getPlayerID(const ast::Variable& playerVar);
+
+        Result<String>
+        getPlayerID(Value& player);
+
+        /// Tells the leaderboards variable `name` now holds `value`, which
+        /// may be a player or a list of them
+        void trackScores(const Name& name, const Value& value);
+
+        /// Tells the leaderboards variable `name` no longer holds anything
+        void untrackScores(const Name& name);
+
+        VisitResult
+        assignInput(ast::Expression* targetExpr, Value input);
+
+        /// A vote among a list of players, tallied as the votes arrive;
+        /// the winning choice is assigned once it's certain
+        VisitResult
+        doGroupVote(List<Value>& players, ast::Expression* targetExpr, String prompt, const List<Value>& choices);
 
         void
         doVariableAssignment(ast::Variable& varTarget, Value valueToAssign);
 
-        void
+        VisitResult
         doAttributeAssignment(ast::Attribute& attrTarget, Value valueToAssign);
 
-        Value
-        callSizeBuiltin(const ast::Callable& callable);
+        // The operators and builtins once their operands are evaluated,
+        // shared by the visit() overloads and evaluateFlat(). The flags say
+        // the operands' static types allow the unchecked fast path.
+
+        VisitResult
+        applyComparison(ast::Comparison::Kind kind, const Value& left, const Value& right, bool integers);
 
-        Value
-        callUpFromBuiltin(const ast::Callable& callable);
+        VisitResult
+        applyLogicalOperation(ast::LogicalOperation::Kind kind, const Value& left, const Value& right, bool booleans);
+
+        VisitResult
+        applyUnaryOperation(ast::UnaryOperation::Kind kind, const Value& target, bool boolean);
+
+        VisitResult
+        applyArithmeticOperation(ast::ArithmeticOperation::Kind kind, const Value& left, const Value& right, bool integers);
+
+        VisitResult
+        applySize(const Value& list, bool isList);
+
+        VisitResult
+        applyUpFrom(const Value& from, const Value& to);
+
+        /// Any builtin, given its evaluated target and builtinArity() args
+        VisitResult
+        applyBuiltin(ast::Callable::Kind kind, const Value& target, ValueType targetType,
+                     std::span<const Value* const> args);
+
+        /// Evaluates the flattened expression at `index`, like visiting its tree
+        VisitResult
+        evaluateFlat(const ast::FlatExpressions& flat, uint32_t index);
+
+        /// A reference to the variable, copied out of any fork first if
+        /// it's being resolved to be changed
+        VisitResult
+        lookupVariable(const Name& name);
 
         void
         deleteVariable(ast::Variable& variable);
 
+        /// False if the program gives `name` values of another type than `value`'s
+        bool
+        fitsVariableType(const Name& name, const Value& value) const;
+
         VisitResult
         evaluateExpression(ast::Expression& expr);
 
+        /// A reference to the value `expr` names, to be changed: a value
+        /// shared with a forked game is copied first
         VisitResult
         resolveExpression(ast::Expression& expr);
 
+        /// Like resolveExpression(), for reading when not already resolving
+        VisitResult
+        referenceExpression(ast::Expression& expr);
+
+        /// Evaluates `expr` and checks that it's a T
+        template <typename T>
+        Result<T>
+        evaluateAs(ast::Expression& expr);
+
+        Result<List<Value>*>
+        resolveList(ast::Expression& expr);
+
         Boolean
         isEqual(const Value& a, const Value& b);
 
-        Boolean
+        Result<Boolean>
         isLessThan(const Value& left, const Value& right);
 
-        std::optional<ast::Match::CandidateRaw>
+        Result<std::optional<size_t>>
         findMatch(const ast::Match& match);
 
+        void
+        saveIterator(SnapshotWriter& writer, const ProgramIterator& iterator) const;
+
+        void
+        restoreIterator(SnapshotReader& reader, ProgramIterator& iterator);
+
+        void
+        cloneIterator(const ProgramIterator& source, ProgramIterator& iterator);
+
+        /// Parks the program on the request, until hasAnyResponse() finds
+        /// its response by ID
+        void waitForInput(String playerID, String prompt, RequestID requestID);
+
+        /// The ID of the request the program was parked on for `playerID`
+        /// and `prompt` when it resumed, or that was prefetched for it, or
+        /// NO_REQUEST_ID. Input statements pass it to the InputManager, so
+        /// their requests are only ever looked up by ID.
+        RequestID takeResumedRequestID(const String& playerID, const String& prompt);
+
+        bool isBlocked() const;
+
+        bool shouldPause() const;
+
+#ifdef GAMEENGINE_PROFILING
+        Profiler::Scope profileNode(ast::NodeKind kind)
+        {
+            return Profiler::Scope{m_profiler ? &m_profiler->getNodeStats(kind) : nullptr};
+        }
+
+        Profiler::Scope profileStatement(const ast::Statement& statement)
+        {
+            return Profiler::Scope{
+                m_profiler ? &m_profiler->getStatementStats(statement.getLocation()) : nullptr
+            };
+        }
+#else
+        // Not even the profiler check is left in
+        Profiler::Scope profileNode(ast::NodeKind) { return Profiler::Scope{nullptr}; }
+        Profiler::Scope profileStatement(const ast::Statement&) { return Profiler::Scope{nullptr}; }
+#endif
+
+        bool takeStep();
+
+        bool hasAnyResponse(const std::vector<InputWaitKey>& keys) const;
+
+        void prefetchInputs(const ProgramIterator& iterator);
+
+        Result<GameMessage> makeInputRequest(const ast::InputRequestSpec& input);
+
+        /// The interned set of `choices`, interned again only when they
+        /// differ from what `statement` offered last
+        ChoiceSet getChoiceSet(const ast::Statement& statement, const List<Value>& choices);
+
+        Result<List<Value>> evaluateLoopTarget(ast::Expression& target);
+
         void executeProgram(ProgramIterator& iterator);
 
         void assertCurrentIterator();
@@ -403,6 +807,9 @@ class GameInterpreter : public ast::ASTVisitor
         std::optional<ProgramIterator::MatchExecutionContext*>
         getCurrentMatchExecutionContext();
 
+        std::optional<ProgramIterator::ParallelForExecutionContext*>
+        getCurrentParallelForExecutionContext();
+
         void
         setCurrentStatementContext(ProgramIterator::StatementContext ctx);
 
@@ -410,9 +817,33 @@ class GameInterpreter : public ast::ASTVisitor
         VariableMap m_variableMap;
 
         InputManager& m_inputManager;
-        bool m_waitingForInput = false;
-
-        std::optional<Program> m_program;
+        std::vector<InputWaitKey> m_waitKeys; // inputs the program is parked on, if any
+        std::vector<InputWaitKey> m_resumedKeys; // what it was parked on, for the statements it resumes
+        std::vector<InputWaitKey> m_prefetchedKeys; // requests sent ahead, for the statements they're for
+        std::vector<Name>* m_createdNames = nullptr; // variables the running parallel for iteration made
+
+        std::optional<size_t> m_stepBudget;
+        size_t m_stepsRemaining = 0;
+        bool m_preempted = false; // set when the step budget runs out mid-program
+        std::optional<RuntimeError> m_error; // set when a statement fails
+        std::string m_messageBuffer; // reused to render each message
+        // One per attribute list a scores statement has shown, kept current from then on
+        CopyOnWrite<std::vector<Leaderboard>> m_leaderboards;
+        ExecutionStats m_stats;
+        Profiler* m_profiler = nullptr;
+        ExecutionTrace m_trace;
+
+        // Inputs that can be requested while the keyed input statement waits
+        std::unordered_map<const ast::Statement*, std::vector<ast::InputRequestSpec>> m_prefetchRuns;
+        // The choices each choice or vote statement offered last
+        std::unordered_map<const ast::Statement*, ChoiceSet> m_choiceSets;
+
+        SharedProgram m_program;
+        bool m_verified; // the program's structure was checked when it was compiled
+        bool m_resolving = false; // variables are looked up to be changed, see resolveExpression()
+        const ast::FlatExpressions* m_flat; // the program's, evaluated instead of its expression trees
+        ProgramRaw m_programRaw; // what m_iterator walks
+        FramePool m_framePool; // declared before every frame's owner, so it's destroyed after them
         std::unique_ptr<ProgramIterator> m_iterator;
         ProgramIterator* m_currentIterator;
 };
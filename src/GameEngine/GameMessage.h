@@ -1,26 +1,38 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include "ChoiceSet.h"
+
 #include "Types.h"
 
 // Should these use our types? Might not make sense outside the interpreter layer
 //--> let's use String
 
+/// Issued by the InputManager for each input request and echoed back by its
+/// response, so the two are matched by index instead of by prompt text.
+using RequestID = uint32_t;
+
+/// A response without an ID is matched to its request by player and prompt
+inline constexpr RequestID NO_REQUEST_ID = 0;
+
 //Request Messages (Server->Player)
 struct GetChoiceInputMessage
 {
     String playerID;
     String prompt;
-    List<Value> choices;
+    ChoiceSet choices; // shared with every request offering the same ones
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct GetTextInputMessage
 {
     String playerID;
     String prompt;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct GetRangeInputMessage
@@ -29,13 +41,15 @@ struct GetRangeInputMessage
     String prompt;
     Integer minValue;
     Integer maxValue;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct GetVoteInputMessage
 {
     String playerID;
     String prompt;
-    List<Value> choices;
+    ChoiceSet choices; // shared with every request offering the same ones
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 
@@ -45,6 +59,7 @@ struct ChoiceInputMessage
     String playerID;
     String prompt;
     String choice;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct TextInputMessage
@@ -52,6 +67,7 @@ struct TextInputMessage
     String playerID;
     String prompt;
     String input;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct RangeInputMessage
@@ -59,6 +75,7 @@ struct RangeInputMessage
     String playerID;
     String prompt;
     Integer value;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 struct VoteInputMessage
@@ -66,6 +83,7 @@ struct VoteInputMessage
     String playerID;
     String prompt;
     String vote;
+    RequestID requestID = NO_REQUEST_ID;
 };
 
 
@@ -1,102 +1,305 @@
 #include "InputManager.h"
+#include <algorithm>
+#include <charconv>
+#include <ranges>
 #include <stdexcept>
-#include <sstream>
 
 // TODO: Clean up clearing input
 
 std::optional<String>
-InputManager::getTextInput(String playerID, String prompt)
+InputManager::getTextInput(String playerID, String prompt, RequestID& requestID)
 {
-    auto response = popResponse(playerID, prompt);
+    auto response = popResponse(playerID, prompt, requestID);
     if (response) {
         return response;
     }
 
-    if (!hasRequestedInput(playerID, prompt)) {
-        addPendingRequest(GameMessage{GetTextInputMessage{playerID, prompt}});
+    if (requestID == NO_REQUEST_ID) {
+        requestID = issueRequest(GameMessage{GetTextInputMessage{playerID, prompt}});
     }
 
     return std::nullopt;
 }
 
 std::optional<String>
-InputManager::getChoiceInput(String playerID, String prompt, const List<Value>& choices)
+InputManager::getChoiceInput(String playerID, String prompt, const ChoiceSet& choices, RequestID& requestID)
 {
-    auto response = popResponse(playerID, prompt);
+    auto response = popResponse(playerID, prompt, requestID);
     if (response) {
         return response;
     }
 
-    if (!hasRequestedInput(playerID, prompt)) {
-        addPendingRequest(GameMessage{GetChoiceInputMessage{playerID, prompt, choices}});
+    if (requestID == NO_REQUEST_ID) {
+        requestID = issueRequest(GameMessage{GetChoiceInputMessage{playerID, prompt, choices}});
     }
 
     return std::nullopt;
 }
 
 std::optional<Integer>
-InputManager::getRangeInput(String playerID, String prompt, Integer minValue, Integer maxValue)
+InputManager::getRangeInput(String playerID, String prompt, Integer minValue, Integer maxValue, RequestID& requestID)
 {
-    auto response = popResponse(playerID, prompt);
+    auto response = popResponse(playerID, prompt, requestID);
     if (response) {
-        try {
-            Integer value = Integer{std::stoi(response->value)};
-            if (value < minValue || maxValue < value) {
-                std::ostringstream oss;
-                oss << "Range input " << value
-                    << " is outside valid range (" << minValue << ", " << maxValue << ")";
-                throw std::runtime_error(oss.str());
-            }
-            return value;
-        } catch (const std::invalid_argument&) {
-            throw std::runtime_error("Invalid range input, enter a number");
+        const std::string& text = response->value;
+        int value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+        bool isValid = error == std::errc{} && end == text.data() + text.size()
+                       && minValue.value <= value && value <= maxValue.value;
+        if (isValid) {
+            return Integer{value};
         }
+
+        // Not a number in range, so ask again. Routine for user input, so
+        // it's handled like a response that hasn't arrived yet.
     }
 
-    if (!hasRequestedInput(playerID, prompt)) {
-        addPendingRequest(GameMessage{GetRangeInputMessage{playerID, prompt, minValue, maxValue}});
+    if (requestID == NO_REQUEST_ID) {
+        requestID = issueRequest(GameMessage{GetRangeInputMessage{playerID, prompt, minValue, maxValue}});
     }
 
     return std::nullopt;
 }
 
 std::optional<String>
-InputManager::getVoteInput(String playerID, String prompt, const List<Value>& choices)
+InputManager::getVoteInput(String playerID, String prompt, const ChoiceSet& choices, RequestID& requestID)
 {
-    auto response = popResponse(playerID, prompt);
+    auto response = popResponse(playerID, prompt, requestID);
     if (response) {
         return response;
     }
 
-    if (!hasRequestedInput(playerID, prompt)) {
-        addPendingRequest(GameMessage{GetVoteInputMessage{playerID, prompt, choices}});
+    if (requestID == NO_REQUEST_ID) {
+        requestID = issueRequest(GameMessage{GetVoteInputMessage{playerID, prompt, choices}});
     }
 
     return std::nullopt;
 }
 
+std::optional<String>
+InputManager::getTextInput(String playerID, String prompt)
+{
+    RequestID requestID = findRequestID(playerID, prompt);
+    return getTextInput(std::move(playerID), std::move(prompt), requestID);
+}
+
+std::optional<String>
+InputManager::getChoiceInput(String playerID, String prompt, const List<Value>& choices)
+{
+    RequestID requestID = findRequestID(playerID, prompt);
+    return getChoiceInput(std::move(playerID), std::move(prompt), ChoiceSet::intern(choices), requestID);
+}
+
+std::optional<Integer>
+InputManager::getRangeInput(String playerID, String prompt, Integer minValue, Integer maxValue)
+{
+    RequestID requestID = findRequestID(playerID, prompt);
+    return getRangeInput(std::move(playerID), std::move(prompt), minValue, maxValue, requestID);
+}
+
+std::optional<String>
+InputManager::getVoteInput(String playerID, String prompt, const List<Value>& choices)
+{
+    RequestID requestID = findRequestID(playerID, prompt);
+    return getVoteInput(std::move(playerID), std::move(prompt), ChoiceSet::intern(choices), requestID);
+}
+
+namespace {
+    std::vector<String> votableChoices(const List<Value>& choices) {
+        std::vector<String> names;
+        names.reserve(choices.value.size());
+        for (const auto& choice : choices.value) {
+            if (choice.isString()) {
+                names.push_back(choice.asString());
+            }
+        }
+        return names;
+    }
+}
+
+std::optional<VoteTally>
+InputManager::getGroupVote(const std::vector<String>& voterIDs, String prompt, const List<Value>& choices,
+                           RequestID& voteID)
+{
+    auto voteIt = m_groupVotes->find(voteID);
+    if (voteIt == m_groupVotes->end()) {
+        voteID = m_nextRequestID++;
+
+        // Every voter's request shares the one set of choices
+        ChoiceSet choiceSet = ChoiceSet::intern(choices);
+        std::vector<RequestID> ballots;
+        for (const auto& voterID : voterIDs) {
+            // A voter already asked, e.g. by a prefetch, gets that request
+            // as their ballot. Each voter gets one vote, in one vote.
+            RequestID ballotID = findRequestID(voterID, prompt);
+            if (ballotID == NO_REQUEST_ID) {
+                ballotID = issueRequest(GameMessage{GetVoteInputMessage{voterID, prompt, choiceSet}});
+            }
+            else if (m_issued->at(ballotID).voteID != NO_REQUEST_ID) {
+                continue;
+            }
+            m_issued.edit().at(ballotID).voteID = voteID;
+            ballots.push_back(ballotID);
+        }
+        GroupVote vote{std::move(prompt), VoteTally{votableChoices(choices), ballots.size()}, std::move(choiceSet),
+                       ballots};
+        voteIt = m_groupVotes.edit().emplace(voteID, std::move(vote)).first;
+
+        // Ballots that were answered before the vote opened count now
+        for (RequestID ballotID : ballots) {
+            if (const auto& response = m_issued->at(ballotID).response) {
+                countVote(ballotID, String{*response});
+            }
+        }
+        voteIt = m_groupVotes->find(voteID);
+    }
+
+    if (!voteIt->second.tally.isClosed()) {
+        return std::nullopt;
+    }
+
+    // Closed early: whoever hasn't voted yet no longer can
+    GroupVote vote = std::move(m_groupVotes.edit().extract(voteID).mapped());
+    for (RequestID ballotID : vote.ballots) {
+        forgetRequest(ballotID);
+    }
+    return std::move(vote.tally);
+}
+
+bool
+InputManager::hasResponse(const InputWaitKey& key) const
+{
+    if (key.playerID.value.empty()) {
+        auto voteIt = m_groupVotes->find(key.requestID);
+        return voteIt != m_groupVotes->end() && voteIt->second.tally.isClosed();
+    }
+    if (key.requestID != NO_REQUEST_ID) {
+        auto issuedIt = m_issued->find(key.requestID);
+        return issuedIt != m_issued->end() && issuedIt->second.response;
+    }
+
+    if (auto issuedIt = m_issued->find(findRequestID(key.playerID, key.prompt)); issuedIt != m_issued->end()) {
+        return issuedIt->second.response.has_value();
+    }
+
+    auto playerIt = m_responses->find(key.playerID);
+    if (playerIt == m_responses->end()) {
+        return false;
+    }
+    return playerIt->second.contains(key.prompt);
+}
+
+RequestID
+InputManager::findRequestID(const String& playerID, const String& prompt) const
+{
+    const RequestID* asked = findAsked(playerID, prompt);
+    return asked ? *asked : NO_REQUEST_ID;
+}
+
+const RequestID*
+InputManager::findAsked(const String& playerID, const String& prompt) const
+{
+    auto playerIt = m_requestIDs->find(playerID);
+    if (playerIt == m_requestIDs->end()) {
+        return nullptr;
+    }
+    auto promptIt = playerIt->second.find(prompt);
+    return promptIt == playerIt->second.end() ? nullptr : &promptIt->second;
+}
+
+RequestID
+InputManager::prefetchRequest(GameMessage request)
+{
+    InputWaitKey key = getRequestKey(request);
+    if (hasResponse(key) || hasRequestedInput(key.playerID, key.prompt)) {
+        return NO_REQUEST_ID;
+    }
+    return issueRequest(std::move(request));
+}
+
 void
 InputManager::handleIncomingMessages(const std::vector<GameMessage>& messages)
 {
     for (const auto& msg : messages) {
         if (const auto* textInput = std::get_if<TextInputMessage>(&msg.inner)) {
-            m_responses[textInput->playerID][textInput->prompt] = textInput->input;
+            storeResponse(textInput->playerID, textInput->prompt, textInput->requestID, textInput->input);
         }
         else if (const auto* choiceInput = std::get_if<ChoiceInputMessage>(&msg.inner)) {
-            m_responses[choiceInput->playerID][choiceInput->prompt] = choiceInput->choice;
+            storeResponse(choiceInput->playerID, choiceInput->prompt, choiceInput->requestID, choiceInput->choice);
         }
         else if (const auto* rangeInput = std::get_if<RangeInputMessage>(&msg.inner)) {
-            m_responses[rangeInput->playerID][rangeInput->prompt] =
-                String{std::to_string(rangeInput->value.value)};
+            storeResponse(rangeInput->playerID, rangeInput->prompt, rangeInput->requestID,
+                          String{std::to_string(rangeInput->value.value)});
         }
         else if (const auto* voteInput = std::get_if<VoteInputMessage>(&msg.inner)) {
-            m_responses[voteInput->playerID][voteInput->prompt] = voteInput->vote;
+            // A ballot in a group vote is counted right away
+            RequestID requestID = voteInput->requestID;
+            if (requestID == NO_REQUEST_ID) {
+                requestID = findRequestID(voteInput->playerID, voteInput->prompt);
+            }
+            const IssuedRequest* issued = findIssued(requestID);
+            if (issued && issued->voteID != NO_REQUEST_ID && issued->playerID == voteInput->playerID) {
+                countVote(requestID, voteInput->vote);
+            }
+            else if (voteInput->requestID == NO_REQUEST_ID && isVotePrompt(voteInput->prompt)) {
+                continue; // a repeat, or from someone who wasn't asked
+            }
+            else {
+                storeResponse(voteInput->playerID, voteInput->prompt, voteInput->requestID, voteInput->vote);
+            }
+        }
+    }
+}
+
+void
+InputManager::storeResponse(const String& playerID, const String& prompt, RequestID requestID, String response)
+{
+    if (requestID == NO_REQUEST_ID) {
+        const RequestID* asked = findAsked(playerID, prompt);
+        if (asked && *asked == NO_REQUEST_ID) {
+            return; // asked before and closed, so it's late or a repeat
         }
+        requestID = asked ? *asked : NO_REQUEST_ID;
     }
+    else if (IssuedRequest* issued = findIssued(requestID); !issued || issued->playerID != playerID) {
+        return; // consumed, expired, never issued, or someone else's
+    }
+
+    if (requestID != NO_REQUEST_ID) {
+        // Only the first response answers the request, repeats are dropped
+        IssuedRequest& issued = *findIssued(requestID);
+        if (!issued.response) {
+            issued.response = std::move(response);
+        }
+        return;
+    }
+
+    // Not asked yet, so it waits for the request, within a limit
+    auto& responses = m_responses.edit()[playerID];
+    if (responses.size() < MAX_UNSOLICITED_RESPONSES || responses.contains(prompt)) {
+        responses[prompt] = std::move(response);
+    }
+}
+
+InputManager::IssuedRequest*
+InputManager::findIssued(RequestID requestID)
+{
+    if (!m_issued->contains(requestID)) {
+        return nullptr;
+    }
+    // The caller may change it, so it can't stay shared with a fork
+    return &m_issued.edit().at(requestID);
+}
+
+bool
+InputManager::hasPendingRequests() const
+{
+    return !m_pendingRequests.empty();
 }
 
-std::vector<GameMessage>
-InputManager::getPendingRequests()
+const std::vector<GameMessage>&
+InputManager::getPendingRequests() const
 {
     return m_pendingRequests;
 }
@@ -107,23 +310,273 @@ InputManager::clearPendingRequests()
     m_pendingRequests.clear();
 }
 
+void
+InputManager::drainPendingRequests(std::vector<GameMessage>& out)
+{
+    out.clear();
+    std::swap(out, m_pendingRequests);
+}
+
 void
 InputManager::sendOutput(const String &message) {
-    m_pendingOutputs.push_back(message.value);
+    m_pendingOutputs.push_back(GameOutput{message.value, {}});
 }
 
-std::vector<std::string>
+void
+InputManager::sendOutput(std::string_view message, std::vector<String> playerIDs) {
+    m_pendingOutputs.push_back(GameOutput{std::string{message}, std::move(playerIDs)});
+}
+
+std::vector<GameOutput>
 InputManager::popPendingOutputs() {
-    std::vector<std::string> out = std::move(m_pendingOutputs);
+    std::vector<GameOutput> out = std::move(m_pendingOutputs);
     m_pendingOutputs.clear();
     return out;
 }
 
+namespace {
+    enum class RequestTag : uint8_t { TEXT, CHOICE, RANGE, VOTE };
+
+    void writeChoices(SnapshotWriter& writer, const List<Value>& choices) {
+        writer.writeUInt(choices.value.size());
+        for (const auto& choice : choices.value) {
+            writer.writeValue(choice);
+        }
+    }
+
+    List<Value> readChoices(SnapshotReader& reader) {
+        List<Value> choices;
+        size_t size = reader.readCount();
+        for (size_t i = 0; i < size; ++i) {
+            choices.value.push_back(reader.readValue());
+        }
+        return choices;
+    }
+}
+
+void
+InputManager::saveSnapshot(SnapshotWriter& writer) const
+{
+    writer.writeUInt(m_responses->size());
+    for (const auto& [playerID, responses] : *m_responses) {
+        writer.writeString(playerID.value);
+        writer.writeUInt(responses.size());
+        for (const auto& [prompt, response] : responses) {
+            writer.writeString(prompt.value);
+            writer.writeString(response.value);
+        }
+    }
+
+    writer.writeUInt(m_pendingRequests.size());
+    for (const auto& request : m_pendingRequests) {
+        InputWaitKey key = getRequestKey(request);
+        writer.writeUInt(key.requestID);
+        if (const auto* choiceReq = std::get_if<GetChoiceInputMessage>(&request.inner)) {
+            writer.writeUInt(static_cast<uint8_t>(RequestTag::CHOICE));
+            writer.writeString(key.playerID.value);
+            writer.writeString(key.prompt.value);
+            writeChoices(writer, *choiceReq->choices);
+        }
+        else if (const auto* rangeReq = std::get_if<GetRangeInputMessage>(&request.inner)) {
+            writer.writeUInt(static_cast<uint8_t>(RequestTag::RANGE));
+            writer.writeString(key.playerID.value);
+            writer.writeString(key.prompt.value);
+            writer.writeInt(rangeReq->minValue.value);
+            writer.writeInt(rangeReq->maxValue.value);
+        }
+        else if (const auto* voteReq = std::get_if<GetVoteInputMessage>(&request.inner)) {
+            writer.writeUInt(static_cast<uint8_t>(RequestTag::VOTE));
+            writer.writeString(key.playerID.value);
+            writer.writeString(key.prompt.value);
+            writeChoices(writer, *voteReq->choices);
+        }
+        else {
+            writer.writeUInt(static_cast<uint8_t>(RequestTag::TEXT));
+            writer.writeString(key.playerID.value);
+            writer.writeString(key.prompt.value);
+        }
+    }
+
+    writer.writeUInt(m_nextRequestID);
+    writer.writeUInt(m_issued->size());
+    for (const auto& [requestID, issued] : *m_issued) {
+        writer.writeUInt(requestID);
+        writer.writeString(issued.playerID.value);
+        writer.writeString(issued.prompt.value);
+        writer.writeBool(issued.response.has_value());
+        if (issued.response) {
+            writer.writeString(issued.response->value);
+        }
+    }
+
+    size_t closedCount = 0;
+    for (const auto& [playerID, prompts] : *m_requestIDs) {
+        closedCount += std::ranges::count(prompts | std::views::values, NO_REQUEST_ID);
+    }
+    writer.writeUInt(closedCount);
+    for (const auto& [playerID, prompts] : *m_requestIDs) {
+        for (const auto& [prompt, requestID] : prompts) {
+            if (requestID == NO_REQUEST_ID) {
+                writer.writeString(playerID.value);
+                writer.writeString(prompt.value);
+            }
+        }
+    }
+
+    writer.writeUInt(m_pendingOutputs.size());
+    for (const auto& output : m_pendingOutputs) {
+        writer.writeString(output.text);
+        writer.writeUInt(output.playerIDs.size());
+        for (const auto& playerID : output.playerIDs) {
+            writer.writeString(playerID.value);
+        }
+    }
+
+    writer.writeUInt(m_groupVotes->size());
+    for (const auto& [voteID, vote] : *m_groupVotes) {
+        writer.writeUInt(voteID);
+        writer.writeString(vote.prompt.value);
+        writeChoices(writer, *vote.choices);
+        writer.writeUInt(vote.tally.getVotesCast() + vote.tally.getVotesRemaining());
+        for (const auto& choice : vote.tally.getChoices()) {
+            writer.writeUInt(vote.tally.getCount(choice));
+        }
+        writer.writeUInt(vote.ballots.size());
+        for (RequestID ballotID : vote.ballots) {
+            writer.writeUInt(ballotID);
+        }
+    }
+}
+
+void
+InputManager::restoreSnapshot(SnapshotReader& reader)
+{
+    InputManager restored;
+
+    size_t playerCount = reader.readCount();
+    for (size_t i = 0; i < playerCount; ++i) {
+        auto& responses = restored.m_responses.edit()[String{reader.readString()}];
+        size_t responseCount = reader.readCount();
+        for (size_t j = 0; j < responseCount; ++j) {
+            String prompt{reader.readString()};
+            responses[std::move(prompt)] = String{reader.readString()};
+        }
+    }
+
+    size_t requestCount = reader.readCount();
+    for (size_t i = 0; i < requestCount; ++i) {
+        auto requestID = static_cast<RequestID>(reader.readUInt());
+        auto tag = static_cast<RequestTag>(reader.readUInt());
+        String playerID{reader.readString()};
+        String prompt{reader.readString()};
+
+        switch (tag) {
+            case RequestTag::TEXT:
+                restored.m_pendingRequests.push_back(GameMessage{GetTextInputMessage{playerID, prompt}});
+                break;
+            case RequestTag::CHOICE:
+                restored.m_pendingRequests.push_back(
+                    GameMessage{GetChoiceInputMessage{playerID, prompt, ChoiceSet::intern(readChoices(reader))}});
+                break;
+            case RequestTag::RANGE: {
+                Integer minValue{static_cast<int>(reader.readInt())};
+                Integer maxValue{static_cast<int>(reader.readInt())};
+                restored.m_pendingRequests.push_back(
+                    GameMessage{GetRangeInputMessage{playerID, prompt, minValue, maxValue}});
+                break;
+            }
+            case RequestTag::VOTE:
+                restored.m_pendingRequests.push_back(
+                    GameMessage{GetVoteInputMessage{playerID, prompt, ChoiceSet::intern(readChoices(reader))}});
+                break;
+            default:
+                throw std::runtime_error("Snapshot has an unknown input request type");
+        }
+        std::visit([requestID](auto& request) { request.requestID = requestID; },
+                   restored.m_pendingRequests.back().inner);
+    }
+
+    restored.m_nextRequestID = static_cast<RequestID>(reader.readUInt());
+    size_t issuedCount = reader.readCount();
+    for (size_t i = 0; i < issuedCount; ++i) {
+        auto requestID = static_cast<RequestID>(reader.readUInt());
+        IssuedRequest& issued = restored.m_issued.edit()[requestID];
+        issued.playerID = String{reader.readString()};
+        issued.prompt = String{reader.readString()};
+        if (reader.readBool()) {
+            issued.response = String{reader.readString()};
+        }
+        restored.m_requestIDs.edit()[issued.playerID][issued.prompt] = requestID;
+    }
+
+    size_t closedCount = reader.readCount();
+    for (size_t i = 0; i < closedCount; ++i) {
+        String playerID{reader.readString()};
+        restored.m_requestIDs.edit()[std::move(playerID)].try_emplace(String{reader.readString()}, NO_REQUEST_ID);
+    }
+
+    size_t outputCount = reader.readCount();
+    for (size_t i = 0; i < outputCount; ++i) {
+        GameOutput& output = restored.m_pendingOutputs.emplace_back();
+        output.text = reader.readString();
+        size_t recipientCount = reader.readCount();
+        for (size_t j = 0; j < recipientCount; ++j) {
+            output.playerIDs.push_back(String{reader.readString()});
+        }
+    }
+
+    size_t voteCount = reader.readCount();
+    for (size_t i = 0; i < voteCount; ++i) {
+        auto voteID = static_cast<RequestID>(reader.readUInt());
+        String prompt{reader.readString()};
+        List<Value> choices = readChoices(reader);
+        auto voterCount = static_cast<size_t>(reader.readUInt());
+
+        GroupVote vote{std::move(prompt), VoteTally{votableChoices(choices), voterCount}, ChoiceSet::intern(choices)};
+        for (const auto& choice : vote.tally.getChoices()) {
+            // Replaying the counts rebuilds the same leader and runner-up
+            auto votes = static_cast<size_t>(reader.readUInt());
+            for (size_t j = 0; j < votes; ++j) {
+                if (!vote.tally.cast(choice)) {
+                    throw std::runtime_error("Snapshot has more votes than voters");
+                }
+            }
+        }
+        size_t ballotCount = reader.readCount();
+        for (size_t j = 0; j < ballotCount; ++j) {
+            auto ballotID = static_cast<RequestID>(reader.readUInt());
+            if (IssuedRequest* ballot = restored.findIssued(ballotID)) {
+                ballot->voteID = voteID;
+            }
+            vote.ballots.push_back(ballotID);
+        }
+        restored.m_groupVotes.edit().emplace(voteID, std::move(vote));
+    }
+
+    *this = std::move(restored);
+}
+
 std::optional<String>
-InputManager::popResponse(const String& playerID, const String& prompt)
+InputManager::popResponse(const String& playerID, const String& prompt, RequestID& requestID)
 {
-    auto playerIt = m_responses.find(playerID);
-    if (playerIt == m_responses.end()) {
+    // Callers pass the ID they were given, so an open request is only
+    // ever found by it
+    if (IssuedRequest* issued = findIssued(requestID)) {
+        if (!issued->response) {
+            return std::nullopt;
+        }
+        std::optional<String> response = std::move(issued->response);
+        closeRequest(requestID); // consumed
+        requestID = NO_REQUEST_ID;
+        return response;
+    }
+    requestID = NO_REQUEST_ID;
+
+    if (m_responses->empty()) {
+        return std::nullopt;
+    }
+    auto playerIt = m_responses->find(playerID);
+    if (playerIt == m_responses->end()) {
         return std::nullopt;
     }
 
@@ -134,7 +587,7 @@ InputManager::popResponse(const String& playerID, const String& prompt)
 
     String val = promptIt->second;
 
-    playerIt->second.erase(promptIt);
+    m_responses.edit().at(playerID).erase(prompt);
 
     return val;
 }
@@ -142,28 +595,119 @@ InputManager::popResponse(const String& playerID, const String& prompt)
 bool
 InputManager::hasRequestedInput(const String& playerID, const String& prompt) const
 {
-    auto playerIt = m_sentRequests.find(playerID);
-    if (playerIt == m_sentRequests.end()) {
-        return false;
+    return findRequestID(playerID, prompt) != NO_REQUEST_ID;
+}
+
+void
+InputManager::forgetRequest(RequestID requestID)
+{
+    if (!m_issued->contains(requestID)) {
+        return;
+    }
+
+    // Expired, so it's no use sending it if it's still queued
+    std::erase_if(m_pendingRequests, [requestID](const GameMessage& request) {
+        return getRequestKey(request).requestID == requestID;
+    });
+    closeRequest(requestID);
+}
+
+void
+InputManager::closeRequest(RequestID requestID)
+{
+    if (!m_issued->contains(requestID)) {
+        return;
+    }
+    auto& issuedRequests = m_issued.edit();
+    auto issuedIt = issuedRequests.find(requestID);
+
+    // The prompt stays known as asked, so late responses to it are dropped.
+    // A newer request for it may have taken its place, and stays.
+    RequestID& asked = m_requestIDs.edit().at(issuedIt->second.playerID).at(issuedIt->second.prompt);
+    if (asked == requestID) {
+        asked = NO_REQUEST_ID;
     }
-    return playerIt->second.find(prompt) != playerIt->second.end();
+    issuedRequests.erase(issuedIt);
 }
 
 void
+InputManager::countVote(RequestID ballotID, const String& vote)
+{
+    // Only open ballots are counted. Each is forgotten once counted, so
+    // nothing per voter is kept.
+    IssuedRequest ballot = m_issued->at(ballotID);
+    forgetRequest(ballotID);
+
+    GroupVote& groupVote = m_groupVotes.edit().at(ballot.voteID);
+    if (!groupVote.tally.cast(vote)) {
+        // Not one of the choices, so ask again
+        RequestID againID = addPendingRequest(
+            GameMessage{GetVoteInputMessage{ballot.playerID, ballot.prompt, groupVote.choices}});
+        m_issued.edit().at(againID).voteID = ballot.voteID;
+        groupVote.ballots.push_back(againID);
+    }
+}
+
+bool
+InputManager::isVotePrompt(const String& prompt) const
+{
+    // Few votes are open at once, so a scan beats keeping an index
+    return std::ranges::any_of(*m_groupVotes, [&prompt](const auto& vote) { return vote.second.prompt == prompt; });
+}
+
+RequestID
 InputManager::addPendingRequest(GameMessage request)
+{
+    // Sending an open request again keeps its ID
+    InputWaitKey key = getRequestKey(request);
+    RequestID requestID = findRequestID(key.playerID, key.prompt);
+    if (requestID == NO_REQUEST_ID) {
+        return issueRequest(std::move(request));
+    }
+    std::visit([requestID](auto& message) { message.requestID = requestID; }, request.inner);
+
+    m_pendingRequests.push_back(std::move(request));
+    return requestID;
+}
+
+RequestID
+InputManager::issueRequest(GameMessage request)
+{
+    RequestID requestID = m_nextRequestID++;
+    InputWaitKey key = getRequestKey(request);
+
+    // A response that came before the prompt was asked expires with it
+    if (auto playerIt = m_responses->find(key.playerID);
+        playerIt != m_responses->end() && playerIt->second.contains(key.prompt)) {
+        auto& responses = m_responses.edit();
+        responses.at(key.playerID).erase(key.prompt);
+        if (responses.at(key.playerID).empty()) {
+            responses.erase(key.playerID);
+        }
+    }
+
+    m_issued.edit().emplace(requestID, IssuedRequest{key.playerID, key.prompt});
+    m_requestIDs.edit()[key.playerID][key.prompt] = requestID;
+    std::visit([requestID](auto& message) { message.requestID = requestID; }, request.inner);
+
+    m_pendingRequests.push_back(std::move(request));
+    return requestID;
+}
+
+InputWaitKey
+InputManager::getRequestKey(const GameMessage& request)
 {
     if (const auto* textReq = std::get_if<GetTextInputMessage>(&request.inner)) {
-        m_sentRequests[textReq->playerID].insert(textReq->prompt);
+        return {textReq->playerID, textReq->prompt, textReq->requestID};
     }
     else if (const auto* choiceReq = std::get_if<GetChoiceInputMessage>(&request.inner)) {
-        m_sentRequests[choiceReq->playerID].insert(choiceReq->prompt);
+        return {choiceReq->playerID, choiceReq->prompt, choiceReq->requestID};
     }
     else if (const auto* rangeReq = std::get_if<GetRangeInputMessage>(&request.inner)) {
-        m_sentRequests[rangeReq->playerID].insert(rangeReq->prompt);
+        return {rangeReq->playerID, rangeReq->prompt, rangeReq->requestID};
     }
     else if (const auto* voteReq = std::get_if<GetVoteInputMessage>(&request.inner)) {
-        m_sentRequests[voteReq->playerID].insert(voteReq->prompt);
+        return {voteReq->playerID, voteReq->prompt, voteReq->requestID};
     }
-
-    m_pendingRequests.push_back(std::move(request));
+    throw std::runtime_error("Not an input request message");
 }
@@ -1,39 +1,181 @@
 #pragma once
 
 #include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <variant>
 
 #include "Types.h"
+#include "CopyOnWrite.h"
 #include "GameMessage.h"
+#include "Snapshot.h"
+#include "VoteTally.h"
 
 
+/// Identifies the input an interpreter is parked on: the player that was
+/// asked and the prompt that the response must reference. An empty
+/// playerID stands for the group vote with ID requestID, see getGroupVote().
+/// The request's ID, if it has one, is checked instead of the strings.
+struct InputWaitKey
+{
+    String playerID;
+    String prompt;
+    RequestID requestID = NO_REQUEST_ID;
+};
+
+/// Text for players to read, e.g. from a message statement
+struct GameOutput
+{
+    std::string text;
+    std::vector<String> playerIDs; // who it's for; empty means everyone
+};
+
+
+/// Every input request goes through the same lifecycle: it's issued with a
+/// fresh ID, answered when its player's first response arrives, and
+/// consumed when the interpreter takes that response. A request that can no
+/// longer be answered, like a vote's once it has closed, expires instead.
+/// Consumed and expired requests are dropped right away, keeping only the
+/// fact that their prompt was asked. So memory is bounded by the open
+/// requests and the prompts each player was asked, the same prompt can be
+/// asked again with a new ID, and late or repeated responses are rejected,
+/// whether they carry the old ID or none. Copies share the requests,
+/// responses and votes until one side changes them.
 class InputManager {
 public:
+    /// Responses kept per player for prompts that haven't been asked yet
+    static constexpr size_t MAX_UNSOLICITED_RESPONSES = 64;
+
     InputManager() = default;
 
+    /// Each get*Input() returns the response to the open request `requestID`,
+    /// or asks `playerID` for `prompt` under a new ID if it isn't open. A
+    /// response that came without an ID before the prompt was asked is taken
+    /// instead. `requestID` is set to the request's ID while it's open, and
+    /// NO_REQUEST_ID once consumed.
+    std::optional<String> getTextInput(String playerID, String prompt, RequestID& requestID);
+    std::optional<String> getChoiceInput(String playerID, String prompt, const ChoiceSet& choices,
+                                         RequestID& requestID);
+    std::optional<Integer> getRangeInput(String playerID, String prompt, Integer minValue, Integer maxValue,
+                                         RequestID& requestID);
+    std::optional<String> getVoteInput(String playerID, String prompt, const ChoiceSet& choices,
+                                       RequestID& requestID);
+
+    /// The same, for callers that don't keep the request's ID, so the open
+    /// request is looked up by player and prompt
     std::optional<String> getTextInput(String playerID, String prompt);
     std::optional<String> getChoiceInput(String playerID, String prompt, const List<Value>& choices);
     std::optional<Integer> getRangeInput(String playerID, String prompt, Integer minValue, Integer maxValue);
     std::optional<String> getVoteInput(String playerID, String prompt, const List<Value>& choices);
 
+    /// Opens a vote on `prompt` among `voterIDs` if `voteID` isn't an open
+    /// vote's, asking each voter and setting `voteID` to the new vote's. A
+    /// voter's open request for `prompt` becomes their ballot, and is
+    /// counted right away if it was already answered.
+    /// Votes are counted as they arrive instead of being stored per player,
+    /// and the vote closes as soon as its winner is certain. Returns the
+    /// final tally once closed, and forgets the vote. Votes on the same
+    /// prompt are counted apart. Choices that aren't Strings can't be voted
+    /// for.
+    std::optional<VoteTally> getGroupVote(const std::vector<String>& voterIDs, String prompt, const List<Value>& choices,
+                                          RequestID& voteID);
+
+    /// True if a response for `key` has arrived and not been consumed yet.
+    /// A key with a request ID is looked up by it alone.
+    bool hasResponse(const InputWaitKey& key) const;
+
+    /// The ID of the open request sent to `playerID` for `prompt`, or
+    /// NO_REQUEST_ID if there isn't one
+    RequestID findRequestID(const String& playerID, const String& prompt) const;
+
+    /// Who `request` asks, for which prompt, and its ID if it has one
+    static InputWaitKey getRequestKey(const GameMessage& request);
+
+    /// Requests that were issued and not yet consumed or expired
+    size_t getOpenRequestCount() const { return m_issued->size(); }
+
+    /// Sends `request` ahead of the statement that will consume it, unless it
+    /// was already sent or answered, and returns its ID for that statement,
+    /// or NO_REQUEST_ID if it wasn't sent. Never consumes a response.
+    RequestID prefetchRequest(GameMessage request);
+
+    /// Stores responses for their requests. A response with a request ID
+    /// is matched to it directly and dropped unless it's from the player
+    /// that was asked and the request is still open and unanswered; one
+    /// without is matched by player and prompt, and dropped if that prompt
+    /// was asked before but has no open request. Responses to prompts that
+    /// weren't asked yet are kept for when they are, up to
+    /// MAX_UNSOLICITED_RESPONSES per player, and expire once it's asked.
     void handleIncomingMessages(const std::vector<GameMessage>& messages);
-    std::vector<GameMessage> getPendingRequests();
+    bool hasPendingRequests() const;
+    const std::vector<GameMessage>& getPendingRequests() const;
     void clearPendingRequests();
 
+    /// Moves all pending requests into `out`, replacing its contents.
+    /// The queue takes over `out`'s old storage, so a caller that drains
+    /// into the same vector every tick doesn't reallocate either buffer.
+    void drainPendingRequests(std::vector<GameMessage>& out);
+
+    /// Queues `message` once for everyone, however many players there are
     void sendOutput(const String& message);
-    std::vector<std::string> popPendingOutputs();
+    void sendOutput(std::string_view message, std::vector<String> playerIDs);
+    std::vector<GameOutput> popPendingOutputs();
+
+    /// Writes all requests, responses and outputs, see GameInterpreter::saveSnapshot
+    void saveSnapshot(SnapshotWriter& writer) const;
+    /// Replaces this manager's state with what saveSnapshot wrote
+    void restoreSnapshot(SnapshotReader& reader);
 
 private:
-    std::optional<String> popResponse(const String& playerID, const String& prompt);
+    /// Takes the response to the request, see getTextInput()
+    std::optional<String> popResponse(const String& playerID, const String& prompt, RequestID& requestID);
     bool hasRequestedInput(const String& playerID, const String& prompt) const;
-    void addPendingRequest(GameMessage request);
+    /// Queues `request`, issuing it if it isn't open yet, and returns its ID
+    RequestID addPendingRequest(GameMessage request);
+    /// Queues `request` under a new ID and returns it
+    RequestID issueRequest(GameMessage request);
+    /// Expires the request, if it's still open
+    void forgetRequest(RequestID requestID);
+    void closeRequest(RequestID requestID);
+    void countVote(RequestID ballotID, const String& vote);
+    bool isVotePrompt(const String& prompt) const;
+    /// Stores `response` for its request, matched by ID if it has one
+    void storeResponse(const String& playerID, const String& prompt, RequestID requestID, String response);
+
+    struct GroupVote
+    {
+        String prompt;
+        VoteTally tally;
+        ChoiceSet choices; // to ask again after an invalid vote
+        std::vector<RequestID> ballots; // the voters' requests, expired when the vote closes
+    };
+
+    /// An open request: issued, or answered once it has a response
+    struct IssuedRequest
+    {
+        String playerID;
+        String prompt;
+        std::optional<String> response; // arrived, not consumed yet
+        RequestID voteID = NO_REQUEST_ID; // the group vote this is a ballot in, if any
+    };
+
+    IssuedRequest* findIssued(RequestID requestID);
+    /// The entry for `playerID`'s `prompt` in m_requestIDs, null if it was never asked
+    const RequestID* findAsked(const String& playerID, const String& prompt) const;
 
 private:
-    std::unordered_map<String, std::unordered_map<String, String>> m_responses;
+    // Responses that came without a request ID before their prompt was asked
+    CopyOnWrite<std::unordered_map<String, std::unordered_map<String, String>>> m_responses;
     std::vector<GameMessage> m_pendingRequests;
-    std::unordered_map<String, std::unordered_set<String>> m_sentRequests;
-    std::vector<std::string> m_pendingOutputs;
+    CopyOnWrite<std::unordered_map<RequestID, IssuedRequest>> m_issued; // the open requests
+    RequestID m_nextRequestID = NO_REQUEST_ID + 1; // IDs are never reused
+    // The open requests' IDs by player and prompt, only for callers and
+    // responses that come without one. Prompts asked before that have no
+    // open request map to NO_REQUEST_ID.
+    CopyOnWrite<std::unordered_map<String, std::unordered_map<String, RequestID>>> m_requestIDs;
+    std::vector<GameOutput> m_pendingOutputs;
+    CopyOnWrite<std::unordered_map<RequestID, GroupVote>> m_groupVotes; // open votes by ID
 };
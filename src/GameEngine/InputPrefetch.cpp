@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <string>
+
+#include "InputPrefetch.h"
+
+
+namespace
+{
+    // A variable followed by the attributes read off it,
+    // e.g. `player.id` is {"player", "id"}
+    using AccessPath = std::vector<std::string>;
+
+    std::optional<AccessPath>
+    getAccessPath(ast::Expression* expr)
+    {
+        if (auto variable = ast::castExpressionToVariable(expr))
+        {
+            return AccessPath{variable->getName().name};
+        }
+        if (auto attribute = ast::castExpressionToAttribute(expr))
+        {
+            auto path = getAccessPath(attribute->getBase());
+            if (path)
+            {
+                path->push_back(attribute->getAttr().value);
+            }
+            return path;
+        }
+        return std::nullopt;
+    }
+
+    // Collects every access path `expr` reads. Returns false if `expr`
+    // contains something this analysis doesn't understand.
+    bool
+    collectReads(ast::Expression* expr, std::vector<AccessPath>& reads)
+    {
+        if (auto path = getAccessPath(expr))
+        {
+            reads.push_back(std::move(*path));
+            return true;
+        }
+        if (ast::castExpressionToConstant(expr))
+        {
+            return true;
+        }
+        if (auto attribute = ast::castExpressionToAttribute(expr))
+        {
+            return collectReads(attribute->getBase(), reads);
+        }
+        if (auto comparison = dynamic_cast<ast::Comparison*>(expr))
+        {
+            return collectReads(comparison->getLeft(), reads)
+                && collectReads(comparison->getRight(), reads);
+        }
+        if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+        {
+            return collectReads(logicalOp->getLeft(), reads)
+                && collectReads(logicalOp->getRight(), reads);
+        }
+        if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+        {
+            return collectReads(arithmeticOp->getLeft(), reads)
+                && collectReads(arithmeticOp->getRight(), reads);
+        }
+        if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+        {
+            return collectReads(unaryOp->getTarget(), reads);
+        }
+        if (auto callable = dynamic_cast<ast::Callable*>(expr))
+        {
+            auto args = callable->getArgs();
+            return collectReads(callable->getLeft(), reads)
+                && std::ranges::all_of(args, [&reads](ast::Expression* arg) {
+                       return collectReads(arg, reads);
+                   });
+        }
+        return false;
+    }
+
+    // Writing to a path changes everything below it, and the value of
+    // everything above it
+    bool
+    overlaps(const AccessPath& left, const AccessPath& right)
+    {
+        size_t common = std::min(left.size(), right.size());
+        return std::equal(left.begin(), left.begin() + common, right.begin());
+    }
+}
+
+
+std::optional<ast::InputRequestSpec>
+ast::describeInput(ast::Statement* statement)
+{
+    using Kind = InputRequestSpec::Kind;
+
+    if (auto input = dynamic_cast<ast::InputText*>(statement))
+    {
+        return InputRequestSpec{
+            Kind::TEXT, input->getPlayer(), input->getTarget(), input->getPrompt(), {}, statement
+        };
+    }
+    if (auto input = dynamic_cast<ast::InputChoice*>(statement))
+    {
+        return InputRequestSpec{
+            Kind::CHOICE, input->getPlayer(), input->getTarget(), input->getPrompt(),
+            {input->getChoices()}, statement
+        };
+    }
+    if (auto input = dynamic_cast<ast::InputRange*>(statement))
+    {
+        return InputRequestSpec{
+            Kind::RANGE, input->getPlayer(), input->getTarget(), input->getPrompt(),
+            {input->getMinValue(), input->getMaxValue()}, statement
+        };
+    }
+    if (auto input = dynamic_cast<ast::InputVote*>(statement))
+    {
+        return InputRequestSpec{
+            Kind::VOTE, input->getPlayer(), input->getTarget(), input->getPrompt(),
+            {input->getChoices()}, statement
+        };
+    }
+    return std::nullopt;
+}
+
+std::vector<ast::InputRequestSpec>
+ast::findPrefetchableInputs(std::span<ast::Statement* const> statements)
+{
+    std::vector<InputRequestSpec> prefetchable;
+    if (statements.empty())
+    {
+        return prefetchable;
+    }
+
+    auto first = describeInput(statements.front());
+    auto firstWrite = first ? getAccessPath(first->target) : std::nullopt;
+    if (!firstWrite)
+    {
+        return prefetchable;
+    }
+    std::vector<AccessPath> writes{std::move(*firstWrite)};
+
+    for (ast::Statement* statement : statements.subspan(1))
+    {
+        auto input = describeInput(statement);
+        if (!input)
+        {
+            break;
+        }
+
+        std::vector<AccessPath> reads{
+            AccessPath{input->player->getName().name, "id"}
+        };
+        bool analyzable = std::ranges::all_of(input->operands, [&reads](ast::Expression* operand) {
+            return collectReads(operand, reads);
+        });
+        auto write = getAccessPath(input->target);
+        if (!analyzable || !write)
+        {
+            break;
+        }
+
+        bool dependent = std::ranges::any_of(reads, [&writes](const AccessPath& read) {
+            return std::ranges::any_of(writes, [&read](const AccessPath& written) {
+                return overlaps(read, written);
+            });
+        });
+        if (dependent)
+        {
+            break;
+        }
+
+        writes.push_back(std::move(*write));
+        prefetchable.push_back(std::move(*input));
+    }
+
+    return prefetchable;
+}
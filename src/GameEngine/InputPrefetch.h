@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Rules.h"
+
+
+namespace ast
+{
+    /**
+     * The parts of an input statement needed to issue its request,
+     * independent of which kind of input it is.
+     */
+    struct InputRequestSpec
+    {
+        enum class Kind { TEXT, CHOICE, RANGE, VOTE };
+
+        Kind kind;
+        Variable* player;
+        Expression* target;
+        String prompt;
+        std::vector<Expression*> operands; // choices, or min and max for RANGE
+        Statement* statement = nullptr; // the input statement itself
+    };
+
+    /**
+     * @brief Describes `statement` if it is an input statement.
+     */
+    std::optional<InputRequestSpec>
+    describeInput(Statement* statement);
+
+    /**
+     * @brief Finds the input statements that can be requested while the input
+     * statement at the front of `statements` is still waiting on its response.
+     *
+     * Walks the consecutive input statements following the first one, and stops
+     * at the first statement that isn't an input, or whose player or operands
+     * read something an earlier input in the run writes to. The returned inputs'
+     * requests evaluate the same before and after the earlier inputs complete,
+     * so they can be issued up front and their answers consumed in program order.
+     *
+     * @param statements The blocked input statement followed by the statements after it.
+     * @return The prefetchable inputs in program order, empty if there are none.
+     */
+    std::vector<InputRequestSpec>
+    findPrefetchableInputs(std::span<Statement* const> statements);
+}
@@ -0,0 +1,248 @@
+#include "Leaderboard.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+    // The player's id, or null if `value` isn't a player
+    const String*
+    findPlayerID(const Value& value)
+    {
+        if (!value.isMap())
+        {
+            return nullptr;
+        }
+        const auto& attributes = value.asMap().value;
+        auto idIt = attributes.find(String{"id"});
+        if (idIt == attributes.end() || !idIt->second.isString())
+        {
+            return nullptr;
+        }
+        return &idIt->second.asString();
+    }
+}
+
+Leaderboard::Leaderboard(std::vector<String> keys)
+    : m_keys(std::move(keys))
+{
+    if (m_keys.empty())
+    {
+        throw std::invalid_argument("A leaderboard needs at least one score attribute");
+    }
+}
+
+bool
+Leaderboard::tracks(const String& attr) const
+{
+    return std::find(m_keys.begin(), m_keys.end(), attr) != m_keys.end();
+}
+
+void
+Leaderboard::update(const Value& player, const Name& source)
+{
+    place(source, player, ++m_version, Precedence::LIVE);
+}
+
+void
+Leaderboard::hold(const Name& source, const Value& value)
+{
+    uint64_t version = ++m_version;
+    if (value.isList())
+    {
+        for (const Value& element : value.asList().value)
+        {
+            place(source, element, version, Precedence::ALIAS);
+        }
+    }
+    else
+    {
+        place(source, value, version, Precedence::ALIAS);
+    }
+
+    // Drop the players it held before and doesn't anymore
+    auto sourceIt = m_sources.find(source);
+    if (sourceIt == m_sources.end())
+    {
+        return;
+    }
+    std::erase_if(sourceIt->second, [this, &source, version](const String& playerID) {
+        const auto& copies = m_rows.at(playerID).copies;
+        auto copy = std::find_if(copies.begin(), copies.end(), [&source](const Copy& copy) {
+            return copy.source == source;
+        });
+        if (copy->version == version)
+        {
+            return false;
+        }
+        drop(source, playerID);
+        return true;
+    });
+    if (sourceIt->second.empty())
+    {
+        m_sources.erase(sourceIt);
+    }
+}
+
+void
+Leaderboard::add(const Name& source, const List<Value>& players)
+{
+    uint64_t version = ++m_version;
+    for (const Value& player : players.value)
+    {
+        place(source, player, version, Precedence::ALIAS);
+    }
+}
+
+void
+Leaderboard::remove(const Name& source)
+{
+    auto sourceIt = m_sources.find(source);
+    if (sourceIt == m_sources.end())
+    {
+        return;
+    }
+    for (const String& playerID : sourceIt->second)
+    {
+        drop(source, playerID);
+    }
+    m_sources.erase(sourceIt);
+}
+
+void
+Leaderboard::place(const Name& source, const Value& player, uint64_t version, Precedence precedence)
+{
+    const String* playerID = findPlayerID(player);
+    if (!playerID)
+    {
+        return;
+    }
+    const auto& attributes = player.asMap().value;
+
+    Copy written{source, version, *playerID, {}};
+    auto nameIt = attributes.find(String{"name"});
+    if (nameIt != attributes.end() && nameIt->second.isString())
+    {
+        written.name = nameIt->second.asString();
+    }
+    written.values.resize(m_keys.size());
+    for (size_t i = 0; i < m_keys.size(); ++i)
+    {
+        auto valueIt = attributes.find(m_keys[i]);
+        if (valueIt != attributes.end())
+        {
+            written.values[i] = valueIt->second;
+        }
+    }
+
+    auto [rowIt, isNew] = m_rows.try_emplace(*playerID);
+    Entry& entry = rowIt->second;
+    if (isNew)
+    {
+        entry.row.playerID = *playerID;
+    }
+
+    auto& copies = entry.copies;
+    auto copy = std::find_if(copies.begin(), copies.end(), [&source](const Copy& copy) {
+        return copy.source == source;
+    });
+    if (copy == copies.end())
+    {
+        m_sources[source].push_back(*playerID);
+    }
+    else if (precedence == Precedence::ALIAS)
+    {
+        *copy = std::move(written);
+        show(entry);
+        return;
+    }
+    else
+    {
+        copies.erase(copy);
+    }
+
+    if (precedence == Precedence::LIVE || copies.empty())
+    {
+        copies.push_back(std::move(written));
+    }
+    else
+    {
+        copies.insert(copies.begin(), std::move(written));
+    }
+    show(entry);
+}
+
+void
+Leaderboard::drop(const Name& source, const String& playerID)
+{
+    auto rowIt = m_rows.find(playerID);
+    if (rowIt == m_rows.end())
+    {
+        return;
+    }
+    Entry& entry = rowIt->second;
+
+    auto& copies = entry.copies;
+    auto copy = std::find_if(copies.begin(), copies.end(), [&source](const Copy& copy) {
+        return copy.source == source;
+    });
+    if (copy == copies.end())
+    {
+        return;
+    }
+    bool wasShown = std::next(copy) == copies.end();
+    copies.erase(copy);
+
+    if (copies.empty())
+    {
+        unrank(entry.row);
+        m_rows.erase(rowIt);
+    }
+    else if (wasShown)
+    {
+        show(entry);
+    }
+}
+
+void
+Leaderboard::show(Entry& entry)
+{
+    Row& row = entry.row;
+    // Rows get their values when first shown
+    if (!row.values.empty())
+    {
+        unrank(row);
+    }
+
+    const Copy& shown = entry.copies.back();
+    row.name = shown.name;
+    row.values = shown.values;
+    rank(row);
+}
+
+void
+Leaderboard::rank(const Row& row)
+{
+    if (row.values.front() && row.values.front()->isInteger())
+    {
+        m_ranking.insert(RankKey{row.values.front()->asInteger().value, row.playerID});
+    }
+    else
+    {
+        m_unranked.insert(row.playerID);
+    }
+}
+
+void
+Leaderboard::unrank(const Row& row)
+{
+    if (row.values.front() && row.values.front()->isInteger())
+    {
+        m_ranking.erase(RankKey{row.values.front()->asInteger().value, row.playerID});
+    }
+    else
+    {
+        m_unranked.erase(row.playerID);
+    }
+}
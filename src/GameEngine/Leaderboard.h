@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "Types.h"
+
+
+/**
+ * Players ranked by a score attribute, kept sorted as scores change.
+ *
+ * A scores statement lists attributes; the first one ranks the players
+ * (highest first, ties by player id) and the rest are shown alongside.
+ * The board is told whenever a variable holding players is written, in
+ * O(log n) per player, so showing the scores walks the ranking instead of
+ * sorting every player: forEachTop() costs O(k) for the best k.
+ *
+ * Values are copied, so several variables can hold their own copy of a
+ * player. The board keeps each variable's copy and shows the one whose
+ * scores were written last; a copy made by assigning the whole player is
+ * only shown while no other variable holds the player. Dropping a
+ * variable's players only touches their rows.
+ *
+ * Players are maps with a String "id"; a "name", if set, labels them.
+ * Players whose ranking attribute isn't an Integer come last, by id.
+ */
+class Leaderboard
+{
+    public:
+        struct Row
+        {
+            String playerID;
+            String name;
+            std::vector<std::optional<Value>> values; // one per key, unset if missing
+        };
+
+        explicit Leaderboard(std::vector<String> keys);
+
+        const std::vector<String>& getKeys() const { return m_keys; }
+
+        /// True if `attr` is one of the attributes this board shows
+        bool tracks(const String& attr) const;
+
+        /// Records that `source` holds `player` with these scores now, and
+        /// shows them. Values that aren't players (maps without a String
+        /// "id") are ignored.
+        void update(const Value& player, const Name& source = {});
+
+        /// Records that `source` now holds `value`, a player or a list of
+        /// them, in place of what it held before
+        void hold(const Name& source, const Value& value);
+
+        /// Records that `source` holds these players too, added to a list
+        void add(const Name& source, const List<Value>& players);
+
+        /// Drops the players `source` held, and the rows no one holds anymore
+        void remove(const Name& source);
+
+        size_t size() const { return m_rows.size(); }
+
+        /// Calls visit(const Row&) for the best `limit` players, best first
+        template <typename Visit>
+        void forEachTop(size_t limit, Visit&& visit) const
+        {
+            for (const RankKey& key : m_ranking)
+            {
+                if (limit-- == 0)
+                {
+                    return;
+                }
+                visit(m_rows.at(key.playerID).row);
+            }
+            for (const String& playerID : m_unranked)
+            {
+                if (limit-- == 0)
+                {
+                    return;
+                }
+                visit(m_rows.at(playerID).row);
+            }
+        }
+
+    private:
+        struct RankKey
+        {
+            int score;
+            String playerID;
+
+            bool operator<(const RankKey& other) const
+            {
+                if (score != other.score)
+                {
+                    return score > other.score;
+                }
+                return playerID.value < other.playerID.value;
+            }
+        };
+
+        struct ByID
+        {
+            bool operator()(const String& a, const String& b) const { return a.value < b.value; }
+        };
+
+        // One variable's copy of a player
+        struct Copy
+        {
+            Name source;
+            uint64_t version = 0; // the hold() or add() that last wrote it
+            String name;
+            std::vector<std::optional<Value>> values;
+        };
+
+        struct Entry
+        {
+            Row row;                  // shows copies.back()
+            std::vector<Copy> copies; // by precedence, highest last
+        };
+
+        enum class Precedence { LIVE, ALIAS };
+
+        /// Writes `source`'s copy of `player`. A LIVE copy goes last, so
+        /// it's shown. An ALIAS keeps its place if `source` had a copy,
+        /// and otherwise goes first unless it's the only one.
+        void place(const Name& source, const Value& player, uint64_t version, Precedence precedence);
+
+        /// Drops `source`'s copy of the player, and their row with it if
+        /// it was the last one. Leaves m_sources to the caller.
+        void drop(const Name& source, const String& playerID);
+
+        /// Updates the entry's row and ranking to its shown copy
+        void show(Entry& entry);
+
+        void rank(const Row& row);
+        void unrank(const Row& row);
+
+        std::vector<String> m_keys;
+        std::unordered_map<String, Entry> m_rows;
+        std::unordered_map<Name, std::vector<String>> m_sources; // the player IDs each variable holds
+        uint64_t m_version = 0;
+        std::set<RankKey> m_ranking; // players with an Integer score
+        std::set<String, ByID> m_unranked;
+};
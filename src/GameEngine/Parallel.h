@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+
+
+/// Lists with at least this many elements are copied, compared and sorted
+/// on TaskPool::shared(); shorter ones aren't worth the handoff.
+inline constexpr size_t PARALLEL_LIST_SIZE = 1 << 15;
+
+/// TaskPool::shared().run(), declared here so the list types don't pull in
+/// the pool's threading headers
+void runOnSharedPool(size_t taskCount, const std::function<void(size_t index)>& task);
+
+/// TaskPool::shared().getThreadCount()
+size_t getSharedPoolThreadCount();
+
+/// Calls chunk(begin, end) over [0, size) on the shared pool, in a few
+/// contiguous pieces per thread.
+template <typename F>
+void
+forEachChunk(size_t size, F&& chunk)
+{
+    size_t count = std::min(size, getSharedPoolThreadCount() * 4);
+    runOnSharedPool(count, [&](size_t i) {
+        chunk(size * i / count, size * (i + 1) / count);
+    });
+}
+
+/// Sorts [first, last) like std::sort: one run per thread is sorted in
+/// parallel, then neighbouring runs are merged pairwise, in parallel, until
+/// one remains.
+template <typename It, typename Compare>
+void
+parallelSort(It first, It last, Compare comp)
+{
+    size_t size = static_cast<size_t>(last - first);
+    size_t runs = std::bit_ceil(std::max<size_t>(getSharedPoolThreadCount(), 2));
+    auto boundary = [&](size_t run) { return first + size * run / runs; };
+
+    runOnSharedPool(runs, [&](size_t run) {
+        std::sort(boundary(run), boundary(run + 1), comp);
+    });
+    for (size_t width = 1; width < runs; width *= 2)
+    {
+        runOnSharedPool(runs / (2 * width), [&](size_t pair) {
+            size_t run = pair * 2 * width;
+            std::inplace_merge(boundary(run), boundary(run + width), boundary(run + 2 * width), comp);
+        });
+    }
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <vector>
+
+#include "Profiler.h"
+
+
+#ifdef GAMEENGINE_PROFILE_ALLOCATIONS
+
+namespace
+{
+    thread_local uint64_t allocationCount = 0;
+}
+
+void*
+operator new(std::size_t size)
+{
+    allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+uint64_t
+Profiler::getAllocationCount()
+{
+    return allocationCount;
+}
+
+#else
+
+uint64_t
+Profiler::getAllocationCount()
+{
+    return 0;
+}
+
+#endif
+
+
+void
+Profiler::Stats::add(const Stats& other)
+{
+    visits += other.visits;
+    time += other.time;
+    allocations += other.allocations;
+}
+
+Profiler::Stats&
+Profiler::getNodeStats(ast::NodeKind kind)
+{
+    return m_nodes[static_cast<size_t>(kind)];
+}
+
+const Profiler::Stats&
+Profiler::getNodeStats(ast::NodeKind kind) const
+{
+    return m_nodes[static_cast<size_t>(kind)];
+}
+
+Profiler::Stats&
+Profiler::getStatementStats(ast::SourceLocation location)
+{
+    return m_statements[location];
+}
+
+const std::map<ast::SourceLocation, Profiler::Stats>&
+Profiler::getStatementStats() const
+{
+    return m_statements;
+}
+
+void
+Profiler::merge(const Profiler& other)
+{
+    for (size_t i = 0; i < m_nodes.size(); i++)
+    {
+        m_nodes[i].add(other.m_nodes[i]);
+    }
+    for (const auto& [location, stats] : other.m_statements)
+    {
+        m_statements[location].add(stats);
+    }
+}
+
+void
+Profiler::dump(std::ostream& out) const
+{
+    auto writeRow = [&out](const auto& label, const Stats& stats) {
+        out << "  " << std::left << std::setw(22) << label << std::right
+            << std::setw(10) << stats.visits
+            << std::setw(14) << std::chrono::duration_cast<std::chrono::microseconds>(stats.time).count() << "us"
+            << std::setw(12) << stats.allocations << "\n";
+    };
+
+    std::vector<ast::NodeKind> kinds;
+    for (size_t i = 0; i < m_nodes.size(); i++)
+    {
+        if (m_nodes[i].visits > 0)
+        {
+            kinds.push_back(static_cast<ast::NodeKind>(i));
+        }
+    }
+    std::ranges::sort(kinds, [this](ast::NodeKind left, ast::NodeKind right) {
+        return getNodeStats(left).time > getNodeStats(right).time;
+    });
+
+    out << "By node kind (visits, time, allocations):\n";
+    for (ast::NodeKind kind : kinds)
+    {
+        writeRow(ast::nodeKindName(kind), getNodeStats(kind));
+    }
+
+    out << "By statement (visits, time, allocations):\n";
+    for (const auto& [location, stats] : m_statements)
+    {
+        writeRow(std::to_string(location.line) + ":" + std::to_string(location.column), stats);
+    }
+}
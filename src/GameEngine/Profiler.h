@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+
+#include "Rules.h"
+
+
+/**
+ * Collects where an interpreter spends its time: visit counts, cumulative
+ * time and heap allocations, per AST node kind and per source statement.
+ *
+ * Times are inclusive, so a ForLoop's time includes its body's statements.
+ * Allocations are only counted in builds with GAMEENGINE_PROFILE_ALLOCATIONS,
+ * which replaces the global operator new; otherwise they stay zero.
+ *
+ * Profiling is opt-in per interpreter (see GameInterpreter::setProfiler).
+ * Builds without GAMEENGINE_PROFILING compile every Scope down to nothing.
+ */
+class Profiler
+{
+    public:
+        struct Stats
+        {
+            uint64_t visits = 0;
+            std::chrono::nanoseconds time{0};
+            uint64_t allocations = 0;
+
+            void add(const Stats& other);
+        };
+
+        /// Measures one visit, from construction to destruction, into `stats`.
+        /// A null `stats` measures nothing.
+        class Scope
+        {
+            public:
+                explicit Scope(Stats* stats);
+                ~Scope();
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+#ifdef GAMEENGINE_PROFILING
+            private:
+                Stats* m_stats;
+                std::chrono::steady_clock::time_point m_start;
+                uint64_t m_startAllocations;
+#endif
+        };
+
+    public:
+        Stats& getNodeStats(ast::NodeKind kind);
+        const Stats& getNodeStats(ast::NodeKind kind) const;
+
+        Stats& getStatementStats(ast::SourceLocation location);
+        const std::map<ast::SourceLocation, Stats>& getStatementStats() const;
+
+        /// Adds `other`'s counts into this one, e.g. to aggregate sessions of a game.
+        void merge(const Profiler& other);
+
+        /// Writes a human-readable report, busiest node kinds first.
+        void dump(std::ostream& out) const;
+
+        /// Heap allocations made by this thread so far, 0 if not counted.
+        static uint64_t getAllocationCount();
+
+    private:
+        std::array<Stats, static_cast<size_t>(ast::NodeKind::COUNT)> m_nodes;
+        std::map<ast::SourceLocation, Stats> m_statements;
+};
+
+
+#ifdef GAMEENGINE_PROFILING
+
+inline
+Profiler::Scope::Scope(Stats* stats)
+    : m_stats(stats)
+{
+    if (m_stats)
+    {
+        m_startAllocations = getAllocationCount();
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+inline
+Profiler::Scope::~Scope()
+{
+    if (m_stats)
+    {
+        m_stats->time += std::chrono::steady_clock::now() - m_start;
+        m_stats->allocations += getAllocationCount() - m_startAllocations;
+        m_stats->visits++;
+    }
+}
+
+#else
+
+inline Profiler::Scope::Scope(Stats*) {}
+inline Profiler::Scope::~Scope() {}
+
+#endif
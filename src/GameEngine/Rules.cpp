@@ -1,5 +1,7 @@
 #include "Rules.h"
 
+#include <stdexcept>
+
 VisitResult ast::Constant::accept(ast::ASTVisitor& visitor)
 {
     return visitor.visit(*this);
@@ -80,6 +82,11 @@ VisitResult ast::ForLoop::accept(ast::ASTVisitor& visitor)
     return visitor.visit(*this);
 }
 
+VisitResult ast::ParallelFor::accept(ast::ASTVisitor& visitor)
+{
+    return visitor.visit(*this);
+}
+
 VisitResult ast::InputText::accept(ast::ASTVisitor& visitor)
 {
     return visitor.visit(*this);
@@ -100,6 +107,85 @@ VisitResult ast::InputVote::accept(ast::ASTVisitor& visitor)
     return visitor.visit(*this);
 };
 
+VisitResult ast::Message::accept(ast::ASTVisitor& visitor)
+{
+    return visitor.visit(*this);
+};
+
+VisitResult ast::Scores::accept(ast::ASTVisitor& visitor)
+{
+    return visitor.visit(*this);
+};
+
+const char*
+ast::nodeKindName(ast::NodeKind kind)
+{
+    switch (kind)
+    {
+        case NodeKind::CONSTANT: return "Constant";
+        case NodeKind::VARIABLE: return "Variable";
+        case NodeKind::ATTRIBUTE: return "Attribute";
+        case NodeKind::COMPARISON: return "Comparison";
+        case NodeKind::LOGICAL_OPERATION: return "LogicalOperation";
+        case NodeKind::UNARY_OPERATION: return "UnaryOperation";
+        case NodeKind::ARITHMETIC_OPERATION: return "ArithmeticOperation";
+        case NodeKind::CALLABLE: return "Callable";
+        case NodeKind::ASSIGNMENT: return "Assignment";
+        case NodeKind::EXTEND: return "Extend";
+        case NodeKind::REVERSE: return "Reverse";
+        case NodeKind::SHUFFLE: return "Shuffle";
+        case NodeKind::DISCARD: return "Discard";
+        case NodeKind::SORT: return "Sort";
+        case NodeKind::MATCH: return "Match";
+        case NodeKind::FOR_LOOP: return "ForLoop";
+        case NodeKind::PARALLEL_FOR: return "ParallelFor";
+        case NodeKind::INPUT_TEXT: return "InputText";
+        case NodeKind::INPUT_CHOICE: return "InputChoice";
+        case NodeKind::INPUT_RANGE: return "InputRange";
+        case NodeKind::INPUT_VOTE: return "InputVote";
+        case NodeKind::MESSAGE: return "Message";
+        case NodeKind::SCORES: return "Scores";
+        case NodeKind::COUNT: break;
+    }
+    return "Unknown";
+}
+
+size_t
+ast::builtinArity(ast::Callable::Kind kind)
+{
+    switch (kind)
+    {
+        case Callable::Kind::SIZE: return 0;
+        case Callable::Kind::UNIQUE: return 0;
+        case Callable::Kind::UP_FROM: return 1;
+        case Callable::Kind::CONTAINS: return 1;
+        case Callable::Kind::COLLECT: return 1;
+        case Callable::Kind::MAX_BY: return 1;
+        case Callable::Kind::MIN_BY: return 1;
+        case Callable::Kind::FILTER: return 2;
+        case Callable::Kind::COUNT: return 2;
+    }
+    return 0;
+}
+
+const char*
+ast::builtinName(ast::Callable::Kind kind)
+{
+    switch (kind)
+    {
+        case Callable::Kind::SIZE: return "size";
+        case Callable::Kind::UP_FROM: return "upfrom";
+        case Callable::Kind::CONTAINS: return "contains";
+        case Callable::Kind::COLLECT: return "collect";
+        case Callable::Kind::FILTER: return "filter";
+        case Callable::Kind::COUNT: return "count";
+        case Callable::Kind::MAX_BY: return "max";
+        case Callable::Kind::MIN_BY: return "min";
+        case Callable::Kind::UNIQUE: return "unique";
+    }
+    return "unknown";
+}
+
 std::unique_ptr<ast::Variable>
 ast::makeVariable(Name name) {
     return std::make_unique<ast::Variable>(std::move(name));
@@ -223,6 +309,18 @@ ast::makeForLoop(std::unique_ptr<Variable> element,
     );
 }
 
+std::unique_ptr<ast::ParallelFor>
+ast::makeParallelFor(std::unique_ptr<Variable> element,
+                     std::unique_ptr<ast::Expression> target,
+                     std::vector<std::unique_ptr<ast::Statement>> statements)
+{
+    return std::make_unique<ast::ParallelFor>(
+        std::move(element),
+        std::move(target),
+        std::move(statements)
+    );
+}
+
 std::unique_ptr<ast::InputText>
 ast::makeInputText(std::unique_ptr<ast::Variable> playerVar,
                    std::unique_ptr<ast::Expression> targetExpr,
@@ -267,6 +365,68 @@ ast::makeInputVote(std::unique_ptr<ast::Variable> playerVar,
     );
 }
 
+std::unique_ptr<ast::Message>
+ast::makeMessage(std::unique_ptr<ast::Expression> players,
+                 std::vector<ast::Message::Segment> segments)
+{
+    return std::make_unique<ast::Message>(std::move(players), std::move(segments));
+}
+
+std::unique_ptr<ast::Scores>
+ast::makeScores(std::vector<String> keys)
+{
+    return std::make_unique<ast::Scores>(std::move(keys));
+}
+
+std::vector<ast::Message::Segment>
+ast::compileMessageTemplate(std::string_view text)
+{
+    std::vector<ast::Message::Segment> segments;
+    while (!text.empty())
+    {
+        size_t open = text.find('{');
+        if (open != 0)
+        {
+            segments.push_back({std::string{text.substr(0, open)}, nullptr});
+            if (open == std::string_view::npos)
+            {
+                break;
+            }
+            text.remove_prefix(open);
+        }
+
+        size_t close = text.find('}');
+        if (close == std::string_view::npos)
+        {
+            throw std::invalid_argument("Unclosed '{' in message");
+        }
+        std::string_view path = text.substr(1, close - 1);
+        text.remove_prefix(close + 1);
+
+        // name(.attribute)*
+        std::unique_ptr<ast::Expression> expression;
+        while (true)
+        {
+            size_t dot = path.find('.');
+            std::string_view part = path.substr(0, dot);
+            if (part.empty())
+            {
+                throw std::invalid_argument("Empty name in message interpolation");
+            }
+            expression = expression
+                ? std::unique_ptr<ast::Expression>(ast::makeAttribute(std::move(expression), String{std::string{part}}))
+                : std::unique_ptr<ast::Expression>(ast::makeVariable(Name{std::string{part}}));
+            if (dot == std::string_view::npos)
+            {
+                break;
+            }
+            path.remove_prefix(dot + 1);
+        }
+        segments.push_back({"", std::move(expression)});
+    }
+    return segments;
+}
+
 std::unique_ptr<ast::Constant>
 ast::cloneConstant(ast::Constant* constant)
 {
@@ -306,6 +466,58 @@ ast::cloneExpression(ast::Expression* expr)
     throw std::runtime_error("Unknown expression type in cloneExpression");
 }
 
+bool
+ast::mentionsVariable(ast::Expression* expr, const Name& name)
+{
+    if (!expr)
+    {
+        return false;
+    }
+    if (auto variable = ast::castExpressionToVariable(expr))
+    {
+        return variable->getName() == name;
+    }
+    if (auto attribute = ast::castExpressionToAttribute(expr))
+    {
+        return ast::mentionsVariable(attribute->getBase(), name);
+    }
+    if (auto comparison = ast::castExpressionToComparison(expr))
+    {
+        return ast::mentionsVariable(comparison->getLeft(), name)
+            || ast::mentionsVariable(comparison->getRight(), name);
+    }
+    if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+    {
+        return ast::mentionsVariable(logicalOp->getLeft(), name)
+            || ast::mentionsVariable(logicalOp->getRight(), name);
+    }
+    if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+    {
+        return ast::mentionsVariable(arithmeticOp->getLeft(), name)
+            || ast::mentionsVariable(arithmeticOp->getRight(), name);
+    }
+    if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+    {
+        return ast::mentionsVariable(unaryOp->getTarget(), name);
+    }
+    if (auto callable = ast::castExpressionToCallable(expr))
+    {
+        if (ast::mentionsVariable(callable->getLeft(), name))
+        {
+            return true;
+        }
+        for (ast::Expression* arg : callable->getArgs())
+        {
+            if (ast::mentionsVariable(arg, name))
+            {
+                return true;
+            }
+        }
+    }
+    // Constants read nothing
+    return false;
+}
+
 ast::Constant*
 ast::castExpressionToConstant(ast::Expression* expr)
 {
@@ -323,3 +535,45 @@ ast::castExpressionToAttribute(ast::Expression* expr)
 {
     return dynamic_cast<ast::Attribute*>(expr);
 }
+
+ast::Comparison*
+ast::castExpressionToComparison(ast::Expression* expr)
+{
+    return dynamic_cast<ast::Comparison*>(expr);
+}
+
+ast::Callable*
+ast::castExpressionToCallable(ast::Expression* expr)
+{
+    return dynamic_cast<ast::Callable*>(expr);
+}
+
+ast::Match*
+ast::castStatementToMatch(ast::Statement* statement)
+{
+    return dynamic_cast<ast::Match*>(statement);
+}
+
+ast::ForLoop*
+ast::castStatementToForLoop(ast::Statement* statement)
+{
+    return dynamic_cast<ast::ForLoop*>(statement);
+}
+
+ast::ParallelFor*
+ast::castStatementToParallelFor(ast::Statement* statement)
+{
+    return dynamic_cast<ast::ParallelFor*>(statement);
+}
+
+ast::Message*
+ast::castStatementToMessage(ast::Statement* statement)
+{
+    return dynamic_cast<ast::Message*>(statement);
+}
+
+ast::Scores*
+ast::castStatementToScores(ast::Statement* statement)
+{
+    return dynamic_cast<ast::Scores*>(statement);
+}
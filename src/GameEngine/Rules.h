@@ -1,9 +1,15 @@
 #pragma once
 
 #include <cassert>
+#include <compare>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "Types.h"
 
@@ -11,9 +17,29 @@
 struct VisitResult
 {
     std::optional<std::variant<Value, Value*>> value;
+    // Set instead of a value when evaluation failed
+    std::optional<RuntimeError> error;
+
+    static VisitResult fail(RuntimeError error)
+    {
+        return VisitResult{std::nullopt, std::move(error)};
+    }
+
+    static VisitResult fail(std::string message)
+    {
+        return fail(RuntimeError{std::move(message)});
+    }
 
     bool hasValue() const { return value.has_value(); }
 
+    bool hasError() const { return error.has_value(); }
+
+    const RuntimeError& getError() const
+    {
+        assert(hasError());
+        return *error;
+    }
+
     Value& getValue()
     {
         assert(hasValue());
@@ -42,6 +68,49 @@ namespace ast
 {
     class ASTVisitor;
 
+    // One per concrete node type, for code that needs to name a node's type
+    // without a visitor (e.g. profiling)
+    enum class NodeKind
+    {
+        CONSTANT,
+        VARIABLE,
+        ATTRIBUTE,
+        COMPARISON,
+        LOGICAL_OPERATION,
+        UNARY_OPERATION,
+        ARITHMETIC_OPERATION,
+        CALLABLE,
+        ASSIGNMENT,
+        EXTEND,
+        REVERSE,
+        SHUFFLE,
+        DISCARD,
+        SORT,
+        MATCH,
+        FOR_LOOP,
+        PARALLEL_FOR,
+        INPUT_TEXT,
+        INPUT_CHOICE,
+        INPUT_RANGE,
+        INPUT_VOTE,
+        MESSAGE,
+        SCORES,
+        COUNT
+    };
+
+    const char*
+    nodeKindName(NodeKind kind);
+
+    // Where a statement starts in its rules file, 1-based.
+    // Zero for statements that weren't parsed from source.
+    struct SourceLocation
+    {
+        uint32_t line = 0;
+        uint32_t column = 0;
+
+        auto operator<=>(const SourceLocation&) const = default;
+    };
+
     class ASTNode
     {
         public:
@@ -51,10 +120,48 @@ namespace ast
 
     // Expressions usually evaluate to a Value, but can also be LHS
     // in assignments
-    class Expression : public ASTNode {};
+    class Expression : public ASTNode
+    {
+        public:
+            static constexpr uint32_t NOT_FLAT = UINT32_MAX;
+
+            // The type this always evaluates to, if inferTypes() could work it out
+            void setStaticType(ValueType type) noexcept { staticType = type; }
+            ValueType getStaticType() const noexcept { return staticType; }
+
+            // Where this expression lives in its Program's FlatExpressions, if
+            // flattenExpressions() stored it there
+            void setFlatIndex(uint32_t index) noexcept { flatIndex = index; }
+            uint32_t getFlatIndex() const noexcept { return flatIndex; }
+
+        private:
+            ValueType staticType = ValueType::UNKNOWN;
+            uint32_t flatIndex = NOT_FLAT;
+    };
 
     // Statements don't evaluate to a value
-    class Statement : public ASTNode {};
+    class Statement : public ASTNode
+    {
+        public:
+            void setLocation(SourceLocation location) noexcept { this->location = location; }
+            SourceLocation getLocation() const noexcept { return location; }
+
+        private:
+            SourceLocation location;
+    };
+
+    /// The statements without ownership, e.g. for a ProgramIterator to walk
+    inline std::vector<Statement*>
+    rawStatements(const std::vector<std::unique_ptr<Statement>>& statements)
+    {
+        std::vector<Statement*> raw;
+        raw.reserve(statements.size());
+        for (const auto& statement : statements)
+        {
+            raw.push_back(statement.get());
+        }
+        return raw;
+    }
 
     class Constant : public Expression
     {
@@ -189,7 +296,12 @@ namespace ast
     class Callable : public Expression
     {
         public:
-            enum class Kind { SIZE, UP_FROM };
+            // Besides SIZE and UP_FROM, these query a list in one pass. The
+            // ..._BY and attribute forms take the attribute's name as a String
+            // argument: COLLECT(attr) gives each element's attr, FILTER(attr, v)
+            // the elements whose attr = v, COUNT(attr, v) how many there are,
+            // MAX_BY/MIN_BY(attr) the first element with the largest/smallest.
+            enum class Kind { SIZE, UP_FROM, CONTAINS, COLLECT, FILTER, COUNT, MAX_BY, MIN_BY, UNIQUE };
 
             Callable(std::unique_ptr<Expression> left,
                      std::vector<std::unique_ptr<Expression>> args,
@@ -211,6 +323,9 @@ namespace ast
                 return rawExpressions;
             }
 
+            size_t getArgCount() const noexcept { return args.size(); }
+            Expression* getArg(size_t i) const noexcept { return args[i].get(); }
+
             Kind getKind() const noexcept { return kind; };
 
         private:
@@ -220,6 +335,14 @@ namespace ast
             Kind kind;
     };
 
+    /// How many arguments the builtin takes
+    size_t
+    builtinArity(Callable::Kind kind);
+
+    /// The builtin's name in rules, e.g. "size"
+    const char*
+    builtinName(Callable::Kind kind);
+
     class Assignment : public Statement
     {
         public:
@@ -326,32 +449,26 @@ namespace ast
             Match(std::unique_ptr<Expression> target,
                   std::vector<Candidate> candidates)
             : target(std::move(target))
-            , candidates(std::move(candidates)) {}
-
-            VisitResult accept(ASTVisitor &visitor) override;
-            Expression* getTarget() const noexcept { return target.get(); };
-
-            std::vector<CandidateRaw>
-            getCandidates() const
+            , candidates(std::move(candidates))
             {
-                std::vector<CandidateRaw> rawCandidates;
-                for (auto& candidate : candidates)
+                for (auto& candidate : this->candidates)
                 {
-                    Expression* expressionCandidate = candidate.expressionCandidate.get();
-
-                    std::vector<Statement*> statements;
-                    for (auto& statement : candidate.statements)
-                    {
-                        statements.push_back(statement.get());
-                    }
-                    rawCandidates.push_back({expressionCandidate, statements});
+                    rawCandidates.push_back(
+                        {candidate.expressionCandidate.get(), rawStatements(candidate.statements)}
+                    );
                 }
-                return rawCandidates;
             }
 
+            VisitResult accept(ASTVisitor &visitor) override;
+            Expression* getTarget() const noexcept { return target.get(); };
+
+            std::span<const CandidateRaw>
+            getCandidates() const noexcept { return rawCandidates; }
+
         private:
             std::unique_ptr<Expression> target;
             std::vector<Candidate> candidates;
+            std::vector<CandidateRaw> rawCandidates; // built once, so the interpreter can point into it
     };
 
     class ForLoop : public Statement
@@ -362,30 +479,46 @@ namespace ast
                         std::vector<std::unique_ptr<Statement>> statements)
             : element(std::move(element))
             , target(std::move(target))
-            , statements(std::move(statements)) {}
+            , statements(std::move(statements))
+            , statementsRaw(rawStatements(this->statements)) {}
 
             VisitResult accept(ASTVisitor &visitor) override;
             Variable* getElement() const noexcept { return element.get(); };
             Expression* getTarget() const noexcept { return target.get(); };
 
-            std::vector<Statement*>
-            getStatements() const
-            {
-                // This logic is also in Match, now duplicating
-                // TODO: Have a StatementList type that stores std::unique_ptr<Statement>,
-                // with raw() method to get vector of Statement* ?
-                std::vector<Statement*> rawStatements;
-                for (auto& statement : statements)
-                {
-                    rawStatements.push_back(statement.get());
-                }
-                return rawStatements;
-            }
+            std::span<Statement* const>
+            getStatements() const noexcept { return statementsRaw; }
 
         private:
             std::unique_ptr<Variable> element;
             std::unique_ptr<Expression> target;
             std::vector<std::unique_ptr<Statement>> statements;
+            std::vector<Statement*> statementsRaw;
+    };
+
+    class ParallelFor : public Statement
+    {
+        public:
+            ParallelFor(std::unique_ptr<Variable> element,
+                        std::unique_ptr<Expression> target,
+                        std::vector<std::unique_ptr<Statement>> statements)
+            : element(std::move(element))
+            , target(std::move(target))
+            , statements(std::move(statements))
+            , statementsRaw(rawStatements(this->statements)) {}
+
+            VisitResult accept(ASTVisitor &visitor) override;
+            Variable* getElement() const noexcept { return element.get(); };
+            Expression* getTarget() const noexcept { return target.get(); };
+
+            std::span<Statement* const>
+            getStatements() const noexcept { return statementsRaw; }
+
+        private:
+            std::unique_ptr<Variable> element;
+            std::unique_ptr<Expression> target;
+            std::vector<std::unique_ptr<Statement>> statements;
+            std::vector<Statement*> statementsRaw;
     };
 
     class InputText : public Statement
@@ -488,6 +621,44 @@ namespace ast
             std::unique_ptr<Expression> choices;
     };
 
+    class Message : public Statement
+    {
+        public:
+            // The text is split when the rules are loaded, so sending only
+            // evaluates the interpolated expressions
+            struct Segment
+            {
+                std::string text;
+                std::unique_ptr<Expression> expression; // null for literal text
+            };
+
+            // `players` evaluates to a player or a list of them; null sends to everyone
+            Message(std::unique_ptr<Expression> players, std::vector<Segment> segments)
+            : players(std::move(players))
+            , segments(std::move(segments)) {}
+
+            VisitResult accept(ASTVisitor& visitor) override;
+            Expression* getPlayers() const noexcept { return players.get(); }
+            std::span<const Segment> getSegments() const noexcept { return segments; }
+
+        private:
+            std::unique_ptr<Expression> players;
+            std::vector<Segment> segments;
+    };
+
+    class Scores : public Statement
+    {
+        public:
+            // Players are ranked by the first attribute; the rest are shown alongside
+            Scores(std::vector<String> keys) : keys(std::move(keys)) {}
+
+            VisitResult accept(ASTVisitor& visitor) override;
+            const std::vector<String>& getKeys() const noexcept { return keys; }
+
+        private:
+            std::vector<String> keys;
+    };
+
 
     class ASTVisitor
     {
@@ -509,10 +680,13 @@ namespace ast
             virtual VisitResult visit(const Sort& sort) = 0;
             virtual VisitResult visit(const Match& match) = 0;
             virtual VisitResult visit(const ForLoop& forLoop) = 0;
+            virtual VisitResult visit(const ParallelFor& parallelFor) = 0;
             virtual VisitResult visit(const InputText& inputText) = 0;
             virtual VisitResult visit(const InputChoice& inputChoice) = 0;
             virtual VisitResult visit(const InputRange& inputRange) = 0;
             virtual VisitResult visit(const InputVote& inputVote) = 0;
+            virtual VisitResult visit(const Message& message) = 0;
+            virtual VisitResult visit(const Scores& scores) = 0;
     };
 
     std::unique_ptr<ast::Variable>
@@ -579,6 +753,11 @@ namespace ast
                 std::unique_ptr<ast::Expression> target,
                 std::vector<std::unique_ptr<ast::Statement>> statements);
 
+    std::unique_ptr<ast::ParallelFor>
+    makeParallelFor(std::unique_ptr<Variable> element,
+                    std::unique_ptr<ast::Expression> target,
+                    std::vector<std::unique_ptr<ast::Statement>> statements);
+
     std::unique_ptr<ast::InputText>
     makeInputText(std::unique_ptr<ast::Variable> playerVar,
                   std::unique_ptr<ast::Expression> targetExpr,
@@ -603,6 +782,19 @@ namespace ast
                   String prompt,
                   std::unique_ptr<ast::Expression> choices);
 
+    std::unique_ptr<ast::Message>
+    makeMessage(std::unique_ptr<ast::Expression> players,
+                std::vector<ast::Message::Segment> segments);
+
+    std::unique_ptr<ast::Scores>
+    makeScores(std::vector<String> keys);
+
+    /// Splits message text like "Round {round}: {player.name} wins" into
+    /// segments. Only variables and attributes of them can be interpolated;
+    /// throws std::invalid_argument for anything else.
+    std::vector<ast::Message::Segment>
+    compileMessageTemplate(std::string_view text);
+
     std::unique_ptr<ast::Constant>
     cloneConstant(ast::Constant* constant);
 
@@ -615,6 +807,10 @@ namespace ast
     std::unique_ptr<ast::Expression>
     cloneExpression(ast::Expression* expr);
 
+    /// True if `name` is read anywhere in the expression
+    bool
+    mentionsVariable(ast::Expression* expr, const Name& name);
+
     ast::Constant*
     castExpressionToConstant(ast::Expression* expr);
 
@@ -624,6 +820,27 @@ namespace ast
     ast::Attribute*
     castExpressionToAttribute(ast::Expression* expr);
 
+    ast::Comparison*
+    castExpressionToComparison(ast::Expression* expr);
+
+    ast::Callable*
+    castExpressionToCallable(ast::Expression* expr);
+
+    ast::Match*
+    castStatementToMatch(ast::Statement* statement);
+
+    ast::ForLoop*
+    castStatementToForLoop(ast::Statement* statement);
+
+    ast::ParallelFor*
+    castStatementToParallelFor(ast::Statement* statement);
+
+    ast::Message*
+    castStatementToMessage(ast::Statement* statement);
+
+    ast::Scores*
+    castStatementToScores(ast::Statement* statement);
+
     // Builder classes allow us to define these types inline, which may make it easier to set up complex trees
     class StatementsBuilder
     {
@@ -0,0 +1,185 @@
+#include <limits>
+#include <stdexcept>
+
+#include "Snapshot.h"
+
+
+namespace
+{
+    // Tags for the alternatives of Value::value
+    enum class ValueTag : uint8_t { LIST, MAP, STRING, INTEGER, BOOLEAN };
+}
+
+
+void
+SnapshotWriter::writeUInt(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_bytes.push_back(static_cast<uint8_t>(value));
+}
+
+void
+SnapshotWriter::writeInt(int64_t value)
+{
+    writeUInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void
+SnapshotWriter::writeBool(bool value)
+{
+    m_bytes.push_back(value ? 1 : 0);
+}
+
+void
+SnapshotWriter::writeString(std::string_view value)
+{
+    writeUInt(value.size());
+    m_bytes.insert(m_bytes.end(), value.begin(), value.end());
+}
+
+void
+SnapshotWriter::writeValue(const Value& value)
+{
+    if (value.isList())
+    {
+        m_bytes.push_back(static_cast<uint8_t>(ValueTag::LIST));
+        writeUInt(value.asList().value.size());
+        for (const Value& element : value.asList().value)
+        {
+            writeValue(element);
+        }
+    }
+    else if (value.isMap())
+    {
+        m_bytes.push_back(static_cast<uint8_t>(ValueTag::MAP));
+        writeUInt(value.asMap().value.size());
+        for (const auto& [key, element] : value.asMap().value)
+        {
+            writeString(key.value);
+            writeValue(element);
+        }
+    }
+    else if (value.isString())
+    {
+        m_bytes.push_back(static_cast<uint8_t>(ValueTag::STRING));
+        writeString(value.asString().value);
+    }
+    else if (value.isInteger())
+    {
+        m_bytes.push_back(static_cast<uint8_t>(ValueTag::INTEGER));
+        writeInt(value.asInteger().value);
+    }
+    else if (value.isBoolean())
+    {
+        m_bytes.push_back(static_cast<uint8_t>(ValueTag::BOOLEAN));
+        writeBool(value.asBoolean().value);
+    }
+}
+
+uint8_t
+SnapshotReader::readByte()
+{
+    if (m_offset >= m_bytes.size())
+    {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    return m_bytes[m_offset++];
+}
+
+uint64_t
+SnapshotReader::readUInt()
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = readByte();
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error("Snapshot has a malformed integer");
+}
+
+int64_t
+SnapshotReader::readInt()
+{
+    uint64_t encoded = readUInt();
+    return static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+}
+
+bool
+SnapshotReader::readBool()
+{
+    return readByte() != 0;
+}
+
+size_t
+SnapshotReader::readCount()
+{
+    uint64_t count = readUInt();
+    if (count > m_bytes.size() - m_offset)
+    {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    return static_cast<size_t>(count);
+}
+
+std::string
+SnapshotReader::readString()
+{
+    size_t size = readCount();
+    std::string value(reinterpret_cast<const char*>(m_bytes.data() + m_offset), size);
+    m_offset += size;
+    return value;
+}
+
+Value
+SnapshotReader::readValue()
+{
+    switch (static_cast<ValueTag>(readByte()))
+    {
+        case ValueTag::LIST:
+        {
+            List<Value> list;
+            size_t size = readCount();
+            list.value.reserve(size);
+            for (size_t i = 0; i < size; i++)
+            {
+                list.value.push_back(readValue());
+            }
+            return Value{std::move(list)};
+        }
+        case ValueTag::MAP:
+        {
+            Map<String, Value> map;
+            size_t size = readCount();
+            map.value.reserve(size);
+            for (size_t i = 0; i < size; i++)
+            {
+                String key{readString()};
+                map.value.emplace(std::move(key), readValue());
+            }
+            return Value{std::move(map)};
+        }
+        case ValueTag::STRING:
+            return Value{String{readString()}};
+        case ValueTag::INTEGER:
+        {
+            int64_t value = readInt();
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+            {
+                throw std::runtime_error("Snapshot integer is out of range");
+            }
+            return Value{Integer{static_cast<int>(value)}};
+        }
+        case ValueTag::BOOLEAN:
+            return Value{Boolean{readBool()}};
+    }
+    throw std::runtime_error("Snapshot has an unknown value type");
+}
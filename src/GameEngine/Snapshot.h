@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+
+
+// Written first, so other data is rejected before being parsed ("SGSN")
+inline constexpr uint64_t SNAPSHOT_MAGIC = 0x4e534753;
+// Snapshot layout version, bump on any change to what gets written
+inline constexpr uint64_t SNAPSHOT_VERSION = 10;
+
+
+/**
+ * Appends primitive values to a compact binary buffer.
+ *
+ * Unsigned integers and lengths are LEB128 varints, signed integers are
+ * zigzag-encoded first, so small numbers (the common case for indices,
+ * sizes and game scores) take a single byte.
+ */
+class SnapshotWriter
+{
+    public:
+        void writeUInt(uint64_t value);
+        void writeInt(int64_t value);
+        void writeBool(bool value);
+        void writeString(std::string_view value);
+        void writeValue(const Value& value);
+
+        std::vector<uint8_t> take() { return std::move(m_bytes); }
+
+    private:
+        std::vector<uint8_t> m_bytes;
+};
+
+
+/**
+ * Reads back what a SnapshotWriter wrote, in the same order.
+ * Throws std::runtime_error on truncated or malformed input.
+ */
+class SnapshotReader
+{
+    public:
+        explicit SnapshotReader(std::span<const uint8_t> bytes) : m_bytes(bytes) {}
+
+        uint64_t readUInt();
+        int64_t readInt();
+        bool readBool();
+        std::string readString();
+        Value readValue();
+
+        /// Reads a count of items that each take at least one byte,
+        /// rejecting counts that couldn't fit in what's left
+        size_t readCount();
+
+        bool atEnd() const { return m_offset == m_bytes.size(); }
+
+    private:
+        uint8_t readByte();
+
+    private:
+        std::span<const uint8_t> m_bytes;
+        size_t m_offset = 0;
+};
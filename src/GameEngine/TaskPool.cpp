@@ -0,0 +1,127 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+
+#include "Parallel.h"
+
+
+namespace
+{
+    // Set while a thread runs a task, so nested run() calls stay on it
+    thread_local bool inTask = false;
+}
+
+TaskPool&
+TaskPool::shared()
+{
+    static TaskPool pool{std::max(std::thread::hardware_concurrency(), 1u)};
+    return pool;
+}
+
+void
+runOnSharedPool(size_t taskCount, const std::function<void(size_t index)>& task)
+{
+    TaskPool::shared().run(taskCount, task);
+}
+
+size_t
+getSharedPoolThreadCount()
+{
+    return TaskPool::shared().getThreadCount();
+}
+
+TaskPool::TaskPool(size_t threadCount)
+{
+    size_t workerCount = std::max<size_t>(threadCount, 1) - 1;
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_queued.notify_all();
+    m_workers.clear(); // joins
+}
+
+bool
+TaskPool::runNext(std::unique_lock<std::mutex>& lock, Batch* only)
+{
+    if (m_batches.empty() || (only && m_batches.front() != only))
+    {
+        return false;
+    }
+
+    // Indices are handed out under the lock, and a batch leaves the queue
+    // with its last one, so a batch is never touched after it's finished
+    Batch& batch = *m_batches.front();
+    size_t index = batch.next++;
+    if (batch.next == batch.count)
+    {
+        m_batches.pop_front();
+    }
+
+    lock.unlock();
+    inTask = true;
+    (*batch.task)(index);
+    inTask = false;
+    lock.lock();
+
+    batch.done++;
+    m_finished.notify_all();
+    return true;
+}
+
+void
+TaskPool::work()
+{
+    std::unique_lock lock(m_mutex);
+    while (true)
+    {
+        m_queued.wait(lock, [this] { return m_stopping || !m_batches.empty(); });
+        if (m_stopping)
+        {
+            return;
+        }
+        runNext(lock, nullptr);
+    }
+}
+
+void
+TaskPool::run(size_t taskCount, const std::function<void(size_t index)>& task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+    if (m_workers.empty() || inTask || taskCount == 1)
+    {
+        for (size_t i = 0; i < taskCount; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    Batch batch{&task, taskCount};
+    std::unique_lock lock(m_mutex);
+    m_batches.push_back(&batch);
+    m_queued.notify_all();
+
+    // Help with our own batch once it reaches the front, then wait for the
+    // indices the workers took
+    while (batch.next < batch.count)
+    {
+        if (!runNext(lock, &batch))
+        {
+            m_finished.wait(lock);
+        }
+    }
+    m_finished.wait(lock, [&batch] { return batch.done == batch.count; });
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Worker threads for data-parallel loops over big lists, shared by every
+ * interpreter in the process.
+ *
+ * run() hands out task indices to the workers and to the calling thread,
+ * which works too, and returns once all have run. Batches from different
+ * callers queue up and are served in order. A task that calls run() again
+ * gets a plain loop on its own thread, so tasks never wait on each other.
+ */
+class TaskPool
+{
+    public:
+        /// The pool lists use, with one thread per hardware thread
+        static TaskPool& shared();
+
+        /// `threadCount` includes the caller of run(), so 1 starts no workers
+        explicit TaskPool(size_t threadCount);
+        ~TaskPool();
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+        size_t getThreadCount() const { return m_workers.size() + 1; }
+
+        /// Calls task(index) once for every index below taskCount and returns
+        /// when all have run. Tasks must not throw.
+        void run(size_t taskCount, const std::function<void(size_t index)>& task);
+
+    private:
+        struct Batch
+        {
+            const std::function<void(size_t)>* task;
+            size_t count;
+            size_t next = 0; // the next index to hand out
+            size_t done = 0;
+        };
+
+        void work();
+
+        /// Runs one index of the front batch, waiting for one if `wait`.
+        /// False if there was nothing to run.
+        bool runNext(std::unique_lock<std::mutex>& lock, Batch* only);
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_queued; // a batch was queued, or the pool is stopping
+        std::condition_variable m_finished; // an index finished running
+        std::deque<Batch*> m_batches; // each with indices left to hand out
+        bool m_stopping = false;
+        std::vector<std::jthread> m_workers;
+};
+
@@ -0,0 +1,364 @@
+#include <optional>
+#include <unordered_set>
+
+#include "TypeInference.h"
+
+
+namespace
+{
+    // Type inference over a flat lattice: a variable the program hasn't given
+    // any value yet is absent from the map, one given values of a single type
+    // has that type, and one given values of several types is UNKNOWN. A
+    // variable the program reads but never assigns was stored by the host,
+    // so it could hold anything and is UNKNOWN too.
+    class TypeInferrer
+    {
+        public:
+            ast::VariableTypes
+            run(std::span<ast::Statement* const> statements)
+            {
+                // A first round only finds the names the program assigns
+                m_namesOnly = true;
+                collectDefinitions(statements);
+                m_namesOnly = false;
+
+                // Each round can only move variables up the lattice,
+                // so this settles after a few rounds
+                do
+                {
+                    m_changed = false;
+                    collectDefinitions(statements);
+                }
+                while (m_changed);
+
+                annotateStatements(statements);
+
+                ast::VariableTypes known;
+                for (const auto& [name, type] : m_variables)
+                {
+                    if (type != ValueType::UNKNOWN)
+                    {
+                        known.emplace(name, type);
+                    }
+                }
+                return known;
+            }
+
+        private:
+            // nullopt for a variable the program assigns but hasn't given
+            // a value of a known type yet
+            std::optional<ValueType>
+            typeOf(ast::Expression* expr) const
+            {
+                if (auto constant = ast::castExpressionToConstant(expr))
+                {
+                    return constant->getValue().getType();
+                }
+                if (auto variable = ast::castExpressionToVariable(expr))
+                {
+                    const std::string& name = variable->getName().name;
+                    if (auto it = m_variables.find(name); it != m_variables.end())
+                    {
+                        return it->second;
+                    }
+                    if (m_assigned.contains(name))
+                    {
+                        return std::nullopt;
+                    }
+                    return ValueType::UNKNOWN;
+                }
+                if (dynamic_cast<ast::Comparison*>(expr)
+                    || dynamic_cast<ast::LogicalOperation*>(expr)
+                    || dynamic_cast<ast::UnaryOperation*>(expr))
+                {
+                    return ValueType::BOOLEAN;
+                }
+                if (dynamic_cast<ast::ArithmeticOperation*>(expr))
+                {
+                    return ValueType::INTEGER;
+                }
+                if (auto callable = dynamic_cast<ast::Callable*>(expr))
+                {
+                    switch (callable->getKind())
+                    {
+                        case ast::Callable::Kind::SIZE: return ValueType::INTEGER;
+                        case ast::Callable::Kind::COUNT: return ValueType::INTEGER;
+                        case ast::Callable::Kind::CONTAINS: return ValueType::BOOLEAN;
+                        case ast::Callable::Kind::UP_FROM: return ValueType::LIST;
+                        case ast::Callable::Kind::COLLECT: return ValueType::LIST;
+                        case ast::Callable::Kind::FILTER: return ValueType::LIST;
+                        case ast::Callable::Kind::UNIQUE: return ValueType::LIST;
+                        // The chosen element, which could be anything
+                        case ast::Callable::Kind::MAX_BY: return ValueType::UNKNOWN;
+                        case ast::Callable::Kind::MIN_BY: return ValueType::UNKNOWN;
+                    }
+                }
+                // Attributes are read out of Maps, whose values can be anything
+                return ValueType::UNKNOWN;
+            }
+
+            // The type of the elements of the list `expr` evaluates to,
+            // nullopt if it's known to be empty
+            std::optional<ValueType>
+            elementTypeOf(ast::Expression* expr) const
+            {
+                if (auto callable = dynamic_cast<ast::Callable*>(expr))
+                {
+                    if (callable->getKind() == ast::Callable::Kind::UP_FROM)
+                    {
+                        return ValueType::INTEGER;
+                    }
+                    // A subset of the target's elements
+                    if (callable->getKind() == ast::Callable::Kind::FILTER
+                        || callable->getKind() == ast::Callable::Kind::UNIQUE)
+                    {
+                        return elementTypeOf(callable->getLeft());
+                    }
+                }
+                if (auto constant = ast::castExpressionToConstant(expr))
+                {
+                    Value value = constant->getValue();
+                    if (!value.isList())
+                    {
+                        return ValueType::UNKNOWN;
+                    }
+                    std::optional<ValueType> elementType;
+                    for (const Value& element : value.asList().value)
+                    {
+                        elementType = join(elementType, element.getType());
+                    }
+                    return elementType;
+                }
+                return ValueType::UNKNOWN;
+            }
+
+            static ValueType
+            join(std::optional<ValueType> current, ValueType type)
+            {
+                if (!current || *current == type)
+                {
+                    return type;
+                }
+                return ValueType::UNKNOWN;
+            }
+
+            void
+            define(ast::Expression* target, std::optional<ValueType> type)
+            {
+                // Assigning to an attribute leaves its variable a Map
+                auto variable = ast::castExpressionToVariable(target);
+                if (!variable)
+                {
+                    return;
+                }
+                if (m_namesOnly)
+                {
+                    m_assigned.insert(variable->getName().name);
+                    return;
+                }
+                if (!type)
+                {
+                    return;
+                }
+
+                auto [it, inserted] = m_variables.try_emplace(variable->getName().name, *type);
+                if (inserted)
+                {
+                    m_changed = true;
+                }
+                else if (ValueType joined = join(it->second, *type); joined != it->second)
+                {
+                    it->second = joined;
+                    m_changed = true;
+                }
+            }
+
+            void
+            collectDefinitions(std::span<ast::Statement* const> statements)
+            {
+                for (ast::Statement* statement : statements)
+                {
+                    if (auto assignment = dynamic_cast<ast::Assignment*>(statement))
+                    {
+                        define(assignment->getTarget(), typeOf(assignment->getValue()));
+                    }
+                    else if (auto forLoop = ast::castStatementToForLoop(statement))
+                    {
+                        define(forLoop->getElement(), elementTypeOf(forLoop->getTarget()));
+                        collectDefinitions(forLoop->getStatements());
+                    }
+                    else if (auto parallelFor = ast::castStatementToParallelFor(statement))
+                    {
+                        define(parallelFor->getElement(), elementTypeOf(parallelFor->getTarget()));
+                        collectDefinitions(parallelFor->getStatements());
+                    }
+                    else if (auto match = ast::castStatementToMatch(statement))
+                    {
+                        for (const auto& candidate : match->getCandidates())
+                        {
+                            collectDefinitions(candidate.statements);
+                        }
+                    }
+                    else if (auto inputText = dynamic_cast<ast::InputText*>(statement))
+                    {
+                        define(inputText->getTarget(), ValueType::STRING);
+                    }
+                    else if (auto inputChoice = dynamic_cast<ast::InputChoice*>(statement))
+                    {
+                        define(inputChoice->getTarget(), ValueType::STRING);
+                    }
+                    else if (auto inputRange = dynamic_cast<ast::InputRange*>(statement))
+                    {
+                        define(inputRange->getTarget(), ValueType::INTEGER);
+                    }
+                    else if (auto inputVote = dynamic_cast<ast::InputVote*>(statement))
+                    {
+                        define(inputVote->getTarget(), ValueType::STRING);
+                    }
+                }
+            }
+
+            void
+            annotate(ast::Expression* expr)
+            {
+                if (!expr)
+                {
+                    return;
+                }
+                expr->setStaticType(typeOf(expr).value_or(ValueType::UNKNOWN));
+
+                if (auto attribute = ast::castExpressionToAttribute(expr))
+                {
+                    annotate(attribute->getBase());
+                }
+                else if (auto comparison = dynamic_cast<ast::Comparison*>(expr))
+                {
+                    annotate(comparison->getLeft());
+                    annotate(comparison->getRight());
+                }
+                else if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+                {
+                    annotate(logicalOp->getLeft());
+                    annotate(logicalOp->getRight());
+                }
+                else if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+                {
+                    annotate(arithmeticOp->getLeft());
+                    annotate(arithmeticOp->getRight());
+                }
+                else if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+                {
+                    annotate(unaryOp->getTarget());
+                }
+                else if (auto callable = dynamic_cast<ast::Callable*>(expr))
+                {
+                    annotate(callable->getLeft());
+                    for (ast::Expression* arg : callable->getArgs())
+                    {
+                        annotate(arg);
+                    }
+                }
+            }
+
+            void
+            annotateStatements(std::span<ast::Statement* const> statements)
+            {
+                for (ast::Statement* statement : statements)
+                {
+                    if (auto assignment = dynamic_cast<ast::Assignment*>(statement))
+                    {
+                        annotate(assignment->getTarget());
+                        annotate(assignment->getValue());
+                    }
+                    else if (auto extend = dynamic_cast<ast::Extend*>(statement))
+                    {
+                        annotate(extend->getTarget());
+                        annotate(extend->getValue());
+                    }
+                    else if (auto reverse = dynamic_cast<ast::Reverse*>(statement))
+                    {
+                        annotate(reverse->getTarget());
+                    }
+                    else if (auto shuffle = dynamic_cast<ast::Shuffle*>(statement))
+                    {
+                        annotate(shuffle->getTarget());
+                    }
+                    else if (auto discard = dynamic_cast<ast::Discard*>(statement))
+                    {
+                        annotate(discard->getTarget());
+                        annotate(discard->getAmount());
+                    }
+                    else if (auto sort = dynamic_cast<ast::Sort*>(statement))
+                    {
+                        annotate(sort->getTarget());
+                    }
+                    else if (auto match = ast::castStatementToMatch(statement))
+                    {
+                        annotate(match->getTarget());
+                        for (const auto& candidate : match->getCandidates())
+                        {
+                            annotate(candidate.expressionCandidate);
+                            annotateStatements(candidate.statements);
+                        }
+                    }
+                    else if (auto forLoop = ast::castStatementToForLoop(statement))
+                    {
+                        annotate(forLoop->getElement());
+                        annotate(forLoop->getTarget());
+                        annotateStatements(forLoop->getStatements());
+                    }
+                    else if (auto parallelFor = ast::castStatementToParallelFor(statement))
+                    {
+                        annotate(parallelFor->getElement());
+                        annotate(parallelFor->getTarget());
+                        annotateStatements(parallelFor->getStatements());
+                    }
+                    else if (auto inputText = dynamic_cast<ast::InputText*>(statement))
+                    {
+                        annotate(inputText->getPlayer());
+                        annotate(inputText->getTarget());
+                    }
+                    else if (auto inputChoice = dynamic_cast<ast::InputChoice*>(statement))
+                    {
+                        annotate(inputChoice->getPlayer());
+                        annotate(inputChoice->getTarget());
+                        annotate(inputChoice->getChoices());
+                    }
+                    else if (auto inputRange = dynamic_cast<ast::InputRange*>(statement))
+                    {
+                        annotate(inputRange->getPlayer());
+                        annotate(inputRange->getTarget());
+                        annotate(inputRange->getMinValue());
+                        annotate(inputRange->getMaxValue());
+                    }
+                    else if (auto inputVote = dynamic_cast<ast::InputVote*>(statement))
+                    {
+                        annotate(inputVote->getPlayer());
+                        annotate(inputVote->getTarget());
+                        annotate(inputVote->getChoices());
+                    }
+                    else if (auto message = ast::castStatementToMessage(statement))
+                    {
+                        annotate(message->getPlayers());
+                        for (const auto& segment : message->getSegments())
+                        {
+                            annotate(segment.expression.get());
+                        }
+                    }
+                }
+            }
+
+        private:
+            ast::VariableTypes m_variables;
+            std::unordered_set<std::string> m_assigned;
+            bool m_namesOnly = false;
+            bool m_changed = false;
+    };
+}
+
+
+ast::VariableTypes
+ast::inferTypes(std::span<ast::Statement* const> statements)
+{
+    return TypeInferrer{}.run(statements);
+}
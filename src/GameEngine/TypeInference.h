@@ -0,0 +1,33 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "Rules.h"
+
+
+namespace ast
+{
+    using VariableTypes = std::unordered_map<std::string, ValueType>;
+
+    /**
+     * @brief Works out the types of a program's expressions before it runs.
+     *
+     * A variable gets a type when every value the program gives it (assignments,
+     * loop elements, input targets) has that same type. Operators, builtins and
+     * input kinds have fixed result types, and constants have their value's.
+     * Each expression whose type is known is marked with setStaticType(), which
+     * lets the interpreter skip its runtime type checks. Everything else is
+     * left UNKNOWN and keeps taking the checked path.
+     *
+     * The pass can't see values the host stores before running the program, so
+     * the host must store only values of the returned types under these names.
+     * A variable only the host stores could hold anything, so it stays UNKNOWN.
+     *
+     * @param statements The program, annotated in place.
+     * @return The type of each variable the program gives a single type.
+     */
+    VariableTypes
+    inferTypes(std::span<Statement* const> statements);
+}
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -13,11 +14,40 @@
 #include <utility>
 #include <functional>
 #include <format>
+#include <optional>
+#include <expected>
+#include <type_traits>
+#include <atomic>
 
 #include <iostream>
 
+#include "Parallel.h"
+
 struct Value;
 
+/// A failure while running a game, such as a type mismatch or a missing
+/// variable. Carried as a value (see Result) so the interpreter can report
+/// it without unwinding.
+struct RuntimeError
+{
+    std::string message;
+};
+
+template <typename T>
+using Result = std::expected<T, RuntimeError>;
+
+/// Returns the result's value, or throws its error as a std::runtime_error.
+/// For callers that still report failures with exceptions.
+template <typename T>
+T valueOrThrow(Result<T> result)
+{
+    if (!result)
+    {
+        throw std::runtime_error(result.error().message);
+    }
+    return std::move(*result);
+}
+
 /// Represents a variable name in the AST.
 /// Used as a key in variable lookups.
 struct Name
@@ -129,7 +159,18 @@ struct List
 
     void extend(const List<T>& list)
     {
-        value.insert(value.end(), list.value.begin(), list.value.end());
+        if (list.value.size() < PARALLEL_LIST_SIZE)
+        {
+            value.insert(value.end(), list.value.begin(), list.value.end());
+            return;
+        }
+
+        // By index, since `list` may be this one
+        size_t start = value.size();
+        value.resize(start + list.value.size());
+        forEachChunk(value.size() - start, [this, &list, start](size_t begin, size_t end) {
+            std::copy(list.value.begin() + begin, list.value.begin() + end, value.begin() + start + begin);
+        });
     }
 
     void reverse()
@@ -178,7 +219,29 @@ struct List
 
     bool operator==(const List<T>& other) const noexcept
     {
-        return value == other.value;
+        if (value.size() < PARALLEL_LIST_SIZE || value.size() != other.value.size())
+        {
+            return value == other.value;
+        }
+
+        std::atomic<bool> equal{true};
+        try
+        {
+            forEachChunk(value.size(), [this, &other, &equal](size_t begin, size_t end) {
+                // Stop early once any chunk differs
+                if (equal.load(std::memory_order_relaxed)
+                    && !std::equal(value.begin() + begin, value.begin() + end, other.value.begin() + begin))
+                {
+                    equal.store(false, std::memory_order_relaxed);
+                }
+            });
+        }
+        catch (...)
+        {
+            // The pool couldn't start its threads, compare here instead
+            return value == other.value;
+        }
+        return equal.load();
     }
 };
 
@@ -234,6 +297,10 @@ struct Map
     }
 };
 
+/// The alternatives of Value, in the same order, plus UNKNOWN
+/// for when a type can't be determined ahead of time.
+enum class ValueType { LIST, MAP, STRING, INTEGER, BOOLEAN, UNKNOWN };
+
 /// Represents any value.
 /// A value may be a List, Map, or String, and can be accessed
 /// through the asString(), asMap(), asList() methods respectively.
@@ -325,6 +392,69 @@ struct Value
         return const_cast<Map<String, Value>&>(std::as_const(*this).asMap());
     }
 
+    ValueType getType() const noexcept
+    {
+        return static_cast<ValueType>(value.index());
+    }
+
+    /// Like asInteger() and the rest, but without the type check.
+    /// Only for callers that already know the type, see TypeInference.h.
+    template <typename T>
+    const T& asUnchecked() const noexcept
+    {
+        assert(std::holds_alternative<T>(value));
+        return *std::get_if<T>(&value);
+    }
+
+    /// Like asInteger() and the rest, but a type mismatch is returned
+    /// as an error instead of thrown.
+    template <typename T>
+    Result<const T*> tryAs() const
+    {
+        if (const T* alternative = std::get_if<T>(&value))
+        {
+            return alternative;
+        }
+        return std::unexpected(RuntimeError{std::string{"Value is not "} + describeType<T>()});
+    }
+
+    template <typename T>
+    Result<T*> tryAs()
+    {
+        if (T* alternative = std::get_if<T>(&value))
+        {
+            return alternative;
+        }
+        return std::unexpected(RuntimeError{std::string{"Value is not "} + describeType<T>()});
+    }
+
+    /// Like getAttribute(), but a non-Map value or a missing attribute
+    /// is returned as an error instead of thrown.
+    Result<const Value*> findAttribute(const String& attr) const
+    {
+        const auto* map = std::get_if<Map<String, Value>>(&value);
+        if (!map)
+        {
+            return std::unexpected(RuntimeError{"Only Maps have attributes"});
+        }
+        auto it = map->value.find(attr);
+        if (it == map->value.end())
+        {
+            return std::unexpected(RuntimeError{"Attribute does not exist in Map"});
+        }
+        return &it->second;
+    }
+
+    Result<Value*> findAttribute(const String& attr)
+    {
+        auto found = std::as_const(*this).findAttribute(attr);
+        if (!found)
+        {
+            return std::unexpected(std::move(found.error()));
+        }
+        return const_cast<Value*>(*found);
+    }
+
     /// Gets the value at an attribute from a Map.
     ///
     /// Throws if called on a non-Map type or the attribute isn't set.
@@ -366,6 +496,16 @@ struct Value
         return os;
     }
 
+    template <typename T>
+    static constexpr const char* describeType()
+    {
+        if constexpr (std::is_same_v<T, String>) { return "a String"; }
+        else if constexpr (std::is_same_v<T, Integer>) { return "an Integer"; }
+        else if constexpr (std::is_same_v<T, Boolean>) { return "a Boolean"; }
+        else if constexpr (std::is_same_v<T, List<Value>>) { return "a List"; }
+        else { return "a Map"; }
+    }
+
     bool operator==(const Value& other) const noexcept
     {
         if (isString() && other.isString()) { return asString() == other.asString(); }
@@ -394,73 +534,133 @@ inline std::optional<bool> maybeCompareValues(const Value& lhs, const Value& rhs
     return std::nullopt;
 }
 
-inline bool doLogicalOr(const Value& a, const Value& b)
+inline Result<bool> tryLogicalOr(const Value& a, const Value& b)
 {
     // For now, only booleans
     // TODO: Support truthy for more flexibility? Could look like:
     // return isTruthy(a) || isTruthy(b)
-    return a.asBoolean().value || b.asBoolean().value;
+    auto left = a.tryAs<Boolean>();
+    if (!left) { return std::unexpected(left.error()); }
+    auto right = b.tryAs<Boolean>();
+    if (!right) { return std::unexpected(right.error()); }
+
+    return (*left)->value || (*right)->value;
 }
 
-inline bool doUnaryNot(const Value& a)
+inline bool doLogicalOr(const Value& a, const Value& b)
+{
+    return valueOrThrow(tryLogicalOr(a, b));
+}
+
+inline Result<bool> tryUnaryNot(const Value& a)
 {
     // For now, only booleans
     // TODO: Support truthy for more flexibility? Could look like:
     // return !isTruthy(a);
-    return !(a.asBoolean().value);
+    auto target = a.tryAs<Boolean>();
+    if (!target) { return std::unexpected(target.error()); }
+
+    return !(*target)->value;
 }
 
-inline Value doArithmeticAdd(const Value& a, const Value& b)
+inline bool doUnaryNot(const Value& a)
+{
+    return valueOrThrow(tryUnaryNot(a));
+}
+
+inline Result<Value> tryArithmeticAdd(const Value& a, const Value& b)
 {
     // For now, only integers
-    return Value{Integer{a.asInteger().value + b.asInteger().value}};
+    auto left = a.tryAs<Integer>();
+    if (!left) { return std::unexpected(left.error()); }
+    auto right = b.tryAs<Integer>();
+    if (!right) { return std::unexpected(right.error()); }
+
+    return Value{Integer{(*left)->value + (*right)->value}};
 }
 
-inline List<Value> sortList(const List<Value>& list, std::optional<String> key = {})
+inline Value doArithmeticAdd(const Value& a, const Value& b)
 {
-    List<Value> listCopy = list;
+    return valueOrThrow(tryArithmeticAdd(a, b));
+}
+
+/// Sorts a copy of `list`, or returns an error if its elements (or their
+/// values at `key`) can't all be compared with each other. Checked up front
+/// so the sort itself never has to bail out.
+inline Result<List<Value>> trySortList(const List<Value>& list, std::optional<String> key = {})
+{
+    if (list.value.size() < 2)
+    {
+        return list;
+    }
 
-    std::sort(listCopy.value.begin(), listCopy.value.end(),
-        [&key](const Value& lhs, const Value &rhs)
+    auto sortKey = [&key](const Value& element) -> const Value* {
+        if (!key.has_value())
         {
-            if (key.has_value())
-            {
-                // List elements are treated as maps, and values of the key are compared
-                const Value& lhsValue = lhs.getAttribute(*key);
-                const Value& rhsValue = rhs.getAttribute(*key);
+            return &element;
+        }
+        auto* map = std::get_if<Map<String, Value>>(&element.value);
+        if (!map)
+        {
+            return nullptr;
+        }
+        auto it = map->value.find(*key);
+        return it == map->value.end() ? nullptr : &it->second;
+    };
 
-                auto res = maybeCompareValues(lhsValue, rhsValue);
-                if (res.has_value())
-                {
-                    return *res;
-                }
-            }
-            else
-            {
-                // Otherwise, try to compare values directly
-                auto res = maybeCompareValues(lhs, rhs);
-                if (res.has_value())
-                {
-                    return *res;
-                }
-            }
-            // If reached here, types couldn't be compared
-            throw std::runtime_error(
-                "List is not sortable because element types are not comparable"
+    // Values are only comparable with values of the same type, which must
+    // be one maybeCompareValues() handles
+    std::optional<ValueType> keyType;
+    for (const Value& element : list.value)
+    {
+        const Value* elementKey = sortKey(element);
+        if (!elementKey)
+        {
+            return std::unexpected(RuntimeError{"List is not sortable because an element has no sort key"});
+        }
+
+        ValueType type = elementKey->getType();
+        bool isComparable = type == ValueType::STRING || type == ValueType::INTEGER || type == ValueType::BOOLEAN;
+        if (!isComparable || (keyType.has_value() && *keyType != type))
+        {
+            return std::unexpected(
+                RuntimeError{"List is not sortable because element types are not comparable"}
             );
         }
-    );
+        keyType = type;
+    }
+
+    List<Value> listCopy;
+    listCopy.extend(list);
+
+    auto compare = [&sortKey](const Value& lhs, const Value &rhs)
+    {
+        return *maybeCompareValues(*sortKey(lhs), *sortKey(rhs));
+    };
+    if (listCopy.value.size() < PARALLEL_LIST_SIZE)
+    {
+        std::sort(listCopy.value.begin(), listCopy.value.end(), compare);
+    }
+    else
+    {
+        parallelSort(listCopy.value.begin(), listCopy.value.end(), compare);
+    }
 
     return listCopy;
 }
 
-inline List<Value> upFrom(int from, int to)
+inline List<Value> sortList(const List<Value>& list, std::optional<String> key = {})
+{
+    return valueOrThrow(trySortList(list, std::move(key)));
+}
+
+inline Result<List<Value>> tryUpFrom(int from, int to)
 {
     if (from > to)
     {
-        throw std::runtime_error(
+        return std::unexpected(RuntimeError{
             std::format("upfrom: 'from' ({}) cannot be greater than 'to' ({})", from, to)
-        );
+        });
     }
 
     List<Value> list;
@@ -472,3 +672,8 @@ inline List<Value> upFrom(int from, int to)
 
     return list;
 }
+
+inline List<Value> upFrom(int from, int to)
+{
+    return valueOrThrow(tryUpFrom(from, to));
+}
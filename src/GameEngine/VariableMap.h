@@ -1,34 +1,95 @@
 #include "Types.h"
+#include <memory>
 #include <stdexcept>
 #include <format>
 
-// TODO: add a bit of documentation
-
+/**
+ * A game's variables, by name.
+ *
+ * Copies are copy-on-write, so forking a game's state is O(1): the copy
+ * shares the table and every value with the original until one side
+ * changes something. The first change to a shared table copies its
+ * pointers, and the first mutable access to a shared value copies that
+ * value, leaving the other side untouched. Reads through read() copy
+ * nothing.
+ */
 class VariableMap
 {
     public:
-        void store(Name varName, const Value& value)
+        using Entries = std::unordered_map<Name, std::shared_ptr<Value>>;
+
+        /// Returns true if the variable is new
+        bool store(Name varName, Value value)
         {
-            auto valuePtr = std::make_unique<Value>(value);
-            m_map[varName] = std::move(valuePtr);
+            detach();
+            return m_map->insert_or_assign(std::move(varName), std::make_shared<Value>(std::move(value))).second;
         }
 
         Value* load(Name varName)
         {
-            if (!m_map.contains(varName))
+            return valueOrThrow(find(varName));
+        }
+
+        /// Like load(), but a missing variable is returned as an error
+        Result<Value*> find(const Name& varName)
+        {
+            auto it = m_map->find(varName);
+            if (it == m_map->end())
+            {
+                return std::unexpected(missing(varName));
+            }
+
+            // The caller may change the value, so it can't stay shared
+            if (m_map.use_count() > 1)
+            {
+                detach();
+                it = m_map->find(varName);
+            }
+            if (it->second.use_count() > 1)
+            {
+                it->second = std::make_shared<Value>(*it->second);
+            }
+            return it->second.get();
+        }
+
+        /// Like find(), for reading: the value stays shared with any copies
+        Result<const Value*> read(const Name& varName) const
+        {
+            auto it = m_map->find(varName);
+            if (it == m_map->end())
             {
-                throw std::runtime_error(
-                    std::format("Variable with name '{}' doesn't exist in map", varName.name)
-                );
+                return std::unexpected(missing(varName));
             }
-            return m_map[varName].get();
+            return it->second.get();
         }
 
         void del(Name varName)
         {
-            m_map.erase(varName);
+            detach();
+            m_map->erase(varName);
+        }
+
+        const Entries& entries() const
+        {
+            return *m_map;
         }
 
     private:
-        std::unordered_map<Name, std::unique_ptr<Value>> m_map;
+        static RuntimeError missing(const Name& varName)
+        {
+            return RuntimeError{
+                std::format("Variable with name '{}' doesn't exist in map", varName.name)
+            };
+        }
+
+        /// Gives this map its own table, if it's sharing one
+        void detach()
+        {
+            if (m_map.use_count() > 1)
+            {
+                m_map = std::make_shared<Entries>(*m_map);
+            }
+        }
+
+        std::shared_ptr<Entries> m_map = std::make_shared<Entries>();
 };
@@ -0,0 +1,227 @@
+#include <format>
+
+#include "Verifier.h"
+
+
+namespace
+{
+    // Stops at the first problem, which is kept in m_error
+    class StructureVerifier
+    {
+        public:
+            std::optional<RuntimeError>
+            run(std::span<ast::Statement* const> statements)
+            {
+                verifyStatements(statements);
+                return std::move(m_error);
+            }
+
+        private:
+            bool
+            fail(std::string message)
+            {
+                if (!m_error)
+                {
+                    m_error = RuntimeError{std::move(message)};
+                }
+                return false;
+            }
+
+            static bool
+            isReference(ast::Expression* expr)
+            {
+                return ast::castExpressionToVariable(expr) || ast::castExpressionToAttribute(expr);
+            }
+
+            // A target the interpreter resolves to a reference and writes to
+            bool
+            verifyTarget(ast::Expression* expr, const char* what)
+            {
+                if (!isReference(expr))
+                {
+                    return fail(std::format("{} must be a Variable or an Attribute", what));
+                }
+                return verify(expr);
+            }
+
+            bool
+            verify(ast::Expression* expr)
+            {
+                if (!expr)
+                {
+                    return fail("Expression is missing");
+                }
+
+                if (auto attribute = ast::castExpressionToAttribute(expr))
+                {
+                    return verifyTarget(attribute->getBase(), "Attribute base");
+                }
+                else if (auto comparison = dynamic_cast<ast::Comparison*>(expr))
+                {
+                    return verify(comparison->getLeft()) && verify(comparison->getRight());
+                }
+                else if (auto logicalOp = dynamic_cast<ast::LogicalOperation*>(expr))
+                {
+                    return verify(logicalOp->getLeft()) && verify(logicalOp->getRight());
+                }
+                else if (auto arithmeticOp = dynamic_cast<ast::ArithmeticOperation*>(expr))
+                {
+                    return verify(arithmeticOp->getLeft()) && verify(arithmeticOp->getRight());
+                }
+                else if (auto unaryOp = dynamic_cast<ast::UnaryOperation*>(expr))
+                {
+                    return verify(unaryOp->getTarget());
+                }
+                else if (auto callable = dynamic_cast<ast::Callable*>(expr))
+                {
+                    size_t expected = ast::builtinArity(callable->getKind());
+                    if (callable->getArgCount() != expected)
+                    {
+                        return fail(std::format("{}() expects {} arg(s), got {}",
+                                                ast::builtinName(callable->getKind()), expected, callable->getArgCount()));
+                    }
+                    for (ast::Expression* arg : callable->getArgs())
+                    {
+                        if (!verify(arg))
+                        {
+                            return false;
+                        }
+                    }
+                    return verify(callable->getLeft());
+                }
+                return true;
+            }
+
+            bool
+            verifyStatements(std::span<ast::Statement* const> statements)
+            {
+                for (ast::Statement* statement : statements)
+                {
+                    if (!statement)
+                    {
+                        return fail("Statement is missing");
+                    }
+                    if (!verifyStatement(*statement))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool
+            verifyStatement(ast::Statement& statement)
+            {
+                if (auto assignment = dynamic_cast<ast::Assignment*>(&statement))
+                {
+                    return verifyTarget(assignment->getTarget(), "Assignment target")
+                        && verify(assignment->getValue());
+                }
+                else if (auto extend = dynamic_cast<ast::Extend*>(&statement))
+                {
+                    return verifyTarget(extend->getTarget(), "Extend target") && verify(extend->getValue());
+                }
+                else if (auto reverse = dynamic_cast<ast::Reverse*>(&statement))
+                {
+                    return verifyTarget(reverse->getTarget(), "Reverse target");
+                }
+                else if (auto shuffle = dynamic_cast<ast::Shuffle*>(&statement))
+                {
+                    return verifyTarget(shuffle->getTarget(), "Shuffle target");
+                }
+                else if (auto discard = dynamic_cast<ast::Discard*>(&statement))
+                {
+                    return verifyTarget(discard->getTarget(), "Discard target") && verify(discard->getAmount());
+                }
+                else if (auto sort = dynamic_cast<ast::Sort*>(&statement))
+                {
+                    return verifyTarget(sort->getTarget(), "Sort target");
+                }
+                else if (auto match = ast::castStatementToMatch(&statement))
+                {
+                    if (!verify(match->getTarget()))
+                    {
+                        return false;
+                    }
+                    for (const auto& candidate : match->getCandidates())
+                    {
+                        if (!verify(candidate.expressionCandidate) || !verifyStatements(candidate.statements))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                else if (auto forLoop = ast::castStatementToForLoop(&statement))
+                {
+                    return verifyTarget(forLoop->getElement(), "Loop element")
+                        && verify(forLoop->getTarget())
+                        && verifyStatements(forLoop->getStatements());
+                }
+                else if (auto parallelFor = ast::castStatementToParallelFor(&statement))
+                {
+                    return verifyTarget(parallelFor->getElement(), "Loop element")
+                        && verify(parallelFor->getTarget())
+                        && verifyStatements(parallelFor->getStatements());
+                }
+                else if (auto inputText = dynamic_cast<ast::InputText*>(&statement))
+                {
+                    return verify(inputText->getPlayer()) && verifyTarget(inputText->getTarget(), "Input target");
+                }
+                else if (auto inputChoice = dynamic_cast<ast::InputChoice*>(&statement))
+                {
+                    return verify(inputChoice->getPlayer())
+                        && verifyTarget(inputChoice->getTarget(), "Input target")
+                        && verify(inputChoice->getChoices());
+                }
+                else if (auto inputRange = dynamic_cast<ast::InputRange*>(&statement))
+                {
+                    return verify(inputRange->getPlayer())
+                        && verifyTarget(inputRange->getTarget(), "Input target")
+                        && verify(inputRange->getMinValue())
+                        && verify(inputRange->getMaxValue());
+                }
+                else if (auto inputVote = dynamic_cast<ast::InputVote*>(&statement))
+                {
+                    return verify(inputVote->getPlayer())
+                        && verifyTarget(inputVote->getTarget(), "Input target")
+                        && verify(inputVote->getChoices());
+                }
+                else if (auto message = ast::castStatementToMessage(&statement))
+                {
+                    // No players means everyone
+                    if (message->getPlayers() && !verify(message->getPlayers()))
+                    {
+                        return false;
+                    }
+                    for (const auto& segment : message->getSegments())
+                    {
+                        if (segment.expression && !verify(segment.expression.get()))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                else if (auto scores = ast::castStatementToScores(&statement))
+                {
+                    if (scores->getKeys().empty())
+                    {
+                        return fail("Scores needs at least one attribute");
+                    }
+                    return true;
+                }
+                return true;
+            }
+
+        private:
+            std::optional<RuntimeError> m_error;
+    };
+}
+
+
+std::optional<RuntimeError>
+ast::verifyStructure(std::span<ast::Statement* const> statements)
+{
+    return StructureVerifier{}.run(statements);
+}
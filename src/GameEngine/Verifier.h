@@ -0,0 +1,26 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include "Rules.h"
+
+
+namespace ast
+{
+    /**
+     * @brief Checks a program's structure once, before it runs.
+     *
+     * Proves what the interpreter would otherwise re-check on every visit:
+     * operands are present, attribute bases and assignment, list and input
+     * targets are Variables or Attributes (so they resolve to references),
+     * builtins get the right number of arguments, and scores name at least
+     * one attribute. A Program whose statements pass can be marked verified,
+     * letting the interpreter skip those checks.
+     *
+     * @param statements The program, including nested bodies.
+     * @return The first problem found, or nullopt if there is none.
+     */
+    std::optional<RuntimeError>
+    verifyStructure(std::span<Statement* const> statements);
+}
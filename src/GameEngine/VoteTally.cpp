@@ -0,0 +1,109 @@
+#include "VoteTally.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+
+VoteTally::VoteTally(std::vector<String> choices, size_t voterCount)
+    : m_voterCount(voterCount)
+{
+    m_choiceIndex.reserve(choices.size());
+    for (String& choice : choices)
+    {
+        // A repeated choice keeps its first position
+        if (m_choiceIndex.try_emplace(choice, m_choices.size()).second)
+        {
+            m_choices.push_back(std::move(choice));
+        }
+    }
+    if (m_choices.empty())
+    {
+        throw std::invalid_argument("A vote needs at least one choice");
+    }
+    m_counts.assign(m_choices.size(), 0);
+
+    if (m_choices.size() > 1)
+    {
+        m_runnerUp = 1;
+    }
+}
+
+bool
+VoteTally::cast(const String& choice)
+{
+    auto it = m_choiceIndex.find(choice);
+    if (it == m_choiceIndex.end() || getVotesRemaining() == 0)
+    {
+        return false;
+    }
+    size_t voted = it->second;
+
+    m_counts[voted]++;
+    m_votesCast++;
+
+    // Only `voted` moved up, so it can only overtake the runner-up or the leader
+    if (voted == m_leader)
+    {
+        return true;
+    }
+    if (isAhead(voted, m_leader))
+    {
+        m_runnerUp = m_leader;
+        m_leader = voted;
+    }
+    else if (voted != *m_runnerUp && isAhead(voted, *m_runnerUp))
+    {
+        m_runnerUp = voted;
+    }
+    return true;
+}
+
+size_t
+VoteTally::getCount(const String& choice) const
+{
+    auto it = m_choiceIndex.find(choice);
+    return it == m_choiceIndex.end() ? 0 : m_counts[it->second];
+}
+
+bool
+VoteTally::isDecided() const
+{
+    if (!m_runnerUp)
+    {
+        return true;
+    }
+    // Strictly ahead, so a tie in the remaining votes can't go either way.
+    // Every other choice trails the runner-up, so it's the only threat.
+    return m_counts[m_leader] > m_counts[*m_runnerUp] + getVotesRemaining();
+}
+
+std::vector<std::pair<String, size_t>>
+VoteTally::top(size_t k) const
+{
+    std::vector<size_t> order(m_choices.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    k = std::min(k, order.size());
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), [this](size_t a, size_t b) {
+        return isAhead(a, b);
+    });
+
+    std::vector<std::pair<String, size_t>> ranked;
+    ranked.reserve(k);
+    for (size_t i = 0; i < k; ++i)
+    {
+        ranked.emplace_back(m_choices[order[i]], m_counts[order[i]]);
+    }
+    return ranked;
+}
+
+bool
+VoteTally::isAhead(size_t a, size_t b) const
+{
+    if (m_counts[a] != m_counts[b])
+    {
+        return m_counts[a] > m_counts[b];
+    }
+    return a < b;
+}
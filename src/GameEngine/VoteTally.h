@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Types.h"
+
+
+/**
+ * Running counts for a vote among many players.
+ *
+ * Votes are counted as they arrive, O(1) each, and nothing is kept per
+ * voter: the tally only knows how many votes each choice has and how many
+ * are still to come. The leader and runner-up are maintained alongside the
+ * counts, so the vote can close as soon as the remaining votes couldn't
+ * change the winner.
+ *
+ * Ties go to the choice listed first.
+ */
+class VoteTally
+{
+    public:
+        /// `choices` are the options in the order they were offered, a
+        /// repeated one counts once. Throws std::invalid_argument if empty.
+        VoteTally(std::vector<String> choices, size_t voterCount);
+
+        /// Counts one vote. Returns false, counting nothing, if `choice`
+        /// isn't one of the options or every voter has voted already.
+        bool cast(const String& choice);
+
+        size_t getVotesCast() const { return m_votesCast; }
+        size_t getVotesRemaining() const { return m_voterCount - m_votesCast; }
+        size_t getCount(const String& choice) const;
+
+        /// True once the remaining votes can't change the winner
+        bool isDecided() const;
+        /// True once everyone has voted or the winner is decided
+        bool isClosed() const { return getVotesRemaining() == 0 || isDecided(); }
+
+        /// The choice with the most votes so far
+        const String& getWinner() const { return m_choices[m_leader]; }
+
+        /// The `k` choices with the most votes, most first
+        std::vector<std::pair<String, size_t>> top(size_t k) const;
+
+        const std::vector<String>& getChoices() const { return m_choices; }
+
+    private:
+        /// True if choice `a` is ahead of choice `b`
+        bool isAhead(size_t a, size_t b) const;
+
+    private:
+        std::vector<String> m_choices;
+        std::unordered_map<String, size_t> m_choiceIndex;
+        std::vector<size_t> m_counts;
+        size_t m_voterCount;
+        size_t m_votesCast = 0;
+        size_t m_leader = 0;
+        std::optional<size_t> m_runnerUp; // unset with a single choice
+};
@@ -2,6 +2,7 @@
 #include "GameServer.h"
 #include "Message.h"
 #include <unordered_map>
+#include <stdexcept>
 
 namespace{
     std::string gameTypeToString(GameType type) {
@@ -209,7 +210,7 @@ GameServer::handleCreationInput(uintptr_t clientID, const Message& creationInput
                     "[1] Number Battle\n"
                     "[2] Choice Battle\n"
                     "(Enter 1 or 2):",
-                    {"1", "2"}
+                    std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"1", "2"})
             };
             return {ClientMessage{clientID, request}};
         }
@@ -569,12 +570,17 @@ GameServer::handleStartGameMessages(uintptr_t clientID, const StartGameMessage&
         return {ClientMessage{clientID, errorMsg}};
     }
 
-    /// 6. create game rules
-    ast::GameRules rules = createGameRules(lobby->getInfo().gameType);
+    /// 6. get the compiled game, shared with other sessions of its type
+    SharedProgram program = getCompiledGame(lobby->getInfo().gameType);
 
     /// 7. create and start session
     auto players = lobby->getAllPlayer();
-    auto session = std::make_unique<GameSession>(*lobbyID, std::move(rules), players);
+    auto session = std::make_unique<GameSession>(*lobbyID, std::move(program), players);
+    session->setStepBudget(m_sessionStepBudget);
+    if (m_profilingEnabled) {
+        session->enableProfiling();
+        m_sessionGameTypes[*lobbyID] = lobby->getInfo().gameType;
+    }
     std::vector<ClientMessage> initialGameMessages = session->start();
 
     /// 8. map and track this session
@@ -642,7 +648,15 @@ GameServer::tick(const std::vector<ClientMessage> &incomingMessages) {
     auto it = m_activeSessions.begin();
     while(it != m_activeSessions.end()){
         if(it->second->isFinished()){
-            std::cout << "[GameServer] Session " << it->first << " finished and get cleaned\n";
+            const auto& stats = it->second->getExecutionStats();
+            std::cout << "[GameServer] Session " << it->first << " finished and get cleaned"
+                      << " (" << stats.steps << " steps, " << stats.yields << " yields, "
+                      << stats.budgetExceeded << " over budget)\n";
+
+            if (const Profiler* profile = it->second->getProfiler()) {
+                m_gameProfiles[m_sessionGameTypes[it->first]].merge(*profile);
+                m_sessionGameTypes.erase(it->first);
+            }
             it = m_activeSessions.erase(it);
         } else{
             /// check if it has input waiting for this specific lobby
@@ -667,6 +681,28 @@ GameServer::tick(const std::vector<ClientMessage> &incomingMessages) {
     return outgoing;
 }
 
+void
+GameServer::setSessionStepBudget(std::optional<size_t> budget) {
+    // Caught here rather than when the next session starts
+    if (budget == 0) {
+        throw std::invalid_argument("A step budget must allow at least one statement");
+    }
+    m_sessionStepBudget = budget;
+}
+
+void
+GameServer::setProfilingEnabled(bool enabled) {
+    m_profilingEnabled = enabled;
+}
+
+void
+GameServer::dumpProfiles(std::ostream& out) const {
+    for (const auto& [type, profile] : m_gameProfiles) {
+        out << "[GameServer] Profile for " << gameTypeToString(type) << "\n";
+        profile.dump(out);
+    }
+}
+
 bool
 GameServer::isGameInputMessage(const Message &msg) const {
     switch(msg.type){
@@ -844,6 +880,16 @@ GameServer::createChoiceBattleRules(){
     return ast::GameRules{std::move(statements)};
 }
 
+SharedProgram
+GameServer::getCompiledGame(GameType type) {
+    if (auto it = m_compiledGames.find(type); it != m_compiledGames.end()) {
+        return it->second;
+    }
+    SharedProgram program = GameSession::compileRules(createGameRules(type));
+    m_compiledGames.emplace(type, program);
+    return program;
+}
+
 ast::GameRules
 GameServer::createGameRules(GameType type) {
     std::cout << "[GameServer] Creating rules for GameType: " << (int)type << "\n";
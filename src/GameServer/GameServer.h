@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory.h>
+#include <optional>
+#include <ostream>
 #include <unordered_map>
 #include <vector>
 #include "Message.h"
@@ -37,17 +39,38 @@ public:
 
     std::vector<ClientMessage> handleStartJoinLobbyMessages(uintptr_t clientID);
     std::vector<ClientMessage> handleJoinInput(uintptr_t clientID, const Message& joinInput);
+
+    /// Step budget applied to sessions started after this call, none for no
+    /// cap. Sessions have none unless this opts in. Throws
+    /// std::invalid_argument for 0.
+    void setSessionStepBudget(std::optional<size_t> budget);
+
+    /// Profile sessions started after this call, see Profiler
+    void setProfilingEnabled(bool enabled);
+    /// Writes the profiles of finished sessions, aggregated per game type
+    void dumpProfiles(std::ostream& out) const;
+
+    /// The built-in rule set for a game type, also used by the headless simulator
+    static ast::GameRules createGameRules(GameType type);
+    static ast::GameRules createNumberBattleRules();
+    static ast::GameRules createChoiceBattleRules();
 private:
+    std::optional<size_t> m_sessionStepBudget;
+
+    bool m_profilingEnabled = false;
+    std::unordered_map<LobbyID, GameType> m_sessionGameTypes;
+    std::unordered_map<GameType, Profiler> m_gameProfiles;
+
     LobbyRegistry m_lobbyRegistry;
     std::unordered_map<LobbyID, std::unique_ptr<GameSession>> m_activeSessions;
 
-    ast::GameRules createGameRules(GameType type);
+    /// Each game type is compiled once, on first start, and shared by its sessions
+    std::unordered_map<GameType, SharedProgram> m_compiledGames;
+
+    SharedProgram getCompiledGame(GameType type);
     ast::GameRules loadRulesFromFile(const std::string& filepath);
     bool isGameInputMessage(const Message& msg) const;
 
-    ast::GameRules createNumberBattleRules();
-    ast::GameRules createChoiceBattleRules();
-
     /// helper functions
     Message createLobbyStateMessage(const Lobby* lobby) const;
     Lobby* getLobbyForClient(uintptr_t clientID) const;
@@ -5,9 +5,13 @@
 #include <utility>
 
 GameSession::GameSession(LobbyID lobbyID, ast::GameRules rules, std::vector<LobbyMember> players)
+    : GameSession(std::move(lobbyID), compileRules(std::move(rules)), std::move(players))
+    {}
+
+GameSession::GameSession(LobbyID lobbyID, SharedProgram program, std::vector<LobbyMember> players)
     : m_lobbyID(std::move(lobbyID))
     , m_players(std::move(players))
-    , m_interpreter(m_inputManager, convertRulesToProgram(rules))
+    , m_interpreter(m_inputManager, std::move(program))
     {
         // caches player lookups
         m_playerLookup.reserve(m_players.size() * 2);
@@ -35,6 +39,21 @@ GameSession::GameSession(LobbyID lobbyID, ast::GameRules rules, std::vector<Lobb
     std::cout << "[GameSession] Created session for lobby " << m_lobbyID
               << " with " << m_players.size() << " players\n";}
 
+GameSession::GameSession(const GameSession& source, ForkTag)
+    : m_lobbyID(source.m_lobbyID)
+    , m_players(source.m_players)
+    , m_playerIDs(source.m_playerIDs)
+    , m_playerLookup(source.m_playerLookup)
+    , m_interpreter(m_inputManager, source.m_interpreter.getProgram()) {
+    m_interpreter.forkFrom(source.m_interpreter);
+    m_interpreter.setStepBudget(source.m_interpreter.getStepBudget());
+}
+
+std::unique_ptr<GameSession>
+GameSession::fork() const {
+    return std::unique_ptr<GameSession>(new GameSession(*this, ForkTag{}));
+}
+
 std::vector<ClientMessage>
 GameSession::start() {
     std::cout << "[GameSession] Starting game execution\n";
@@ -60,14 +79,43 @@ GameSession::start() {
 
 bool
 GameSession::isFinished() const {
-    return m_interpreter.isDone();
+    // a game that hit a runtime error can't go any further
+    return m_interpreter.isDone() || m_interpreter.getError().has_value();
+}
+
+void
+GameSession::setStepBudget(std::optional<size_t> budget) {
+    m_interpreter.setStepBudget(budget);
+}
+
+const GameInterpreter::ExecutionStats&
+GameSession::getExecutionStats() const {
+    return m_interpreter.getExecutionStats();
+}
+
+void
+GameSession::enableProfiling() {
+    if (!m_profiler) {
+        m_profiler = std::make_unique<Profiler>();
+        m_interpreter.setProfiler(m_profiler.get());
+    }
+}
+
+const Profiler*
+GameSession::getProfiler() const {
+    return m_profiler.get();
 }
 
-std::optional<Program>
-GameSession::convertRulesToProgram(ast::GameRules& rules) {
+SharedProgram
+GameSession::compileRules(ast::GameRules rules) {
     Program program;
     program.statements = std::move(rules.statements);
-    return std::make_optional(std::move(program));
+    program.variableTypes = ast::inferTypes(program.raw().statements);
+    // A program that fails verification still runs, and reports the problem
+    // as a runtime error when it gets there
+    program.verified = !ast::verifyStructure(program.raw().statements).has_value();
+    program.flatExpressions = ast::flattenExpressions(program.raw().statements);
+    return std::make_shared<const Program>(std::move(program));
 }
 
 
@@ -107,19 +155,22 @@ GameSession::convertMessageToGameMessage(const ClientMessage& clientMsg) const {
         return GameMessage{TextInputMessage{
             String{playerID},
             String{val->promptReference},
-            String{val->input}}};
+            String{val->input},
+            val->requestID}};
     }
     else if (auto* val = std::get_if<ResponseChoiceInputMessage>(&clientMsg.message.data)) {
         return GameMessage{ChoiceInputMessage{
             String{playerID},
             String{val->promptRef},
-            String{val->choice}}};
+            String{val->choice},
+            val->requestID}};
     }
     else if (auto* val = std::get_if<ResponseRangeInputMessage>(&clientMsg.message.data)) {
         return GameMessage{RangeInputMessage{
             String{playerID},
             String{val->promptRef},
-            Integer{val->value}}};
+            Integer{val->value},
+            val->requestID}};
     }
 
     return std::nullopt;
@@ -145,18 +196,19 @@ GameSession::convertGameMessageToMessage(const GameMessage& engineMsg) const {
 
         if constexpr (std::is_same_v<T, GetTextInputMessage>) {
             msg.type = MessageType::RequestTextInput;
-            msg.data = RequestTextInputMessage{req.prompt.value};
+            msg.data = RequestTextInputMessage{req.prompt.value, req.requestID};
         }
         else if constexpr (std::is_same_v<T, GetChoiceInputMessage>) {
             msg.type = MessageType::RequestChoiceInput;
-            msg.data = RequestChoiceInputMessage{req.prompt.value};
+            msg.data = RequestChoiceInputMessage{req.prompt.value, req.choices.shareTexts(), req.requestID};
         }
         else if constexpr (std::is_same_v<T, GetRangeInputMessage>) {
             msg.type = MessageType::RequestRangeInput;
             msg.data = RequestRangeInputMessage{
                 req.prompt.value,
                 req.minValue.value,
-                req.maxValue.value};
+                req.maxValue.value,
+                req.requestID};
         }
 
         return msg;
@@ -168,19 +220,30 @@ GameSession::collectOutgoingMessages() {
     std::vector<ClientMessage> outgoing;
 
     auto outputs = m_inputManager.popPendingOutputs();
-    for(const auto& text : outputs){
+    for(auto& output : outputs){
         Message gameOutputMsg;
         gameOutputMsg.type = MessageType::GameOutput;
-        gameOutputMsg.data = GameOutputMessage{text};
+        gameOutputMsg.data = GameOutputMessage{std::move(output.text)};
 
-        for(const auto& player : m_players){
-            outgoing.push_back(ClientMessage{player.clientID, gameOutputMsg});
+        if(output.playerIDs.empty()){
+            for(const auto& player : m_players){
+                outgoing.push_back(ClientMessage{player.clientID, gameOutputMsg});
+            }
+            continue;
+        }
+
+        for(const auto& playerID : output.playerIDs){
+            if (auto clientID = resolveClientID(playerID.value)) {
+                outgoing.push_back(ClientMessage{*clientID, gameOutputMsg});
+            } else {
+                std::cerr << "[GameSession] Warning: Could not find client for player ID: " << playerID.value << "\n";
+            }
         }
     }
 
-    auto requests = m_inputManager.getPendingRequests();
+    m_inputManager.drainPendingRequests(m_drainedRequests);
 
-    for (const auto& req : requests) {
+    for (const auto& req : m_drainedRequests) {
         Message netMsg = convertGameMessageToMessage(req);
 
         std::string targetPlayerID;
@@ -206,13 +269,16 @@ GameSession::collectOutgoingMessages() {
         }
     }
 
-    m_inputManager.clearPendingRequests();
-
     if(isFinished()){
         Message gameOverMsg;
         gameOverMsg.type = MessageType::GameOver;
         gameOverMsg.data = GameOverMessage{"Game Over"};
 
+        if (const auto& error = m_interpreter.getError()) {
+            std::cerr << "[GameSession] Game stopped by runtime error: " << error->message << "\n";
+            m_interpreter.getTrace().dump(std::cerr);
+        }
+
         for(const auto& player : m_players){
             outgoing.push_back(ClientMessage{player.clientID, gameOverMsg});
         }
@@ -25,12 +25,38 @@ public:
                 ast::GameRules rules,
                 std::vector<LobbyMember> players);
 
+    /// Runs an already compiled game, which other sessions may be running too
+    GameSession(LobbyID lobbyID,
+                SharedProgram program,
+                std::vector<LobbyMember> players);
+
+    /// Compiles rules into a program that any number of sessions can share
+    static SharedProgram compileRules(ast::GameRules rules);
+
     std::vector<ClientMessage> start();
     std::vector<ClientMessage> tick(const std::vector<ClientMessage>& incomingMessages);
     bool isFinished() const;
     LobbyID getLobbyID() const;
 
+    /// Caps the statements the game may run per tick, so a heavy game yields
+    /// and resumes next tick instead of stalling the server. None means no cap.
+    void setStepBudget(std::optional<size_t> budget);
+    const GameInterpreter::ExecutionStats& getExecutionStats() const;
+
+    /// A copy of this game, paused where it is, that plays on independently
+    /// (e.g. to try out each choice a player could make). Cheap: see
+    /// GameInterpreter::forkFrom. The fork isn't profiled.
+    std::unique_ptr<GameSession> fork() const;
+
+    /// Starts profiling the game's interpreter, see Profiler
+    void enableProfiling();
+    /// The session's profile, null unless profiling was enabled
+    const Profiler* getProfiler() const;
+
 private:
+    struct ForkTag {};
+    GameSession(const GameSession& source, ForkTag);
+
     LobbyID m_lobbyID;
     std::vector<LobbyMember> m_players;
     std::unordered_set<uintptr_t> m_playerIDs;
@@ -38,8 +64,11 @@ private:
 
     InputManager m_inputManager;
     GameInterpreter m_interpreter;
+    std::unique_ptr<Profiler> m_profiler;
+
+    /// Reused every tick to drain the input manager's request queue
+    std::vector<GameMessage> m_drainedRequests;
 
-    std::optional<Program> convertRulesToProgram(ast::GameRules& rules);
     void processIncomingMessages(const std::vector<ClientMessage>& messages);
 
     /// Engine -> Network, server asks client
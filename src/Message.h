@@ -85,32 +85,38 @@ struct ErrorMessage{
 
 struct RequestTextInputMessage{
     std::string prompt;
+    uint32_t requestID = 0; // the engine's ID for this request, 0 if it has none
 };
 
 struct RequestChoiceInputMessage {
     std::string prompt;
-    std::vector<std::string> choices;
+    std::shared_ptr<const std::vector<std::string>> choices; // shared by every request offering them
+    uint32_t requestID = 0;
 };
 
 struct RequestRangeInputMessage {
     std::string prompt;
     int min;
     int max;
+    uint32_t requestID = 0;
 };
 
 struct ResponseTextInputMessage {
     std::string input;
     std::string promptReference;
+    uint32_t requestID = 0; // echoes the request's ID; 0 matches by prompt instead
 };
 
 struct ResponseChoiceInputMessage {
     std::string choice;
     std::string promptRef;
+    uint32_t requestID = 0;
 };
 
 struct ResponseRangeInputMessage {
     int value;
     std::string promptRef;
+    uint32_t requestID = 0;
 };
 
 struct GameOutputMessage{
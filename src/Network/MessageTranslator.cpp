@@ -1,6 +1,8 @@
 #include "MessageTranslator.h"
+#include <charconv>
 #include <string_view>
 #include <string>
+#include <vector>
 #include <stdexcept>
 #include <iostream>
 
@@ -34,6 +36,47 @@ namespace {
         }
     }
 
+    /// A request's ID, and the response's that echoes it, is sent in its own
+    /// "#<requestID>:" field ahead of the message. Every message starts with
+    /// its prefix otherwise, so the field can't be mistaken for its content.
+    static std::string formatRequestID(uint32_t requestID) {
+        return "#" + std::to_string(requestID) + ":";
+    }
+
+    /// Strips a leading "#<requestID>:" from payload, returning 0 if there's none
+    static uint32_t takeRequestID(std::string_view& payload) {
+        size_t end = payload.find(':');
+        if (!payload.starts_with('#') || end == std::string_view::npos) {
+            return 0;
+        }
+        uint32_t requestID = 0;
+        auto [last, error] = std::from_chars(payload.data() + 1, payload.data() + end, requestID);
+        if (error != std::errc{} || last != payload.data() + end) {
+            return 0;
+        }
+        payload.remove_prefix(end + 1);
+        return requestID;
+    }
+
+    static uint32_t getRequestID(const Message& msg) {
+        return std::visit([](const auto& data) -> uint32_t {
+            if constexpr (requires { data.requestID; }) {
+                return data.requestID;
+            }
+            else {
+                return 0;
+            }
+        }, msg.data);
+    }
+
+    static void setRequestID(Message& msg, uint32_t requestID) {
+        std::visit([requestID](auto& data) {
+            if constexpr (requires { data.requestID; }) {
+                data.requestID = requestID;
+            }
+        }, msg.data);
+    }
+
     // Handler entry: prefix + function pointer
     // define prefix-driven dispatch to prevent silent corruption.
     struct MessageHandlerEntry {
@@ -220,13 +263,29 @@ template<>
 struct MessageTraits<RequestChoiceInputMessage> {
     static constexpr std::string_view prefix = "RequestChoiceInput:";
 
+    /// Prompt|Choice1|Choice2...
     static std::string serialize(const RequestChoiceInputMessage& requestChoiceInputMsg) {
-        return std::string(prefix) + requestChoiceInputMsg.prompt;
+        std::string serialized = std::string(prefix) + requestChoiceInputMsg.prompt;
+        if (requestChoiceInputMsg.choices) {
+            for (const auto& choice : *requestChoiceInputMsg.choices) {
+                serialized += "|" + choice;
+            }
+        }
+        return serialized;
     }
 
     static Message deserialize(const std::string_view payload) {
-        std::string_view prompt = payload.substr(prefix.size());
-        return { MessageType::RequestChoiceInput, RequestChoiceInputMessage{std::string(prompt)} };
+        std::string_view content = payload.substr(prefix.size());
+        size_t delimiter = content.find('|');
+        std::vector<std::string> choices;
+        while (delimiter != std::string::npos) {
+            size_t next = content.find('|', delimiter + 1);
+            choices.emplace_back(content.substr(delimiter + 1, next - (delimiter + 1)));
+            delimiter = next;
+        }
+        return { MessageType::RequestChoiceInput,
+                 RequestChoiceInputMessage{std::string(content.substr(0, content.find('|'))),
+                                           std::make_shared<const std::vector<std::string>>(std::move(choices))} };
     }
 };
 
@@ -389,6 +448,15 @@ consteval bool prefixesAreValid() {
 }
 static_assert(prefixesAreValid(), "Message prefixes must not contain '|' and must not be non-empty");
 
+// A payload starting with '#' carries a request ID, see formatRequestID()
+consteval bool prefixesLeaveRoomForRequestIDs() {
+    for (auto& h : Handlers)
+        if (h.prefix.starts_with('#'))
+            return false;
+    return true;
+}
+static_assert(prefixesLeaveRoomForRequestIDs(), "Message prefixes must not start with '#'");
+
 } // namespace. Keep these implemenetations exclusive, so nothing inside leaks into other .cpp files
 
 
@@ -409,15 +477,21 @@ std::string MessageTranslator::serialize(const Message& msg)
             }
         }, msg.data);
     
+    if (uint32_t requestID = getRequestID(msg); requestID != 0) {
+        serializedMessage.insert(0, formatRequestID(requestID));
+    }
     return serializedMessage;
 }
 
 Message MessageTranslator::deserialize(std::string_view payload)
 {
     std::cout << "[Translator] Checking payload: '" << payload << "'\n";
+    uint32_t requestID = takeRequestID(payload);
     for (const auto& entry : Handlers) {
         if (payload.starts_with(entry.prefix)) {
-            return entry.deserialize(payload);
+            Message msg = entry.deserialize(payload);
+            setRequestID(msg, requestID);
+            return msg;
         }
     }
     std::cout << "[Translator] No matching prefix found. Returning Empty.\n";
@@ -0,0 +1,84 @@
+#include "BotPolicy.h"
+
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+/// The text a player would send to pick one of `choices` at random
+std::string
+pickChoice(const ChoiceSet& choices, std::mt19937& rng) {
+    if (choices.empty()) {
+        return "";
+    }
+    std::uniform_int_distribution<size_t> pick(0, choices.size() - 1);
+    return choices.getTexts()[pick(rng)];
+}
+
+} // namespace
+
+GameMessage
+RandomBotPolicy::respond(const GameMessage& request, std::mt19937& rng) const {
+    return std::visit([&](const auto& msg) -> GameMessage {
+        using T = std::decay_t<decltype(msg)>;
+        if constexpr (std::is_same_v<T, GetChoiceInputMessage>) {
+            return GameMessage{ChoiceInputMessage{msg.playerID, msg.prompt, String{pickChoice(msg.choices, rng)}, msg.requestID}};
+        } else if constexpr (std::is_same_v<T, GetVoteInputMessage>) {
+            return GameMessage{VoteInputMessage{msg.playerID, msg.prompt, String{pickChoice(msg.choices, rng)}, msg.requestID}};
+        } else if constexpr (std::is_same_v<T, GetRangeInputMessage>) {
+            std::uniform_int_distribution<int> pick(msg.minValue.value, msg.maxValue.value);
+            return GameMessage{RangeInputMessage{msg.playerID, msg.prompt, Integer{pick(rng)}, msg.requestID}};
+        } else if constexpr (std::is_same_v<T, GetTextInputMessage>) {
+            return GameMessage{TextInputMessage{msg.playerID, msg.prompt, String{"bot"}, msg.requestID}};
+        } else {
+            throw std::invalid_argument("Bots only respond to input requests");
+        }
+    }, request.inner);
+}
+
+ScriptedBotPolicy::ScriptedBotPolicy(std::unordered_map<std::string, std::string> answers,
+                                     std::shared_ptr<const BotPolicy> fallback)
+    : m_answers(std::move(answers))
+    , m_fallback(std::move(fallback)) {
+    if (!m_fallback) {
+        throw std::invalid_argument("A scripted bot needs a fallback policy");
+    }
+}
+
+GameMessage
+ScriptedBotPolicy::respond(const GameMessage& request, std::mt19937& rng) const {
+    std::optional<GameMessage> scripted = std::visit([&](const auto& msg) -> std::optional<GameMessage> {
+        using T = std::decay_t<decltype(msg)>;
+        if constexpr (std::is_same_v<T, GetChoiceInputMessage> || std::is_same_v<T, GetVoteInputMessage>
+                      || std::is_same_v<T, GetRangeInputMessage> || std::is_same_v<T, GetTextInputMessage>) {
+            auto it = m_answers.find(msg.prompt.value);
+            if (it == m_answers.end()) {
+                return std::nullopt;
+            }
+            const std::string& answer = it->second;
+
+            if constexpr (std::is_same_v<T, GetChoiceInputMessage>) {
+                return GameMessage{ChoiceInputMessage{msg.playerID, msg.prompt, String{answer}, msg.requestID}};
+            } else if constexpr (std::is_same_v<T, GetVoteInputMessage>) {
+                return GameMessage{VoteInputMessage{msg.playerID, msg.prompt, String{answer}, msg.requestID}};
+            } else if constexpr (std::is_same_v<T, GetTextInputMessage>) {
+                return GameMessage{TextInputMessage{msg.playerID, msg.prompt, String{answer}, msg.requestID}};
+            } else {
+                int value = 0;
+                auto [end, error] = std::from_chars(answer.data(), answer.data() + answer.size(), value);
+                if (error != std::errc{} || end != answer.data() + answer.size()) {
+                    return std::nullopt;
+                }
+                return GameMessage{RangeInputMessage{msg.playerID, msg.prompt, Integer{value}, msg.requestID}};
+            }
+        } else {
+            return std::nullopt;
+        }
+    }, request.inner);
+
+    if (scripted) {
+        return std::move(*scripted);
+    }
+    return m_fallback->respond(request, rng);
+}
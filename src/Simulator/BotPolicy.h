@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "GameEngine/GameMessage.h"
+
+/**
+ * Answers a simulated game's input requests in place of a player.
+ *
+ * One policy serves every game a Simulator runs, from every worker thread,
+ * so respond() must leave the policy unchanged. Randomness comes from the
+ * game's own generator, which keeps each game reproducible from its seed.
+ */
+class BotPolicy {
+public:
+    virtual ~BotPolicy() = default;
+
+    /// The response message to an input request (a Get*InputMessage)
+    virtual GameMessage respond(const GameMessage& request, std::mt19937& rng) const = 0;
+};
+
+/// Picks uniformly among a request's choices or within its range
+class RandomBotPolicy : public BotPolicy {
+public:
+    GameMessage respond(const GameMessage& request, std::mt19937& rng) const override;
+};
+
+/// Gives a fixed answer to each known prompt and defers the rest to a fallback
+class ScriptedBotPolicy : public BotPolicy {
+public:
+    ScriptedBotPolicy(std::unordered_map<std::string, std::string> answers,
+                      std::shared_ptr<const BotPolicy> fallback);
+
+    GameMessage respond(const GameMessage& request, std::mt19937& rng) const override;
+
+private:
+    std::unordered_map<std::string, std::string> m_answers; // prompt -> answer
+    std::shared_ptr<const BotPolicy> m_fallback;
+};
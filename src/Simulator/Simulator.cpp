@@ -0,0 +1,120 @@
+#include "Simulator.h"
+
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include "GameEngine/InputManager.h"
+#include "WorkStealingPool.h"
+
+namespace {
+
+std::string
+describeOutcome(const Value& value) {
+    if (value.isString()) {
+        return value.asString().value;
+    }
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+} // namespace
+
+double
+SimulationReport::gamesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(games) / seconds : 0.0;
+}
+
+void
+SimulationReport::print(std::ostream& out) const {
+    out << games << " games in " << seconds << "s (" << gamesPerSecond() << " games/sec)\n";
+    for (const auto& [outcome, count] : outcomes) {
+        double share = games ? 100.0 * static_cast<double>(count) / static_cast<double>(games) : 0.0;
+        out << "  " << outcome << ": " << count << " (" << share << "%)\n";
+    }
+}
+
+Simulator::Simulator(SharedProgram program, std::shared_ptr<const BotPolicy> policy)
+    : m_program(std::move(program))
+    , m_policy(std::move(policy)) {
+    if (!m_program) {
+        throw std::invalid_argument("Can't simulate without a program");
+    }
+    if (!m_policy) {
+        throw std::invalid_argument("Can't simulate without a bot policy");
+    }
+}
+
+SimulationReport
+Simulator::run(const SimulationConfig& config) const {
+    WorkStealingPool pool(config.threads);
+
+    // Each worker tallies its own games; they're merged once the batch is done
+    std::vector<std::map<std::string, size_t>> workerOutcomes(pool.getThreadCount());
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run(config.games, [&](size_t worker, size_t index) {
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(config.seed + index));
+        std::string outcome;
+        try {
+            outcome = playGame(config, rng);
+        } catch (const std::exception& e) {
+            outcome = std::string{"exception: "} + e.what();
+        }
+        ++workerOutcomes[worker][outcome];
+    });
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    SimulationReport report;
+    report.games = config.games;
+    report.seconds = std::chrono::duration<double>(elapsed).count();
+    for (const auto& outcomes : workerOutcomes) {
+        for (const auto& [outcome, count] : outcomes) {
+            report.outcomes[outcome] += count;
+        }
+    }
+    return report;
+}
+
+std::string
+Simulator::playGame(const SimulationConfig& config, std::mt19937& rng) const {
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, m_program);
+
+    // Same player variables a GameSession registers
+    for (size_t i = 1; i <= config.players; ++i) {
+        Map<String, Value> playerMap;
+        playerMap.setAttribute(String{"id"}, Value{String{std::to_string(i)}});
+        playerMap.setAttribute(String{"name"}, Value{String{"bot" + std::to_string(i)}});
+        interpreter.storeVariable(Name{"player" + std::to_string(i)}, Value{playerMap});
+    }
+
+    std::vector<GameMessage> requests;
+    std::vector<GameMessage> responses;
+    for (size_t round = 0;; ++round) {
+        interpreter.execute();
+
+        if (const auto& error = interpreter.getError()) {
+            return "error: " + error->message;
+        }
+        if (interpreter.isDone()) {
+            const Value* outcome = interpreter.findVariable(Name{config.outcomeVariable});
+            return outcome ? describeOutcome(*outcome) : "(no " + config.outcomeVariable + ")";
+        }
+
+        // Nobody reads the game's messages
+        inputManager.popPendingOutputs();
+
+        inputManager.drainPendingRequests(requests);
+        if (requests.empty() || round == config.maxRounds) {
+            return "stalled";
+        }
+
+        responses.clear();
+        for (const auto& request : requests) {
+            responses.push_back(m_policy->respond(request, rng));
+        }
+        inputManager.handleIncomingMessages(responses);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <thread>
+#include "GameEngine/GameInterpreter.h"
+#include "BotPolicy.h"
+
+struct SimulationConfig {
+    size_t games = 1000;
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t players = 2;
+    /// Variable whose final value is a game's outcome
+    std::string outcomeVariable = "game_result";
+    /// Game i is seeded with seed + i, so a run reproduces regardless of threading
+    uint64_t seed = 0;
+    /// Input round trips a game may take before it's recorded as stalled
+    size_t maxRounds = 10000;
+};
+
+struct SimulationReport {
+    size_t games = 0;
+    double seconds = 0.0;
+    std::map<std::string, size_t> outcomes; // outcome -> games that ended with it
+
+    double gamesPerSecond() const;
+    void print(std::ostream& out) const;
+};
+
+/**
+ * Plays complete games headlessly, with a BotPolicy answering every input
+ * request straight through an InputManager: no networking, lobbies or
+ * sessions. Games run in parallel on a WorkStealingPool and all share one
+ * compiled program.
+ *
+ * Games that end without setting the outcome variable are counted under
+ * "(no <variable>)", ones stopped by a runtime error under "error: ...",
+ * and ones still waiting on input after maxRounds under "stalled".
+ */
+class Simulator {
+public:
+    Simulator(SharedProgram program, std::shared_ptr<const BotPolicy> policy);
+
+    SimulationReport run(const SimulationConfig& config) const;
+
+    /// Plays one game to the end and returns its outcome
+    std::string playGame(const SimulationConfig& config, std::mt19937& rng) const;
+
+private:
+    SharedProgram m_program;
+    std::shared_ptr<const BotPolicy> m_policy;
+};
@@ -0,0 +1,98 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// The indices one worker still has to run, [begin, end)
+struct TaskQueue {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+std::optional<size_t>
+popFront(TaskQueue& queue) {
+    std::lock_guard lock(queue.mutex);
+    if (queue.begin == queue.end) {
+        return std::nullopt;
+    }
+    return queue.begin++;
+}
+
+/// Moves the back half of a victim's remaining indices into the thief's queue
+bool
+stealHalf(TaskQueue& victim, TaskQueue& thief) {
+    size_t stolenBegin = 0;
+    size_t stolenEnd = 0;
+    {
+        std::lock_guard lock(victim.mutex);
+        size_t remaining = victim.end - victim.begin;
+        if (remaining == 0) {
+            return false;
+        }
+        stolenEnd = victim.end;
+        stolenBegin = victim.end - (remaining + 1) / 2;
+        victim.end = stolenBegin;
+    }
+
+    std::lock_guard lock(thief.mutex);
+    thief.begin = stolenBegin;
+    thief.end = stolenEnd;
+    return true;
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threadCount)
+    : m_threadCount(std::max<size_t>(threadCount, 1)) {}
+
+size_t
+WorkStealingPool::getThreadCount() const {
+    return m_threadCount;
+}
+
+void
+WorkStealingPool::run(size_t taskCount, const std::function<void(size_t worker, size_t index)>& task) const {
+    size_t workerCount = std::min(m_threadCount, std::max<size_t>(taskCount, 1));
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    queues.reserve(workerCount);
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        auto queue = std::make_unique<TaskQueue>();
+        queue->begin = taskCount * worker / workerCount;
+        queue->end = taskCount * (worker + 1) / workerCount;
+        queues.push_back(std::move(queue));
+    }
+
+    auto work = [&](size_t worker) {
+        TaskQueue& own = *queues[worker];
+        while (true) {
+            while (auto index = popFront(own)) {
+                task(worker, *index);
+            }
+
+            // Indices in flight between two queues belong to the thief,
+            // which runs them, so finding every queue empty means we're done
+            bool stole = false;
+            for (size_t offset = 1; offset < workerCount && !stole; ++offset) {
+                stole = stealHalf(*queues[(worker + offset) % workerCount], own);
+            }
+            if (!stole) {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::jthread> threads;
+    threads.reserve(workerCount - 1);
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+}
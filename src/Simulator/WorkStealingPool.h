@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Runs a batch of independent tasks, numbered 0..n-1, on a fixed number of
+ * threads.
+ *
+ * Each worker starts with an even, contiguous share of the indices and runs
+ * them from the front. A worker that runs dry steals the back half of the
+ * first busy worker's share it finds, so uneven task lengths (a long game
+ * next to a quick one) don't leave threads idle at the end of a batch.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threadCount);
+
+    size_t getThreadCount() const;
+
+    /// Calls task(worker, index) once for every index below taskCount and
+    /// returns when all have run. Tasks must not throw.
+    void run(size_t taskCount, const std::function<void(size_t worker, size_t index)>& task) const;
+
+private:
+    size_t m_threadCount;
+};
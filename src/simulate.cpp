@@ -0,0 +1,111 @@
+#include "GameServer.h"
+#include "GameSession.h"
+#include "Simulator.h"
+#include "parser/GameSpecLoader.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Plays many games headlessly against bots and reports throughput and outcomes:
+//   simulate (--game FILE | --builtin number|choice) [--games N] [--threads N]
+//            [--players N] [--outcome VARIABLE] [--seed N] [--answer "PROMPT=ANSWER"]...
+
+namespace {
+
+int
+usage() {
+    std::cerr << "usage: simulate (--game FILE | --builtin number|choice) [--games N] [--threads N]\n"
+              << "                [--players N] [--outcome VARIABLE] [--seed N] [--answer \"PROMPT=ANSWER\"]...\n";
+    return EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SimulationConfig config;
+    std::string gameFile;
+    std::string builtin;
+    bool playersGiven = false;
+    bool outcomeGiven = false;
+    std::unordered_map<std::string, std::string> answers;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view flag = argv[i];
+            if (i + 1 >= argc) {
+                return usage();
+            }
+            std::string value = argv[++i];
+
+            if (flag == "--game") {
+                gameFile = value;
+            } else if (flag == "--builtin") {
+                builtin = value;
+            } else if (flag == "--games") {
+                config.games = std::stoull(value);
+            } else if (flag == "--threads") {
+                config.threads = std::stoull(value);
+            } else if (flag == "--players") {
+                config.players = std::stoull(value);
+                playersGiven = true;
+            } else if (flag == "--outcome") {
+                config.outcomeVariable = value;
+                outcomeGiven = true;
+            } else if (flag == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (flag == "--answer") {
+                auto split = value.find('=');
+                if (split == std::string::npos) {
+                    return usage();
+                }
+                answers[value.substr(0, split)] = value.substr(split + 1);
+            } else {
+                return usage();
+            }
+        }
+    } catch (const std::exception&) {
+        return usage();
+    }
+
+    if (gameFile.empty() == builtin.empty()) {
+        return usage();
+    }
+
+    ast::GameRules rules;
+    if (!gameFile.empty()) {
+        GameSpecLoader loader;
+        GameSpec spec = loader.loadFile(gameFile.c_str());
+        rules.statements = std::move(spec.rulesProgram);
+        if (!playersGiven && spec.playerRange.min > 0) {
+            config.players = static_cast<size_t>(spec.playerRange.min);
+        }
+    } else if (builtin == "number") {
+        rules = GameServer::createNumberBattleRules();
+        if (!outcomeGiven) {
+            config.outcomeVariable = "Game Result";
+        }
+    } else if (builtin == "choice") {
+        rules = GameServer::createChoiceBattleRules();
+        if (!outcomeGiven) {
+            config.outcomeVariable = "Game result";
+        }
+    } else {
+        return usage();
+    }
+
+    std::shared_ptr<const BotPolicy> policy = std::make_shared<RandomBotPolicy>();
+    if (!answers.empty()) {
+        policy = std::make_shared<ScriptedBotPolicy>(std::move(answers), policy);
+    }
+
+    Simulator simulator(GameSession::compileRules(std::move(rules)), policy);
+    SimulationReport report = simulator.run(config);
+
+    std::cout << "Outcome variable: " << config.outcomeVariable << ", " << config.players << " players, "
+              << config.threads << " threads\n";
+    report.print(std::cout);
+    return EXIT_SUCCESS;
+}
@@ -105,3 +105,131 @@ TEST(CallableTest, UpFrom)
         expectedList
     );
 }
+
+namespace
+{
+    Value
+    makePlayer(std::string name, std::string team, int wins)
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"name"}, Value{String{std::move(name)}});
+        player.setAttribute(String{"team"}, Value{String{std::move(team)}});
+        player.setAttribute(String{"wins"}, Value{Integer{wins}});
+        return Value{player};
+    }
+
+    List<Value>
+    makePlayers()
+    {
+        return List<Value>{
+            makePlayer("Ada", "red", 2),
+            makePlayer("Bob", "blue", 5),
+            makePlayer("Cy", "red", 5),
+        };
+    }
+
+    // Assigns players.<kind>(args...) to "result" and returns it
+    Value
+    callOnPlayers(ast::Callable::Kind kind, std::vector<Value> args)
+    {
+        InputManager inputManager;
+        GameInterpreter interpreter(inputManager, {});
+
+        ast::ExpressionsBuilder expressionsBuilder;
+        for (Value& arg : args)
+        {
+            expressionsBuilder.addExpression(ast::makeConstant(std::move(arg)));
+        }
+
+        doAssignment(interpreter, ast::makeAssignment(
+            ast::makeVariable(Name{"result"}),
+            ast::makeCallable(ast::makeConstant(Value{makePlayers()}), expressionsBuilder.build(), kind)
+        ));
+        return loadVariable(interpreter, Name{"result"});
+    }
+}
+
+TEST(CallableTest, Contains)
+{
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::CONTAINS, {makePlayer("Bob", "blue", 5)}),
+        Value{Boolean{true}}
+    );
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::CONTAINS, {makePlayer("Bob", "blue", 6)}),
+        Value{Boolean{false}}
+    );
+}
+
+TEST(CallableTest, CollectAttribute)
+{
+    List<Value> expected{Value{Integer{2}}, Value{Integer{5}}, Value{Integer{5}}};
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::COLLECT, {Value{String{"wins"}}}).asList(),
+        expected
+    );
+}
+
+TEST(CallableTest, FilterAndCount)
+{
+    List<Value> expected{makePlayer("Ada", "red", 2), makePlayer("Cy", "red", 5)};
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::FILTER, {Value{String{"team"}}, Value{String{"red"}}}).asList(),
+        expected
+    );
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::COUNT, {Value{String{"wins"}}, Value{Integer{5}}}),
+        Value{Integer{2}}
+    );
+}
+
+TEST(CallableTest, MaxAndMinKeepTheFirstTie)
+{
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::MAX_BY, {Value{String{"wins"}}}),
+        makePlayer("Bob", "blue", 5)
+    );
+    EXPECT_EQ(
+        callOnPlayers(ast::Callable::Kind::MIN_BY, {Value{String{"name"}}}),
+        makePlayer("Ada", "red", 2)
+    );
+}
+
+TEST(CallableTest, UniqueKeepsFirstOccurrences)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, {});
+
+    List<Value> list{
+        Value{String{"b"}}, Value{Integer{1}}, Value{String{"b"}},
+        Value{makePlayers()}, Value{Integer{1}}, Value{makePlayers()}, Value{Boolean{false}},
+    };
+    doAssignment(interpreter, ast::makeAssignment(
+        ast::makeVariable(Name{"result"}),
+        ast::makeCallable(ast::makeConstant(Value{list}), {}, ast::Callable::Kind::UNIQUE)
+    ));
+
+    List<Value> expected{Value{String{"b"}}, Value{Integer{1}}, Value{makePlayers()}, Value{Boolean{false}}};
+    EXPECT_EQ(loadVariable(interpreter, Name{"result"}).asList(), expected);
+}
+
+TEST(CallableTest, QueryErrors)
+{
+    // A missing attribute, and max() of nothing
+    EXPECT_THROW(callOnPlayers(ast::Callable::Kind::COLLECT, {Value{String{"losses"}}}), std::runtime_error);
+    EXPECT_THROW(callOnPlayers(ast::Callable::Kind::FILTER, {Value{String{"team"}}}), std::runtime_error);
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, {});
+    ast::ExpressionsBuilder expressionsBuilder;
+    EXPECT_THROW({
+        doAssignment(interpreter, ast::makeAssignment(
+            ast::makeVariable(Name{"result"}),
+            ast::makeCallable(
+                ast::makeConstant(Value{List<Value>{}}),
+                expressionsBuilder.addExpression(ast::makeConstant(Value{String{"wins"}})).build(),
+                ast::Callable::Kind::MAX_BY
+            )
+        ));
+    }, std::runtime_error);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "Helpers.h"
+#include "ExecutionTrace.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+
+
+namespace
+{
+    using Kind = ExecutionTrace::Kind;
+
+    std::vector<Kind>
+    kinds(const ExecutionTrace& trace)
+    {
+        std::vector<Kind> kinds;
+        for (const auto& event : trace.getEvents())
+        {
+            kinds.push_back(event.kind);
+        }
+        return kinds;
+    }
+
+    /**
+     * match 2 {                               (line 1)
+     *   1 => { answer <- "no"; }
+     *   2 => { player.answer <- input(...); } (line 3)
+     * }
+     */
+    Program
+    makeProgram()
+    {
+        ast::StatementsBuilder first;
+        first.addStatement(ast::makeAssignment(
+            ast::makeVariable(Name{"answer"}),
+            ast::makeConstant(Value{String{"no"}})
+        ));
+
+        auto input = ast::makeInputText(
+            ast::makeVariable(Name{"player"}),
+            ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"answer"}),
+            String{"Answer: "}
+        );
+        input->setLocation(ast::SourceLocation{3, 10});
+        ast::StatementsBuilder second;
+        second.addStatement(std::move(input));
+
+        auto match = ast::MatchBuilder{}
+            .setTarget(ast::makeConstant(Value{Integer{2}}))
+            .addCandidatePair(ast::makeConstant(Value{Integer{1}}), first.build())
+            .addCandidatePair(ast::makeConstant(Value{Integer{2}}), second.build())
+            .build();
+        match->setLocation(ast::SourceLocation{1, 1});
+
+        ast::StatementsBuilder builder;
+        return Program{builder.addStatement(std::move(match)).build()};
+    }
+}
+
+
+TEST(ExecutionTraceTest, KeepsTheLastEventsOldestFirst)
+{
+    ExecutionTrace trace{3}; // rounded up to 4
+    EXPECT_EQ(trace.getCapacity(), 4);
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        trace.record(Kind::MATCH_ARM, {}, i);
+    }
+
+    auto events = trace.getEvents();
+    ASSERT_EQ(events.size(), 4);
+    EXPECT_EQ(trace.getRecordedCount(), 6);
+    EXPECT_EQ(events.front().detail, 2);
+    EXPECT_EQ(events.back().detail, 5);
+
+    trace.record(Kind::VARIABLE_WRITTEN, "a_rather_long_variable_name");
+    EXPECT_EQ(trace.getEvents().back().getText(), "a_rather_long_va");
+
+    trace.clear();
+    EXPECT_TRUE(trace.getEvents().empty());
+}
+
+
+TEST(ExecutionTraceTest, RecordsWhatTheInterpreterDid)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, makeProgram());
+
+    Map<String, Value> player{};
+    player.setAttribute(String{"id"}, Value{String{"p1"}});
+    interpreter.storeVariable(Name{"player"}, Value{player});
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.needsIO());
+
+    inputManager.handleIncomingMessages({GameMessage{TextInputMessage{String{"p1"}, String{"Answer: "}, String{"yes"}}}});
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    const ExecutionTrace& trace = interpreter.getTrace();
+    EXPECT_EQ(kinds(trace), (std::vector<Kind>{
+        Kind::VARIABLE_WRITTEN,  // player
+        Kind::STATEMENT,         // match
+        Kind::MATCH_ARM,
+        Kind::STATEMENT,         // input
+        Kind::INPUT_REQUESTED,
+        Kind::STATEMENT,         // match, resumed
+        Kind::STATEMENT,         // input, again
+        Kind::INPUT_RECEIVED,
+        Kind::ATTRIBUTE_WRITTEN,
+    }));
+
+    std::ostringstream out;
+    trace.dump(out);
+    EXPECT_EQ(out.str(),
+        "Last 9 of 9 events:\n"
+        "  #1 wrote player\n"
+        "  #2 statement at 1:1\n"
+        "  #3 match arm 1\n"
+        "  #4 statement at 3:10\n"
+        "  #5 input requested from p1\n"
+        "  #6 statement at 1:1\n"
+        "  #7 statement at 3:10\n"
+        "  #8 input received from p1\n"
+        "  #9 wrote .answer\n"
+    );
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include "Helpers.h"
+#include "FlatExpressions.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+
+
+namespace
+{
+    // count = player.hand.size() + 1
+    std::unique_ptr<ast::Statement>
+    makeCountAssignment()
+    {
+        return ast::makeAssignment(
+            ast::makeVariable(Name{"count"}),
+            ast::makeArithmeticOperation(
+                ast::makeCallable(
+                    ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"hand"}),
+                    {},
+                    ast::Callable::Kind::SIZE
+                ),
+                ast::makeConstant(Value{Integer{1}}),
+                ast::ArithmeticOperation::Kind::ADD
+            )
+        );
+    }
+
+    Value
+    makePlayer()
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"hand"}, Value{List<Value>{Value{Integer{7}}, Value{Integer{9}}}});
+        return Value{player};
+    }
+}
+
+
+TEST(FlatExpressionsTest, ChildrenFollowTheirParents)
+{
+    ast::StatementsBuilder builder;
+    auto statements = builder.addStatement(makeCountAssignment()).build();
+    auto raw = ast::rawStatements(statements);
+
+    ast::FlatExpressions flat = ast::flattenExpressions(raw);
+
+    // target, then add -> size -> attribute -> variable, constant
+    ASSERT_EQ(flat.size(), 6);
+    auto assignment = static_cast<ast::Assignment*>(statements[0].get());
+    EXPECT_EQ(assignment->getTarget()->getFlatIndex(), 0);
+    EXPECT_EQ(assignment->getValue()->getFlatIndex(), 1);
+
+    const ast::FlatNode& add = flat.getNode(1);
+    EXPECT_EQ(add.kind, ast::NodeKind::ARITHMETIC_OPERATION);
+    EXPECT_EQ(add.left, 2);
+    EXPECT_EQ(add.right, 5);
+    EXPECT_EQ(flat.getNode(2).kind, ast::NodeKind::CALLABLE);
+    EXPECT_EQ(flat.getNode(3).kind, ast::NodeKind::ATTRIBUTE);
+    EXPECT_EQ(flat.getAttribute(flat.getNode(3).operand), String{"hand"});
+    EXPECT_EQ(flat.getName(flat.getNode(4).operand), Name{"player"});
+    EXPECT_EQ(flat.getConstant(flat.getNode(5).operand), Value{Integer{1}});
+}
+
+
+TEST(FlatExpressionsTest, MalformedTreesStayTreeOnly)
+{
+    ast::FlatExpressions flat;
+
+    auto constantBase = ast::makeAttribute(ast::makeConstant(Value{Integer{1}}), String{"x"});
+    EXPECT_EQ(flat.add(constantBase.get()), ast::FlatNode::NONE);
+    EXPECT_EQ(constantBase->getFlatIndex(), ast::Expression::NOT_FLAT);
+
+    auto missingOperand = ast::makeUnaryOperation(nullptr, ast::UnaryOperation::Kind::NOT);
+    EXPECT_EQ(flat.add(missingOperand.get()), ast::FlatNode::NONE);
+    EXPECT_EQ(flat.size(), 0);
+}
+
+
+TEST(FlatExpressionsTest, FlatProgramRunsLikeTheTree)
+{
+    for (bool flatten : {false, true})
+    {
+        ast::StatementsBuilder builder;
+        Program program{builder.addStatement(makeCountAssignment()).build()};
+        program.variableTypes = ast::inferTypes(program.raw().statements);
+        if (flatten)
+        {
+            program.flatExpressions = ast::flattenExpressions(program.raw().statements);
+        }
+
+        InputManager inputManager;
+        GameInterpreter interpreter(inputManager, std::move(program));
+        interpreter.storeVariable(Name{"player"}, makePlayer());
+
+        interpreter.execute();
+        ASSERT_TRUE(interpreter.isDone());
+        EXPECT_EQ(*interpreter.findVariable(Name{"count"}), Value{Integer{3}});
+    }
+}
+
+
+TEST(FlatExpressionsTest, FlatProgramReportsTheSameErrors)
+{
+    ast::StatementsBuilder builder;
+    Program program{builder.addStatement(makeCountAssignment()).build()};
+    program.flatExpressions = ast::flattenExpressions(program.raw().statements);
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, std::move(program));
+    interpreter.storeVariable(Name{"player"}, Value{Map<String, Value>{}});
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.getError().has_value());
+    EXPECT_EQ(interpreter.findVariable(Name{"count"}), nullptr);
+}
+
+
+TEST(FlatExpressionsTest, BuiltinArgumentsArePooled)
+{
+    // players.count("wins", 5)
+    auto makeCount = [] {
+        ast::ExpressionsBuilder args;
+        args.addExpression(ast::makeConstant(Value{String{"wins"}}))
+            .addExpression(ast::makeConstant(Value{Integer{5}}));
+        return ast::makeCallable(ast::makeVariable(Name{"players"}), args.build(), ast::Callable::Kind::COUNT);
+    };
+    auto count = makeCount();
+
+    ast::FlatExpressions flat;
+    ASSERT_EQ(flat.add(count.get()), 0);
+    ASSERT_EQ(flat.size(), 4);
+
+    const ast::FlatNode& node = flat.getNode(0);
+    EXPECT_EQ(node.left, 1);
+    EXPECT_EQ(flat.getConstant(flat.getNode(flat.getArgument(node.operand)).operand), Value{String{"wins"}});
+    EXPECT_EQ(flat.getConstant(flat.getNode(flat.getArgument(node.operand + 1)).operand), Value{Integer{5}});
+
+    Map<String, Value> winner{};
+    winner.setAttribute(String{"wins"}, Value{Integer{5}});
+    Map<String, Value> loser{};
+    loser.setAttribute(String{"wins"}, Value{Integer{0}});
+    for (bool flatten : {false, true})
+    {
+        ast::StatementsBuilder builder;
+        Program program{builder.addStatement(ast::makeAssignment(
+            ast::makeVariable(Name{"winners"}),
+            makeCount()
+        )).build()};
+        if (flatten)
+        {
+            program.flatExpressions = ast::flattenExpressions(program.raw().statements);
+        }
+
+        InputManager inputManager;
+        GameInterpreter interpreter(inputManager, std::move(program));
+        interpreter.storeVariable(Name{"players"}, Value{List<Value>{Value{winner}, Value{loser}, Value{winner}}});
+
+        interpreter.execute();
+        ASSERT_TRUE(interpreter.isDone());
+        EXPECT_EQ(*interpreter.findVariable(Name{"winners"}), Value{Integer{2}});
+    }
+}
@@ -263,3 +263,74 @@ TEST(ForLoopTest, ForLoopWithIO)
         loadVariable(interpreter, Name{"answer"}).asString(), String{"dog"}
     );
 }
+
+
+TEST(ForLoopTest, ForLoopResumesWithoutReevaluatingTarget)
+{
+    InputManager inputManager;
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder statementsBuilder;
+
+    Map<String, Value> player{};
+    player.setAttribute(String{"id"}, Value{String{"1"}});
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"sum"}),
+                ast::makeConstant(Value{Integer{0}})
+            )
+        )
+        .addStatement(
+            ast::makeForLoop(
+                ast::makeVariable(Name{"int"}),
+                ast::makeVariable(Name{"ints"}),
+                statementsBuilder.addStatement(
+                    // Blocking statement!
+                    ast::makeInputText(
+                        ast::makeVariable(Name{"player"}),
+                        ast::makeVariable(Name{"answer"}),
+                        String{"Enter your answer: "}
+                    )
+                ).addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"sum"}),
+                        ast::makeArithmeticOperation(
+                            ast::makeVariable(Name{"sum"}),
+                            ast::makeVariable(Name{"int"}),
+                            ast::ArithmeticOperation::Kind::ADD
+                        )
+                    )
+                ).build()
+            )
+        ).build();
+
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.storeVariable(Name{"player"}, Value{player});
+    interpreter.storeVariable(
+        Name{"ints"}, Value{List<Value>{Value{Integer{10}}, Value{Integer{20}}}}
+    );
+
+    interpreter.execute();
+    EXPECT_EQ(interpreter.needsIO(), true);
+
+    // The loop keeps iterating over the list it saw when it was entered
+    interpreter.storeVariable(Name{"ints"}, Value{Integer{0}});
+
+    for (auto answer : {"cat", "dog"})
+    {
+        inputManager.handleIncomingMessages(
+            {GameMessage{
+                TextInputMessage{String{"1"}, String{"Enter your answer: "}, String{answer}}
+            }}
+        );
+        inputManager.clearPendingRequests();
+        EXPECT_NO_THROW(interpreter.execute());
+    }
+
+    EXPECT_EQ(interpreter.needsIO(), false);
+    EXPECT_EQ(
+        loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{30}
+    );
+}
@@ -3,10 +3,22 @@
 #include <iostream>
 #include "GameInterpreter.h"
 
+// The interpreter returns runtime errors rather than throwing them.
+// Raise them here, so tests can check for them with EXPECT_THROW.
+inline void
+throwIfError(const VisitResult& result)
+{
+    if (result.hasError())
+    {
+        throw std::runtime_error(result.getError().message);
+    }
+}
+
 inline void
 doAssignment(GameInterpreter& interpreter, std::unique_ptr<ast::Assignment> assignment)
 {
     VisitResult result = assignment->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -15,6 +27,7 @@ inline VisitResult
 doComparison(GameInterpreter& interpreter, std::unique_ptr<ast::Comparison> comparison)
 {
     VisitResult result = comparison->accept(interpreter);
+    throwIfError(result);
     EXPECT_TRUE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 
@@ -25,6 +38,7 @@ inline VisitResult
 doLogicalOperation(GameInterpreter& interpreter, std::unique_ptr<ast::LogicalOperation> logicalOp)
 {
     VisitResult result = logicalOp->accept(interpreter);
+    throwIfError(result);
     EXPECT_TRUE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 
@@ -35,6 +49,7 @@ inline VisitResult
 doUnaryOperation(GameInterpreter& interpreter, std::unique_ptr<ast::UnaryOperation> unaryOp)
 {
     VisitResult result = unaryOp->accept(interpreter);
+    throwIfError(result);
     EXPECT_TRUE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 
@@ -45,6 +60,7 @@ inline void
 doExtend(GameInterpreter& interpreter, std::unique_ptr<ast::Extend> extend)
 {
     VisitResult result = extend->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -53,6 +69,7 @@ inline void
 doReverse(GameInterpreter& interpreter, std::unique_ptr<ast::Reverse> reverse)
 {
     VisitResult result = reverse->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -61,6 +78,7 @@ inline void
 doShuffle(GameInterpreter& interpreter, std::unique_ptr<ast::Shuffle> shuffle)
 {
     VisitResult result = shuffle->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -69,6 +87,7 @@ inline void
 doDiscard(GameInterpreter& interpreter, std::unique_ptr<ast::Discard> discard)
 {
     VisitResult result = discard->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -77,6 +96,7 @@ inline void
 doSort(GameInterpreter& interpreter, std::unique_ptr<ast::Sort> sort)
 {
     VisitResult result = sort->accept(interpreter);
+    throwIfError(result);
     EXPECT_FALSE(result.hasValue());
     EXPECT_FALSE(result.isReference());
 }
@@ -86,6 +106,7 @@ loadVariable(GameInterpreter& interpreter, Name targetName)
 {
     ast::Variable loadVariable(targetName);
     VisitResult result = loadVariable.accept(interpreter);
+    throwIfError(result);
 
     EXPECT_TRUE(result.hasValue());
     EXPECT_TRUE(result.isReference());
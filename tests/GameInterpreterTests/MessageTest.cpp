@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+
+
+namespace
+{
+    Value
+    makePlayer(std::string id, std::string name)
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"id"}, Value{String{std::move(id)}});
+        player.setAttribute(String{"name"}, Value{String{std::move(name)}});
+        return Value{player};
+    }
+}
+
+
+TEST(MessageTest, TemplateIsSplitIntoSegments)
+{
+    auto segments = ast::compileMessageTemplate("Round {round}: {winner.name} wins");
+
+    ASSERT_EQ(segments.size(), 5);
+    EXPECT_EQ(segments[0].text, "Round ");
+    EXPECT_EQ(segments[0].expression, nullptr);
+
+    auto round = ast::castExpressionToVariable(segments[1].expression.get());
+    ASSERT_NE(round, nullptr);
+    EXPECT_EQ(round->getName(), Name{"round"});
+
+    EXPECT_EQ(segments[2].text, ": ");
+
+    auto name = ast::castExpressionToAttribute(segments[3].expression.get());
+    ASSERT_NE(name, nullptr);
+    EXPECT_EQ(name->getAttr(), String{"name"});
+    EXPECT_EQ(segments[4].text, " wins");
+
+    EXPECT_EQ(ast::compileMessageTemplate("").size(), 0);
+    EXPECT_THROW(ast::compileMessageTemplate("Round {round"), std::invalid_argument);
+    EXPECT_THROW(ast::compileMessageTemplate("Round {}"), std::invalid_argument);
+}
+
+
+TEST(MessageTest, MessageToAllIsQueuedOnce)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeMessage(nullptr, ast::compileMessageTemplate("Round {round}: {winner.name} wins, {done}"))
+        ).build()}
+    );
+    interpreter.storeVariable(Name{"round"}, Value{Integer{3}});
+    interpreter.storeVariable(Name{"winner"}, makePlayer("1", "Ada"));
+    interpreter.storeVariable(Name{"done"}, Value{Boolean{true}});
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].text, "Round 3: Ada wins, true");
+    EXPECT_TRUE(outputs[0].playerIDs.empty());
+}
+
+
+TEST(MessageTest, MessageToPlayersListsTheirIDs)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeMessage(ast::makeVariable(Name{"players"}), ast::compileMessageTemplate("Your turn"))
+        ).addStatement(
+            ast::makeMessage(ast::makeVariable(Name{"host"}), ast::compileMessageTemplate("You host"))
+        ).build()}
+    );
+    interpreter.storeVariable(
+        Name{"players"},
+        Value{List<Value>{makePlayer("1", "Ada"), makePlayer("2", "Bob")}}
+    );
+    interpreter.storeVariable(Name{"host"}, makePlayer("2", "Bob"));
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[0].text, "Your turn");
+    EXPECT_EQ(outputs[0].playerIDs, (std::vector<String>{String{"1"}, String{"2"}}));
+    EXPECT_EQ(outputs[1].text, "You host");
+    EXPECT_EQ(outputs[1].playerIDs, (std::vector<String>{String{"2"}}));
+}
+
+
+TEST(MessageTest, MissingVariableStopsTheProgram)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeMessage(nullptr, ast::compileMessageTemplate("Score: {score}"))
+        ).build()}
+    );
+
+    interpreter.execute();
+
+    EXPECT_TRUE(interpreter.getError().has_value());
+    EXPECT_TRUE(inputManager.popPendingOutputs().empty());
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <iostream>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+
+
+namespace
+{
+    Value
+    makePlayer(const char* id)
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"id"}, Value{String{id}});
+        return Value{player};
+    }
+
+    void
+    respond(InputManager& inputManager, const char* playerID, const char* answer)
+    {
+        inputManager.handleIncomingMessages(
+            {GameMessage{
+                TextInputMessage{String{playerID}, String{"Enter your answer: "}, String{answer}}
+            }}
+        );
+    }
+}
+
+
+TEST(ParallelForTest, SimpleParallelFor)
+{
+    InputManager inputManager;
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder statementsBuilder;
+
+    List<Value> listOfInts{Value{Integer{10}}, Value{Integer{20}}, Value{Integer{20}}};
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"sum"}),
+                ast::makeConstant(Value{Integer{0}})
+            )
+        )
+        .addStatement(
+            ast::makeParallelFor(
+                ast::makeVariable(Name{"int"}),
+                ast::makeConstant(Value{listOfInts}),
+                statementsBuilder.addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"sum"}),
+                        ast::makeArithmeticOperation(
+                            ast::makeVariable(Name{"sum"}),
+                            ast::makeVariable(Name{"int"}),
+                            ast::ArithmeticOperation::Kind::ADD
+                        )
+                    )
+                ).build()
+            )
+        ).build();
+
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+
+    interpreter.execute();
+
+    EXPECT_EQ(interpreter.needsIO(), false);
+    EXPECT_EQ(
+        loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{50}
+    );
+
+    EXPECT_THROW({
+        loadVariable(interpreter, Name{"int"});
+    }, std::runtime_error);
+}
+
+
+TEST(ParallelForTest, IterationsRequestInputConcurrently)
+{
+    InputManager inputManager;
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder statementsBuilder;
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"answered"}),
+                ast::makeConstant(Value{Integer{0}})
+            )
+        )
+        .addStatement(
+            ast::makeParallelFor(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"players"}),
+                statementsBuilder.addStatement(
+                    // Blocking statement!
+                    ast::makeInputText(
+                        ast::makeVariable(Name{"player"}),
+                        ast::makeVariable(Name{"answer"}),
+                        String{"Enter your answer: "}
+                    )
+                ).addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"answered"}),
+                        ast::makeArithmeticOperation(
+                            ast::makeVariable(Name{"answered"}),
+                            ast::makeConstant(Value{Integer{1}}),
+                            ast::ArithmeticOperation::Kind::ADD
+                        )
+                    )
+                ).build()
+            )
+        ).build();
+
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.storeVariable(
+        Name{"players"}, Value{List<Value>{makePlayer("1"), makePlayer("2")}}
+    );
+
+    interpreter.execute();
+
+    // Both players are asked in the same pass
+    EXPECT_EQ(interpreter.needsIO(), true);
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 2);
+    inputManager.clearPendingRequests();
+
+    // The second player's answer doesn't wait on the first player
+    respond(inputManager, "2", "dog");
+    interpreter.execute();
+
+    EXPECT_EQ(interpreter.needsIO(), true);
+    EXPECT_EQ(inputManager.hasPendingRequests(), false);
+    EXPECT_EQ(
+        loadVariable(interpreter, Name{"answered"}).asInteger(), Integer{1}
+    );
+
+    respond(inputManager, "1", "cat");
+    interpreter.execute();
+
+    EXPECT_EQ(interpreter.needsIO(), false);
+    EXPECT_EQ(interpreter.isDone(), true);
+    EXPECT_EQ(
+        loadVariable(interpreter, Name{"answered"}).asInteger(), Integer{2}
+    );
+
+    EXPECT_THROW({
+        loadVariable(interpreter, Name{"player"});
+    }, std::runtime_error);
+}
+
+
+TEST(ParallelForTest, IterationsKeepTheirOwnVariablesAcrossInputs)
+{
+    InputManager inputManager;
+
+    auto askRange = [](const char* target, const char* prompt) {
+        return ast::makeInputRange(
+            ast::makeVariable(Name{"player"}),
+            ast::makeVariable(Name{target}),
+            String{prompt},
+            ast::makeConstant(Value{Integer{1}}),
+            ast::makeConstant(Value{Integer{100}})
+        );
+    };
+
+    /**
+     * total <- 0
+     * parallel for player in players {
+     *   first <- input range "First: "
+     *   player.bonus <- first
+     *   second <- input range "Second: "
+     *   total <- total + first + player.bonus
+     * }
+     */
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder statementsBuilder;
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"total"}),
+                ast::makeConstant(Value{Integer{0}})
+            )
+        )
+        .addStatement(
+            ast::makeParallelFor(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"players"}),
+                statementsBuilder
+                    .addStatement(askRange("first", "First: "))
+                    .addStatement(
+                        ast::makeAssignment(
+                            ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"bonus"}),
+                            ast::makeVariable(Name{"first"})
+                        )
+                    )
+                    .addStatement(askRange("second", "Second: "))
+                    .addStatement(
+                        ast::makeAssignment(
+                            ast::makeVariable(Name{"total"}),
+                            ast::makeArithmeticOperation(
+                                ast::makeArithmeticOperation(
+                                    ast::makeVariable(Name{"total"}),
+                                    ast::makeVariable(Name{"first"}),
+                                    ast::ArithmeticOperation::Kind::ADD
+                                ),
+                                ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"bonus"}),
+                                ast::ArithmeticOperation::Kind::ADD
+                            )
+                        )
+                    )
+                    .build()
+            )
+        ).build();
+
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.storeVariable(
+        Name{"players"}, Value{List<Value>{makePlayer("1"), makePlayer("2")}}
+    );
+
+    auto respondRange = [&inputManager](const char* playerID, const char* prompt, int value) {
+        inputManager.handleIncomingMessages(
+            {GameMessage{RangeInputMessage{String{playerID}, String{prompt}, Integer{value}}}}
+        );
+    };
+
+    interpreter.execute();
+    respondRange("1", "First: ", 1);
+    respondRange("2", "First: ", 10);
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.needsIO());
+
+    // Both iterations are parked on their second input, each with its own
+    // `first` and its own player
+    respondRange("2", "Second: ", 5);
+    respondRange("1", "Second: ", 5);
+    interpreter.execute();
+
+    ASSERT_TRUE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"total"}).asInteger(), Integer{22});
+    EXPECT_EQ(interpreter.findVariable(Name{"first"}), nullptr);
+}
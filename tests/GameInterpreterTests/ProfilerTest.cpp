@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <sstream>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "Profiler.h"
+
+
+namespace
+{
+    /**
+     * sum <- 0;                       (line 1)
+     * for int in [10, 20, 30] {       (line 2)
+     *   sum <- sum + int;             (line 3)
+     * }
+     */
+    Program
+    makeSumProgram()
+    {
+        ast::StatementsBuilder programBuilder;
+        ast::StatementsBuilder statementsBuilder;
+
+        List<Value> listOfInts{Value{Integer{10}}, Value{Integer{20}}, Value{Integer{30}}};
+
+        auto sumInt = ast::makeAssignment(
+            ast::makeVariable(Name{"sum"}),
+            ast::makeArithmeticOperation(
+                ast::makeVariable(Name{"sum"}),
+                ast::makeVariable(Name{"int"}),
+                ast::ArithmeticOperation::Kind::ADD
+            )
+        );
+        sumInt->setLocation(ast::SourceLocation{3, 3});
+
+        auto init = ast::makeAssignment(
+            ast::makeVariable(Name{"sum"}),
+            ast::makeConstant(Value{Integer{0}})
+        );
+        init->setLocation(ast::SourceLocation{1, 1});
+
+        auto loop = ast::makeForLoop(
+            ast::makeVariable(Name{"int"}),
+            ast::makeConstant(Value{listOfInts}),
+            statementsBuilder.addStatement(std::move(sumInt)).build()
+        );
+        loop->setLocation(ast::SourceLocation{2, 1});
+
+        return Program{
+            programBuilder.addStatement(std::move(init)).addStatement(std::move(loop)).build()
+        };
+    }
+}
+
+
+TEST(ProfilerTest, CountsVisitsPerNodeKindAndStatement)
+{
+#ifndef GAMEENGINE_PROFILING
+    GTEST_SKIP() << "Built without GAMEENGINE_PROFILING";
+#endif
+    InputManager inputManager;
+    Profiler profiler;
+
+    GameInterpreter interpreter(inputManager, makeSumProgram());
+    interpreter.setProfiler(&profiler);
+    interpreter.execute();
+
+    EXPECT_EQ(loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{60});
+
+    EXPECT_EQ(profiler.getNodeStats(ast::NodeKind::FOR_LOOP).visits, 1);
+    EXPECT_EQ(profiler.getNodeStats(ast::NodeKind::ASSIGNMENT).visits, 4);
+    EXPECT_EQ(profiler.getNodeStats(ast::NodeKind::ARITHMETIC_OPERATION).visits, 3);
+    EXPECT_EQ(profiler.getNodeStats(ast::NodeKind::INPUT_TEXT).visits, 0);
+
+    const auto& statements = profiler.getStatementStats();
+    ASSERT_EQ(statements.size(), 3);
+    EXPECT_EQ(statements.at(ast::SourceLocation{1, 1}).visits, 1);
+    EXPECT_EQ(statements.at(ast::SourceLocation{2, 1}).visits, 1);
+    EXPECT_EQ(statements.at(ast::SourceLocation{3, 3}).visits, 3);
+
+    // The loop's time includes its body
+    EXPECT_GE(
+        statements.at(ast::SourceLocation{2, 1}).time,
+        statements.at(ast::SourceLocation{3, 3}).time
+    );
+}
+
+
+TEST(ProfilerTest, MergeAggregatesSessions)
+{
+#ifndef GAMEENGINE_PROFILING
+    GTEST_SKIP() << "Built without GAMEENGINE_PROFILING";
+#endif
+    Profiler total;
+
+    for (int session = 0; session < 2; session++)
+    {
+        InputManager inputManager;
+        Profiler profiler;
+
+        GameInterpreter interpreter(inputManager, makeSumProgram());
+        interpreter.setProfiler(&profiler);
+        interpreter.execute();
+
+        total.merge(profiler);
+    }
+
+    EXPECT_EQ(total.getNodeStats(ast::NodeKind::FOR_LOOP).visits, 2);
+    EXPECT_EQ(total.getStatementStats().at(ast::SourceLocation{3, 3}).visits, 6);
+
+    std::ostringstream out;
+    total.dump(out);
+    EXPECT_NE(out.str().find("ForLoop"), std::string::npos);
+    EXPECT_NE(out.str().find("3:3"), std::string::npos);
+}
+
+
+TEST(ProfilerTest, NothingRecordedWithoutProfiler)
+{
+    InputManager inputManager;
+    Profiler profiler;
+
+    GameInterpreter interpreter(inputManager, makeSumProgram());
+    interpreter.setProfiler(&profiler);
+    interpreter.setProfiler(nullptr);
+    interpreter.execute();
+
+    EXPECT_EQ(profiler.getNodeStats(ast::NodeKind::ASSIGNMENT).visits, 0);
+    EXPECT_TRUE(profiler.getStatementStats().empty());
+}
@@ -391,6 +391,402 @@ TEST(ProgramTest, NestedBlockingProgram)
     );
 }
 
+TEST(ProgramTest, ParkedProgramWaitsForMatchingResponse)
+{
+    /**
+     * Validates that a program parked on input is not re-entered until
+     * the response it is waiting for arrives:
+     *
+     * input choice to player {
+     *   prompt: "Pick one: "
+     *   choices: options
+     *   target: answer
+     * }
+     */
+
+    ast::StatementsBuilder programBuilder;
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeInputChoice(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"answer"}),
+                String{"Pick one: "},
+                ast::makeVariable(Name{"options"})
+            )
+        ).build();
+
+    Map<String, Value> playerMap{};
+    playerMap.setAttribute(String{"id"}, Value{String{"100"}});
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.storeVariable(Name{"player"}, Value{playerMap});
+    interpreter.storeVariable(Name{"options"}, Value{List<Value>{Value{String{"a"}}}});
+
+    interpreter.execute();
+    EXPECT_EQ(interpreter.needsIO(), true);
+    inputManager.clearPendingRequests();
+
+    // Re-entering the statement would fail to evaluate the choices
+    interpreter.storeVariable(Name{"options"}, Value{Integer{0}});
+    EXPECT_NO_THROW(interpreter.execute());
+
+    // A response for another prompt doesn't wake the program either
+    inputManager.handleIncomingMessages(
+        {GameMessage{
+            ChoiceInputMessage{String{"100"}, String{"Other: "}, String{"a"}}
+        }}
+    );
+    EXPECT_NO_THROW(interpreter.execute());
+    EXPECT_EQ(interpreter.needsIO(), true);
+
+    interpreter.storeVariable(Name{"options"}, Value{List<Value>{Value{String{"a"}}}});
+    inputManager.handleIncomingMessages(
+        {GameMessage{
+            ChoiceInputMessage{String{"100"}, String{"Pick one: "}, String{"a"}}
+        }}
+    );
+
+    interpreter.execute();
+    EXPECT_EQ(interpreter.needsIO(), false);
+    EXPECT_TRUE(interpreter.isDone());
+    EXPECT_EQ(
+        loadVariable(interpreter, Name{"answer"}).asString(),
+        String{"a"}
+    );
+}
+
+TEST(ProgramTest, IndependentInputsRequestedTogether)
+{
+    /**
+     * Validates that consecutive inputs that don't depend on each other are
+     * all requested up front, and consumed in program order:
+     *
+     * input range player1 "Bid" 0 100 bid1;
+     * input range player2 "Bid" 0 100 bid2;
+     * input range player1 "Raise" bid1 100 raise;
+     */
+
+    ast::StatementsBuilder programBuilder;
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeInputRange(
+                ast::makeVariable(Name{"player1"}),
+                ast::makeVariable(Name{"bid1"}),
+                String{"Bid"},
+                ast::makeConstant(Value{Integer{0}}),
+                ast::makeConstant(Value{Integer{100}})
+            )
+        )
+        .addStatement(
+            ast::makeInputRange(
+                ast::makeVariable(Name{"player2"}),
+                ast::makeVariable(Name{"bid2"}),
+                String{"Bid"},
+                ast::makeConstant(Value{Integer{0}}),
+                ast::makeConstant(Value{Integer{100}})
+            )
+        )
+        .addStatement(
+            // Depends on the first input, can't be requested early
+            ast::makeInputRange(
+                ast::makeVariable(Name{"player1"}),
+                ast::makeVariable(Name{"raise"}),
+                String{"Raise"},
+                ast::makeVariable(Name{"bid1"}),
+                ast::makeConstant(Value{Integer{100}})
+            )
+        ).build();
+
+    Map<String, Value> player1{};
+    player1.setAttribute(String{"id"}, Value{String{"1"}});
+    Map<String, Value> player2{};
+    player2.setAttribute(String{"id"}, Value{String{"2"}});
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.storeVariable(Name{"player1"}, Value{player1});
+    interpreter.storeVariable(Name{"player2"}, Value{player2});
+
+    interpreter.execute();
+    ASSERT_EQ(inputManager.getPendingRequests().size(), 2);
+    auto* second = std::get_if<GetRangeInputMessage>(&inputManager.getPendingRequests()[1].inner);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->playerID, String{"2"});
+    inputManager.clearPendingRequests();
+
+    // Player 2 answering first doesn't skip ahead of player 1
+    inputManager.handleIncomingMessages(
+        {GameMessage{RangeInputMessage{String{"2"}, String{"Bid"}, Integer{30}}}}
+    );
+    interpreter.execute();
+    EXPECT_EQ(interpreter.needsIO(), true);
+    EXPECT_THROW({
+        loadVariable(interpreter, Name{"bid2"});
+    }, std::runtime_error);
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{RangeInputMessage{String{"1"}, String{"Bid"}, Integer{20}}}}
+    );
+    interpreter.execute();
+
+    EXPECT_EQ(loadVariable(interpreter, Name{"bid1"}).asInteger(), Integer{20});
+    EXPECT_EQ(loadVariable(interpreter, Name{"bid2"}).asInteger(), Integer{30});
+
+    // Only now is the dependent input asked, with the bid as its minimum
+    ASSERT_EQ(inputManager.getPendingRequests().size(), 1);
+    auto* raise = std::get_if<GetRangeInputMessage>(&inputManager.getPendingRequests()[0].inner);
+    ASSERT_NE(raise, nullptr);
+    EXPECT_EQ(raise->prompt, String{"Raise"});
+    EXPECT_EQ(raise->minValue, Integer{20});
+}
+
+TEST(ProgramTest, StepBudgetYieldsAndResumes)
+{
+    /**
+     * Validates that a program over its step budget yields with its
+     * place kept, and finishes over later execute() calls:
+     *
+     * sum <- 0;
+     * for int in [1, 2, ..., 10] {
+     *   sum <- sum + int;
+     * }
+     */
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder statementsBuilder;
+
+    List<Value> listOfInts{};
+    for (int i = 1; i <= 10; i++)
+    {
+        listOfInts.value.push_back(Value{Integer{i}});
+    }
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"sum"}),
+                ast::makeConstant(Value{Integer{0}})
+            )
+        )
+        .addStatement(
+            ast::makeForLoop(
+                ast::makeVariable(Name{"int"}),
+                ast::makeConstant(Value{listOfInts}),
+                statementsBuilder.addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"sum"}),
+                        ast::makeArithmeticOperation(
+                            ast::makeVariable(Name{"sum"}),
+                            ast::makeVariable(Name{"int"}),
+                            ast::ArithmeticOperation::Kind::ADD
+                        )
+                    )
+                ).build()
+            )
+        ).build();
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+    interpreter.setStepBudget(4);
+
+    // 12 steps: the assignment, the loop, and 10 loop body runs
+    interpreter.execute();
+    EXPECT_FALSE(interpreter.isDone());
+    EXPECT_FALSE(interpreter.needsIO());
+    EXPECT_EQ(loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{1 + 2});
+
+    interpreter.execute();
+    EXPECT_FALSE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{1 + 2 + 3 + 4 + 5});
+
+    int calls = 2;
+    while (!interpreter.isDone())
+    {
+        interpreter.execute();
+        calls++;
+    }
+
+    EXPECT_EQ(calls, 4);
+    EXPECT_EQ(loadVariable(interpreter, Name{"sum"}).asInteger(), Integer{55});
+
+    const auto& stats = interpreter.getExecutionStats();
+    EXPECT_EQ(stats.steps, 12 + 3); // the loop is re-entered on each resume
+    EXPECT_EQ(stats.yields, 3);
+    EXPECT_EQ(stats.budgetExceeded, 1);
+
+    // A budget of 0 could never make progress
+    EXPECT_THROW(interpreter.setStepBudget(0), std::invalid_argument);
+    EXPECT_EQ(interpreter.getStepBudget(), std::optional<size_t>{4});
+}
+
+TEST(ProgramTest, SharedProgramKeepsStatePerInterpreter)
+{
+    /**
+     * Validates that interpreters sharing one program each keep their own
+     * variables and place in it:
+     *
+     * input text to player {
+     *   prompt: "Name: "
+     *   target: answer
+     * }
+     * done <- true
+     */
+
+    ast::StatementsBuilder programBuilder;
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeInputText(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"answer"}),
+                String{"Name: "}
+            )
+        )
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"done"}),
+                ast::makeConstant(Value{Boolean{true}})
+            )
+        ).build();
+
+    auto program = std::make_shared<const Program>(Program{std::move(statements)});
+
+    InputManager firstInputManager;
+    InputManager secondInputManager;
+    GameInterpreter first(firstInputManager, program);
+    GameInterpreter second(secondInputManager, program);
+    EXPECT_EQ(program.use_count(), 3);
+
+    Map<String, Value> player{};
+    player.setAttribute(String{"id"}, Value{String{"1"}});
+    first.storeVariable(Name{"player"}, Value{player});
+    second.storeVariable(Name{"player"}, Value{player});
+
+    first.execute();
+    second.execute();
+    ASSERT_TRUE(first.needsIO());
+    ASSERT_TRUE(second.needsIO());
+
+    firstInputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"1"}, String{"Name: "}, String{"ada"}}}}
+    );
+    first.execute();
+
+    EXPECT_TRUE(first.isDone());
+    EXPECT_EQ(loadVariable(first, Name{"answer"}).asString(), String{"ada"});
+    EXPECT_FALSE(second.isDone());
+    EXPECT_THROW({
+        loadVariable(second, Name{"answer"});
+    }, std::runtime_error);
+}
+
+TEST(ProgramTest, RuntimeErrorHaltsProgram)
+{
+    /**
+     * for int in [1, 2] {
+     *   total <- total + int   // total is never set
+     * }
+     * x <- 1
+     */
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder loopBuilder;
+
+    List<Value> listOfInts{Value{Integer{1}}, Value{Integer{2}}};
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeForLoop(
+                ast::makeVariable(Name{"int"}),
+                ast::makeConstant(Value{listOfInts}),
+                loopBuilder.addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"total"}),
+                        ast::makeArithmeticOperation(
+                            ast::makeVariable(Name{"total"}),
+                            ast::makeVariable(Name{"int"}),
+                            ast::ArithmeticOperation::Kind::ADD
+                        )
+                    )
+                ).build()
+            )
+        ).addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeConstant(Value{Integer{1}}))
+        ).build();
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+
+    EXPECT_NO_THROW(interpreter.execute());
+    ASSERT_TRUE(interpreter.getError().has_value());
+    EXPECT_EQ(interpreter.getError()->message, "Variable with name 'total' doesn't exist in map");
+    EXPECT_FALSE(interpreter.isDone());
+    EXPECT_EQ(interpreter.getExecutionStats().steps, 2);
+
+    // Halted, nothing after the failed statement runs
+    interpreter.execute();
+    EXPECT_EQ(interpreter.getExecutionStats().steps, 2);
+    EXPECT_THROW({
+        loadVariable(interpreter, Name{"x"});
+    }, std::runtime_error);
+}
+
+TEST(ProgramTest, InvalidRangeInputIsRequestedAgain)
+{
+    /**
+     * input range to player {
+     *   prompt: "Bet: "
+     *   target: bet
+     *   min: 1
+     *   max: 10
+     * }
+     */
+
+    ast::StatementsBuilder programBuilder;
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeInputRange(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"bet"}),
+                String{"Bet: "},
+                ast::makeConstant(Value{Integer{1}}),
+                ast::makeConstant(Value{Integer{10}})
+            )
+        ).build();
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, Program{std::move(statements)});
+
+    Map<String, Value> player{};
+    player.setAttribute(String{"id"}, Value{String{"1"}});
+    interpreter.storeVariable(Name{"player"}, Value{player});
+
+    interpreter.execute();
+    inputManager.clearPendingRequests();
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{RangeInputMessage{String{"1"}, String{"Bet: "}, Integer{11}}}}
+    );
+    interpreter.execute();
+
+    EXPECT_FALSE(interpreter.getError().has_value());
+    EXPECT_TRUE(interpreter.needsIO());
+    ASSERT_EQ(inputManager.getPendingRequests().size(), 1);
+    inputManager.clearPendingRequests();
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{RangeInputMessage{String{"1"}, String{"Bet: "}, Integer{4}}}}
+    );
+    interpreter.execute();
+
+    EXPECT_TRUE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"bet"}).asInteger(), Integer{4});
+}
+
 TEST(ProgramTest, ExecuteWhenNoProgram)
 {
     InputManager inputManager;
@@ -400,3 +796,28 @@ TEST(ProgramTest, ExecuteWhenNoProgram)
         interpreter.execute();
     }, std::runtime_error);
 }
+
+TEST(ProgramTest, FramePoolReusesFrames)
+{
+    ast::StatementsBuilder programBuilder;
+    Program program{programBuilder.addStatement(
+        ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeConstant(Value{Integer{1}}))
+    ).build()};
+    ProgramRaw raw = program.raw();
+
+    FramePool pool;
+    ProgramIterator* outerAddress = nullptr;
+    {
+        auto outer = pool.acquire(raw.statements);
+        outer->setCurrentContext(ProgramIterator::MatchExecutionContext{pool.acquire(raw.statements), 0});
+        outerAddress = outer.get();
+    }
+    // Both frames came back, the nested one along with its owner
+    EXPECT_EQ(pool.freeFrames(), 2);
+
+    auto reused = pool.acquire(raw.statements);
+    EXPECT_EQ(reused.get(), outerAddress);
+    EXPECT_EQ(reused->getStatementIndex(), 0);
+    EXPECT_FALSE(reused->currentContext<ProgramIterator::MatchExecutionContext>().has_value());
+    EXPECT_EQ(pool.freeFrames(), 1);
+}
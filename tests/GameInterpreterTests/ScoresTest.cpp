@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+#include "Leaderboard.h"
+
+
+namespace
+{
+    Value
+    makePlayer(std::string id, std::string name, int wins)
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"id"}, Value{String{std::move(id)}});
+        player.setAttribute(String{"name"}, Value{String{std::move(name)}});
+        player.setAttribute(String{"wins"}, Value{Integer{wins}});
+        return Value{player};
+    }
+
+    std::vector<std::string>
+    rankedIDs(const Leaderboard& board)
+    {
+        std::vector<std::string> ids;
+        board.forEachTop(board.size(), [&ids](const Leaderboard::Row& row) {
+            ids.push_back(row.playerID.value);
+        });
+        return ids;
+    }
+}
+
+
+TEST(ScoresTest, LeaderboardKeepsPlayersInOrder)
+{
+    Leaderboard board{{String{"wins"}}};
+    board.update(makePlayer("1", "Ada", 2));
+    board.update(makePlayer("2", "Bob", 5));
+    board.update(makePlayer("3", "Cy", 2));
+    board.update(Value{Integer{7}}); // not a player
+
+    EXPECT_EQ(board.size(), 3);
+    EXPECT_EQ(rankedIDs(board), (std::vector<std::string>{"2", "1", "3"}));
+
+    board.update(makePlayer("3", "Cy", 9));
+    EXPECT_EQ(board.size(), 3);
+    EXPECT_EQ(rankedIDs(board), (std::vector<std::string>{"3", "2", "1"}));
+
+    std::vector<std::string> top;
+    board.forEachTop(1, [&top](const Leaderboard::Row& row) { top.push_back(row.name.value); });
+    EXPECT_EQ(top, (std::vector<std::string>{"Cy"}));
+}
+
+
+TEST(ScoresTest, PlayersWithoutAScoreComeLast)
+{
+    Leaderboard board{{String{"wins"}, String{"losses"}}};
+    Map<String, Value> newcomer{};
+    newcomer.setAttribute(String{"id"}, Value{String{"0"}});
+    board.update(Value{newcomer});
+    board.update(makePlayer("1", "Ada", 0));
+
+    EXPECT_EQ(rankedIDs(board), (std::vector<std::string>{"1", "0"}));
+    EXPECT_TRUE(board.tracks(String{"losses"}));
+    EXPECT_FALSE(board.tracks(String{"name"}));
+}
+
+
+TEST(ScoresTest, ScoresFollowAttributeAssignments)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeScores({String{"wins"}})
+        ).addStatement(
+            ast::makeAssignment(
+                ast::makeAttribute(ast::makeVariable(Name{"ada"}), String{"wins"}),
+                ast::makeConstant(Value{Integer{4}})
+            )
+        ).addStatement(
+            ast::makeScores({String{"wins"}})
+        ).build()}
+    );
+    interpreter.storeVariable(Name{"ada"}, makePlayer("1", "Ada", 1));
+    interpreter.storeVariable(Name{"bob"}, makePlayer("2", "Bob", 3));
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[0].text, "Scores:\n1. Bob - wins: 3\n2. Ada - wins: 1");
+    EXPECT_EQ(outputs[1].text, "Scores:\n1. Ada - wins: 4\n2. Bob - wins: 3");
+    EXPECT_TRUE(outputs[1].playerIDs.empty());
+}
+
+
+TEST(ScoresTest, ScoresFollowListChanges)
+{
+    List<Value> newcomers{};
+    newcomers.value.push_back(makePlayer("3", "Cy", 5));
+
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeScores({String{"wins"}})
+        ).addStatement(
+            ast::makeExtend(
+                ast::makeVariable(Name{"players"}),
+                ast::makeConstant(Value{newcomers})
+            )
+        ).addStatement(
+            ast::makeDiscard(
+                ast::makeVariable(Name{"players"}),
+                ast::makeConstant(Value{Integer{1}})
+            )
+        ).addStatement(
+            ast::makeScores({String{"wins"}})
+        ).build()}
+    );
+    List<Value> players{};
+    players.value.push_back(makePlayer("1", "Ada", 1));
+    players.value.push_back(makePlayer("2", "Bob", 3));
+    interpreter.storeVariable(Name{"players"}, Value{players});
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[0].text, "Scores:\n1. Bob - wins: 3\n2. Ada - wins: 1");
+    EXPECT_EQ(outputs[1].text, "Scores:\n1. Cy - wins: 5\n2. Bob - wins: 3");
+}
+
+
+TEST(ScoresTest, OverwrittenPlayersLeaveTheScores)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeScores({String{"wins"}})
+        ).addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"bob"}),
+                ast::makeConstant(makePlayer("3", "Cy", 2))
+            )
+        ).addStatement(
+            ast::makeScores({String{"wins"}})
+        ).build()}
+    );
+    interpreter.storeVariable(Name{"ada"}, makePlayer("1", "Ada", 1));
+    interpreter.storeVariable(Name{"bob"}, makePlayer("2", "Bob", 3));
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[1].text, "Scores:\n1. Cy - wins: 2\n2. Ada - wins: 1");
+}
+
+
+TEST(ScoresTest, StaleCopiesDontHideTheLiveScore)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeScores({String{"wins"}})
+        ).addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"winner"}), ast::makeVariable(Name{"ada"}))
+        ).addStatement(
+            ast::makeAssignment(
+                ast::makeAttribute(ast::makeVariable(Name{"ada"}), String{"wins"}),
+                ast::makeConstant(Value{Integer{5}})
+            )
+        ).addStatement(
+            // Copying the stale copy around doesn't make it the live one
+            ast::makeAssignment(ast::makeVariable(Name{"lastWinner"}), ast::makeVariable(Name{"winner"}))
+        ).addStatement(
+            ast::makeScores({String{"wins"}})
+        ).addStatement(
+            // With the live copy gone, the copies left are all there is
+            ast::makeAssignment(ast::makeVariable(Name{"ada"}), ast::makeConstant(Value{Integer{0}}))
+        ).addStatement(
+            ast::makeScores({String{"wins"}})
+        ).build()}
+    );
+    interpreter.storeVariable(Name{"ada"}, makePlayer("1", "Ada", 1));
+    interpreter.storeVariable(Name{"bob"}, makePlayer("2", "Bob", 3));
+
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 3);
+    EXPECT_EQ(outputs[0].text, "Scores:\n1. Bob - wins: 3\n2. Ada - wins: 1");
+    EXPECT_EQ(outputs[1].text, "Scores:\n1. Ada - wins: 5\n2. Bob - wins: 3");
+    EXPECT_EQ(outputs[2].text, "Scores:\n1. Bob - wins: 3\n2. Ada - wins: 1");
+}
@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+#include <optional>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "Snapshot.h"
+
+
+namespace
+{
+    /**
+     * for round in rounds {
+     *   match round {
+     *     2 => {
+     *       input text to player {
+     *         prompt: "Enter your answer: "
+     *         target: answer
+     *       }
+     *       seen <- seen + round
+     *     }
+     *   }
+     *   total <- total + round
+     * }
+     */
+    Program
+    makeRoundsProgram()
+    {
+        ast::StatementsBuilder programBuilder;
+        ast::StatementsBuilder loopBuilder;
+        ast::StatementsBuilder candidateBuilder;
+        ast::MatchBuilder matchBuilder;
+
+        auto statements = programBuilder
+            .addStatement(
+                ast::makeForLoop(
+                    ast::makeVariable(Name{"round"}),
+                    ast::makeVariable(Name{"rounds"}),
+                    loopBuilder.addStatement(
+                        matchBuilder
+                        .setTarget(ast::makeVariable(Name{"round"}))
+                        .addCandidatePair(
+                            ast::makeConstant(Value{Integer{2}}),
+                            candidateBuilder.addStatement(
+                                // Blocking statement!
+                                ast::makeInputText(
+                                    ast::makeVariable(Name{"player"}),
+                                    ast::makeVariable(Name{"answer"}),
+                                    String{"Enter your answer: "}
+                                )
+                            ).addStatement(
+                                ast::makeAssignment(
+                                    ast::makeVariable(Name{"seen"}),
+                                    ast::makeArithmeticOperation(
+                                        ast::makeVariable(Name{"seen"}),
+                                        ast::makeVariable(Name{"round"}),
+                                        ast::ArithmeticOperation::Kind::ADD
+                                    )
+                                )
+                            ).build()
+                        ).build()
+                    ).addStatement(
+                        ast::makeAssignment(
+                            ast::makeVariable(Name{"total"}),
+                            ast::makeArithmeticOperation(
+                                ast::makeVariable(Name{"total"}),
+                                ast::makeVariable(Name{"round"}),
+                                ast::ArithmeticOperation::Kind::ADD
+                            )
+                        )
+                    ).build()
+                )
+            ).build();
+
+        return Program{std::move(statements)};
+    }
+
+    void
+    storeRoundsVariables(GameInterpreter& interpreter)
+    {
+        Map<String, Value> player{};
+        player.setAttribute(String{"id"}, Value{String{"100"}});
+
+        interpreter.storeVariable(Name{"player"}, Value{player});
+        interpreter.storeVariable(Name{"total"}, Value{Integer{0}});
+        interpreter.storeVariable(Name{"seen"}, Value{Integer{0}});
+        interpreter.storeVariable(
+            Name{"rounds"},
+            Value{List<Value>{Value{Integer{1}}, Value{Integer{2}}, Value{Integer{3}}}}
+        );
+    }
+}
+
+
+TEST(SnapshotTest, ValueRoundTrip)
+{
+    Map<String, Value> map{};
+    map.setAttribute(String{"name"}, Value{String{"rock"}});
+    map.setAttribute(String{"beats"}, Value{List<Value>{Value{String{"scissors"}}}});
+
+    Value value{List<Value>{
+        Value{Integer{-300}},
+        Value{Integer{2147483647}},
+        Value{Boolean{true}},
+        Value{map}
+    }};
+
+    SnapshotWriter writer;
+    writer.writeValue(value);
+    auto bytes = writer.take();
+
+    SnapshotReader reader{bytes};
+    EXPECT_EQ(reader.readValue(), value);
+    EXPECT_TRUE(reader.atEnd());
+}
+
+
+TEST(SnapshotTest, RestoreResumesAtPausedStatement)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, makeRoundsProgram());
+    storeRoundsVariables(interpreter);
+
+    // Parked inside the match, inside the loop's second round
+    interpreter.execute();
+    ASSERT_EQ(interpreter.needsIO(), true);
+    EXPECT_EQ(loadVariable(interpreter, Name{"total"}).asInteger(), Integer{1});
+
+    auto snapshot = interpreter.saveSnapshot();
+
+    InputManager restoredInputManager;
+    GameInterpreter restored(restoredInputManager, makeRoundsProgram());
+    restored.restoreSnapshot(snapshot);
+
+    // The request that was waiting to go out is restored too
+    EXPECT_EQ(restoredInputManager.getPendingRequests().size(), 1);
+    EXPECT_EQ(restored.needsIO(), true);
+    restoredInputManager.clearPendingRequests();
+
+    // The loop target isn't re-evaluated on resume
+    restored.storeVariable(Name{"rounds"}, Value{Integer{0}});
+
+    restoredInputManager.handleIncomingMessages(
+        {GameMessage{
+            TextInputMessage{String{"100"}, String{"Enter your answer: "}, String{"cat"}}
+        }}
+    );
+    restored.execute();
+
+    EXPECT_TRUE(restored.isDone());
+    EXPECT_EQ(loadVariable(restored, Name{"answer"}).asString(), String{"cat"});
+    EXPECT_EQ(loadVariable(restored, Name{"seen"}).asInteger(), Integer{2});
+    EXPECT_EQ(loadVariable(restored, Name{"total"}).asInteger(), Integer{6});
+    EXPECT_THROW({
+        loadVariable(restored, Name{"round"});
+    }, std::runtime_error);
+
+    // The original is unaffected
+    EXPECT_FALSE(interpreter.isDone());
+}
+
+
+TEST(SnapshotTest, BadSnapshotLeavesStateUntouched)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, makeRoundsProgram());
+    storeRoundsVariables(interpreter);
+    interpreter.execute();
+
+    auto snapshot = interpreter.saveSnapshot();
+
+    InputManager otherInputManager;
+    GameInterpreter other(otherInputManager, makeRoundsProgram());
+    storeRoundsVariables(other);
+
+    auto truncated = std::span{snapshot}.first(snapshot.size() - 1);
+    EXPECT_THROW(other.restoreSnapshot(truncated), std::runtime_error);
+
+    SnapshotWriter magic;
+    magic.writeUInt(SNAPSHOT_MAGIC);
+    auto wrongVersion = snapshot;
+    wrongVersion[magic.take().size()] = SNAPSHOT_VERSION + 1;
+    EXPECT_THROW(other.restoreSnapshot(wrongVersion), std::runtime_error);
+
+    // A program with no loop at its first statement can't take this snapshot
+    ast::StatementsBuilder programBuilder;
+    InputManager mismatchedInputManager;
+    GameInterpreter mismatched(
+        mismatchedInputManager,
+        Program{programBuilder.addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeConstant(Value{Integer{1}}))
+        ).build()}
+    );
+    EXPECT_THROW(mismatched.restoreSnapshot(snapshot), std::runtime_error);
+
+    EXPECT_EQ(loadVariable(other, Name{"total"}).asInteger(), Integer{0});
+    other.execute();
+    EXPECT_EQ(loadVariable(other, Name{"total"}).asInteger(), Integer{1});
+    EXPECT_EQ(otherInputManager.getPendingRequests().size(), 1);
+}
+
+
+TEST(SnapshotTest, ForkPlaysOnIndependently)
+{
+    SharedProgram program = std::make_shared<const Program>(makeRoundsProgram());
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, program);
+    storeRoundsVariables(interpreter);
+    interpreter.execute();
+    ASSERT_EQ(interpreter.needsIO(), true);
+
+    InputManager forkInputManager;
+    GameInterpreter fork(forkInputManager, program);
+    fork.forkFrom(interpreter);
+
+    // Waiting on the same request, which is copied rather than moved
+    EXPECT_EQ(fork.needsIO(), true);
+    EXPECT_EQ(forkInputManager.getPendingRequests().size(), 1);
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 1);
+
+    forkInputManager.handleIncomingMessages(
+        {GameMessage{
+            TextInputMessage{String{"100"}, String{"Enter your answer: "}, String{"fork"}}
+        }}
+    );
+    fork.storeVariable(Name{"seen"}, Value{Integer{10}});
+    fork.execute();
+
+    EXPECT_TRUE(fork.isDone());
+    EXPECT_EQ(loadVariable(fork, Name{"answer"}).asString(), String{"fork"});
+    EXPECT_EQ(loadVariable(fork, Name{"seen"}).asInteger(), Integer{12});
+    EXPECT_EQ(loadVariable(fork, Name{"total"}).asInteger(), Integer{6});
+
+    // Nothing the fork did reaches the original, which plays on by itself
+    EXPECT_FALSE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"seen"}).asInteger(), Integer{0});
+    EXPECT_EQ(loadVariable(interpreter, Name{"total"}).asInteger(), Integer{1});
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{
+            TextInputMessage{String{"100"}, String{"Enter your answer: "}, String{"original"}}
+        }}
+    );
+    interpreter.execute();
+
+    EXPECT_TRUE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"answer"}).asString(), String{"original"});
+    EXPECT_EQ(loadVariable(interpreter, Name{"seen"}).asInteger(), Integer{2});
+    EXPECT_EQ(loadVariable(fork, Name{"answer"}).asString(), String{"fork"});
+}
+
+
+TEST(SnapshotTest, ForkSharesWhatItOnlyReads)
+{
+    SharedProgram program = std::make_shared<const Program>(makeRoundsProgram());
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, program);
+    storeRoundsVariables(interpreter);
+    interpreter.execute();
+
+    InputManager forkInputManager;
+    GameInterpreter fork(forkInputManager, program);
+    fork.forkFrom(interpreter);
+
+    forkInputManager.handleIncomingMessages(
+        {GameMessage{
+            TextInputMessage{String{"100"}, String{"Enter your answer: "}, String{"fork"}}
+        }}
+    );
+    fork.execute();
+    ASSERT_TRUE(fork.isDone());
+
+    // The fork read the player's id and the rounds but never changed them,
+    // so both games still hold the original values
+    EXPECT_EQ(fork.findVariable(Name{"player"}), interpreter.findVariable(Name{"player"}));
+    EXPECT_EQ(fork.findVariable(Name{"rounds"}), interpreter.findVariable(Name{"rounds"}));
+    EXPECT_NE(fork.findVariable(Name{"total"}), interpreter.findVariable(Name{"total"}));
+}
+
+TEST(SnapshotTest, ForkNeedsTheSameProgram)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, makeRoundsProgram());
+    storeRoundsVariables(interpreter);
+    interpreter.execute();
+
+    // Same rules, but compiled separately
+    InputManager otherInputManager;
+    GameInterpreter other(otherInputManager, makeRoundsProgram());
+    EXPECT_THROW(other.forkFrom(interpreter), std::runtime_error);
+}
+
+
+TEST(SnapshotTest, FailedGameStaysFailedWhenRestored)
+{
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, makeRoundsProgram());
+    storeRoundsVariables(interpreter);
+    interpreter.storeVariable(
+        Name{"rounds"},
+        Value{List<Value>{Value{Integer{1}}, Value{String{"two"}}}}
+    );
+
+    // Adding the second round to the total fails
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.getError().has_value());
+
+    auto snapshot = interpreter.saveSnapshot();
+
+    InputManager restoredInputManager;
+    GameInterpreter restored(restoredInputManager, makeRoundsProgram());
+    restored.restoreSnapshot(snapshot);
+
+    ASSERT_TRUE(restored.getError().has_value());
+    EXPECT_EQ(restored.getError()->message, interpreter.getError()->message);
+
+    // It doesn't run the failed statement again
+    restored.execute();
+    EXPECT_EQ(loadVariable(restored, Name{"total"}).asInteger(), Integer{1});
+}
+
+
+TEST(SnapshotTest, RestoreChecksVariableTypes)
+{
+    auto makeProgram = [](Value value) {
+        ast::StatementsBuilder programBuilder;
+        Program program{programBuilder.addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeConstant(std::move(value)))
+        ).build()};
+        program.variableTypes = ast::inferTypes(program.raw().statements);
+        return program;
+    };
+
+    InputManager textInputManager;
+    GameInterpreter text(textInputManager, makeProgram(Value{String{"a"}}));
+    text.storeVariable(Name{"x"}, Value{String{"b"}});
+    auto snapshot = text.saveSnapshot();
+
+    // Same shape, but this program's x is an Integer
+    InputManager numberInputManager;
+    GameInterpreter number(numberInputManager, makeProgram(Value{Integer{1}}));
+    EXPECT_THROW(number.restoreSnapshot(snapshot), std::runtime_error);
+    EXPECT_EQ(number.findVariable(Name{"x"}), nullptr);
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <optional>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "TypeInference.h"
+
+
+TEST(TypeInferenceTest, InfersVariableAndExpressionTypes)
+{
+    /**
+     * total <- 0
+     * for round in 3.upfrom(1) {
+     *   total <- total + round
+     * }
+     * input range to player {
+     *   prompt: "Bet: "
+     *   target: bet
+     *   min: 1
+     *   max: total
+     * }
+     * mixed <- 1
+     * mixed <- player.name
+     * over <- mixed < bet
+     */
+
+    ast::StatementsBuilder programBuilder;
+    ast::StatementsBuilder loopBuilder;
+    ast::ExpressionsBuilder argsBuilder;
+
+    auto sum = ast::makeArithmeticOperation(
+        ast::makeVariable(Name{"total"}),
+        ast::makeVariable(Name{"round"}),
+        ast::ArithmeticOperation::Kind::ADD
+    );
+    ast::ArithmeticOperation* sumPtr = sum.get();
+
+    auto comparison = ast::makeComparison(
+        ast::makeVariable(Name{"mixed"}),
+        ast::makeVariable(Name{"bet"}),
+        ast::Comparison::Kind::LT
+    );
+    ast::Comparison* comparisonPtr = comparison.get();
+
+    auto statements = programBuilder
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"total"}), ast::makeConstant(Value{Integer{0}}))
+        )
+        .addStatement(
+            ast::makeForLoop(
+                ast::makeVariable(Name{"round"}),
+                ast::makeCallable(
+                    ast::makeConstant(Value{Integer{3}}),
+                    argsBuilder.addExpression(ast::makeConstant(Value{Integer{1}})).build(),
+                    ast::Callable::Kind::UP_FROM
+                ),
+                loopBuilder.addStatement(
+                    ast::makeAssignment(ast::makeVariable(Name{"total"}), std::move(sum))
+                ).build()
+            )
+        )
+        .addStatement(
+            ast::makeInputRange(
+                ast::makeVariable(Name{"player"}),
+                ast::makeVariable(Name{"bet"}),
+                String{"Bet: "},
+                ast::makeConstant(Value{Integer{1}}),
+                ast::makeVariable(Name{"total"})
+            )
+        )
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"mixed"}), ast::makeConstant(Value{Integer{1}}))
+        )
+        .addStatement(
+            ast::makeAssignment(
+                ast::makeVariable(Name{"mixed"}),
+                ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"name"})
+            )
+        )
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"over"}), std::move(comparison))
+        ).build();
+
+    Program program{std::move(statements)};
+    ast::VariableTypes types = ast::inferTypes(program.raw().statements);
+
+    EXPECT_EQ(types.at("total"), ValueType::INTEGER);
+    EXPECT_EQ(types.at("round"), ValueType::INTEGER);
+    EXPECT_EQ(types.at("bet"), ValueType::INTEGER);
+    EXPECT_EQ(types.at("over"), ValueType::BOOLEAN);
+    // Given values of more than one type, or only by the host
+    EXPECT_FALSE(types.contains("mixed"));
+    EXPECT_FALSE(types.contains("player"));
+
+    EXPECT_EQ(sumPtr->getStaticType(), ValueType::INTEGER);
+    EXPECT_EQ(sumPtr->getLeft()->getStaticType(), ValueType::INTEGER);
+    EXPECT_EQ(sumPtr->getRight()->getStaticType(), ValueType::INTEGER);
+    EXPECT_EQ(comparisonPtr->getLeft()->getStaticType(), ValueType::UNKNOWN);
+    EXPECT_EQ(comparisonPtr->getRight()->getStaticType(), ValueType::INTEGER);
+}
+
+
+TEST(TypeInferenceTest, SpecializedProgramRunsTheSame)
+{
+    /**
+     * total <- 0
+     * done <- false
+     * for int in [1, 2, 3] {
+     *   total <- total + int
+     *   done <- not (done or (total < 3))
+     * }
+     */
+
+    auto makeProgram = []() {
+        ast::StatementsBuilder programBuilder;
+        ast::StatementsBuilder loopBuilder;
+
+        List<Value> listOfInts{Value{Integer{1}}, Value{Integer{2}}, Value{Integer{3}}};
+
+        auto statements = programBuilder
+            .addStatement(
+                ast::makeAssignment(ast::makeVariable(Name{"total"}), ast::makeConstant(Value{Integer{0}}))
+            )
+            .addStatement(
+                ast::makeAssignment(ast::makeVariable(Name{"done"}), ast::makeConstant(Value{Boolean{false}}))
+            )
+            .addStatement(
+                ast::makeForLoop(
+                    ast::makeVariable(Name{"int"}),
+                    ast::makeConstant(Value{listOfInts}),
+                    loopBuilder.addStatement(
+                        ast::makeAssignment(
+                            ast::makeVariable(Name{"total"}),
+                            ast::makeArithmeticOperation(
+                                ast::makeVariable(Name{"total"}),
+                                ast::makeVariable(Name{"int"}),
+                                ast::ArithmeticOperation::Kind::ADD
+                            )
+                        )
+                    ).addStatement(
+                        ast::makeAssignment(
+                            ast::makeVariable(Name{"done"}),
+                            ast::makeUnaryOperation(
+                                ast::makeLogicalOperation(
+                                    ast::makeVariable(Name{"done"}),
+                                    ast::makeComparison(
+                                        ast::makeVariable(Name{"total"}),
+                                        ast::makeConstant(Value{Integer{3}}),
+                                        ast::Comparison::Kind::LT
+                                    ),
+                                    ast::LogicalOperation::Kind::OR
+                                ),
+                                ast::UnaryOperation::Kind::NOT
+                            )
+                        )
+                    ).build()
+                )
+            ).build();
+
+        return Program{std::move(statements)};
+    };
+
+    Program specialized = makeProgram();
+    specialized.variableTypes = ast::inferTypes(specialized.raw().statements);
+    ASSERT_EQ(specialized.variableTypes.at("int"), ValueType::INTEGER);
+
+    InputManager genericInputManager;
+    GameInterpreter generic(genericInputManager, makeProgram());
+    generic.execute();
+
+    InputManager specializedInputManager;
+    GameInterpreter interpreter(specializedInputManager, std::move(specialized));
+    interpreter.execute();
+
+    ASSERT_TRUE(interpreter.isDone());
+    EXPECT_EQ(loadVariable(interpreter, Name{"total"}), loadVariable(generic, Name{"total"}));
+    EXPECT_EQ(loadVariable(interpreter, Name{"done"}), loadVariable(generic, Name{"done"}));
+    EXPECT_EQ(loadVariable(interpreter, Name{"total"}).asInteger(), Integer{6});
+}
+
+
+TEST(TypeInferenceTest, StoringConflictingTypeThrows)
+{
+    ast::StatementsBuilder programBuilder;
+
+    Program program{programBuilder.addStatement(
+        ast::makeAssignment(ast::makeVariable(Name{"score"}), ast::makeConstant(Value{Integer{0}}))
+    ).build()};
+    program.variableTypes = ast::inferTypes(program.raw().statements);
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, std::move(program));
+
+    EXPECT_NO_THROW(interpreter.storeVariable(Name{"score"}, Value{Integer{5}}));
+    EXPECT_NO_THROW(interpreter.storeVariable(Name{"other"}, Value{String{"a"}}));
+    EXPECT_THROW(interpreter.storeVariable(Name{"score"}, Value{String{"a"}}), std::runtime_error);
+}
+
+
+TEST(TypeInferenceTest, HostStoredVariablesAreUnknown)
+{
+    /**
+     * x <- 0
+     * x <- player1
+     * y <- x + 1
+     */
+
+    ast::StatementsBuilder programBuilder;
+
+    auto sum = ast::makeArithmeticOperation(
+        ast::makeVariable(Name{"x"}),
+        ast::makeConstant(Value{Integer{1}}),
+        ast::ArithmeticOperation::Kind::ADD
+    );
+    ast::ArithmeticOperation* sumPtr = sum.get();
+
+    Program program{programBuilder
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeConstant(Value{Integer{0}}))
+        )
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"x"}), ast::makeVariable(Name{"player1"}))
+        )
+        .addStatement(
+            ast::makeAssignment(ast::makeVariable(Name{"y"}), std::move(sum))
+        ).build()};
+    program.variableTypes = ast::inferTypes(program.raw().statements);
+
+    // player1 is stored by the host, which could store anything
+    EXPECT_FALSE(program.variableTypes.contains("x"));
+    EXPECT_FALSE(program.variableTypes.contains("player1"));
+    EXPECT_EQ(program.variableTypes.at("y"), ValueType::INTEGER);
+    EXPECT_EQ(sumPtr->getLeft()->getStaticType(), ValueType::UNKNOWN);
+
+    Map<String, Value> player{};
+    player.setAttribute(String{"name"}, Value{String{"a"}});
+
+    InputManager inputManager;
+    GameInterpreter interpreter(inputManager, std::move(program));
+    interpreter.storeVariable(Name{"player1"}, Value{player});
+    interpreter.execute();
+    EXPECT_TRUE(interpreter.getError().has_value());
+}
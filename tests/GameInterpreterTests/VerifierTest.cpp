@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+#include "Verifier.h"
+
+
+namespace
+{
+    std::optional<RuntimeError>
+    verify(std::vector<std::unique_ptr<ast::Statement>> statements)
+    {
+        return ast::verifyStructure(ast::rawStatements(statements));
+    }
+}
+
+
+TEST(VerifierTest, WellFormedProgramPasses)
+{
+    ast::StatementsBuilder body;
+    body.addStatement(ast::makeAssignment(
+        ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"score"}),
+        ast::makeCallable(ast::makeVariable(Name{"cards"}), {}, ast::Callable::Kind::SIZE)
+    ));
+
+    ast::StatementsBuilder builder;
+    builder.addStatement(ast::makeForLoop(
+        ast::makeVariable(Name{"player"}),
+        ast::makeVariable(Name{"players"}),
+        body.build()
+    )).addStatement(
+        ast::makeShuffle(ast::makeVariable(Name{"cards"}))
+    );
+
+    EXPECT_FALSE(verify(builder.build()).has_value());
+}
+
+
+TEST(VerifierTest, FindsProblemsInNestedBodies)
+{
+    ast::StatementsBuilder body;
+    body.addStatement(ast::makeAssignment(
+        ast::makeConstant(Value{Integer{1}}),
+        ast::makeConstant(Value{Integer{2}})
+    ));
+
+    ast::StatementsBuilder builder;
+    builder.addStatement(ast::makeForLoop(
+        ast::makeVariable(Name{"player"}),
+        ast::makeVariable(Name{"players"}),
+        body.build()
+    ));
+
+    auto error = verify(builder.build());
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->message, "Assignment target must be a Variable or an Attribute");
+}
+
+
+TEST(VerifierTest, ChecksAttributeBasesAndArity)
+{
+    ast::StatementsBuilder badBase;
+    badBase.addStatement(ast::makeReverse(
+        ast::makeAttribute(ast::makeConstant(Value{Integer{1}}), String{"cards"})
+    ));
+    EXPECT_TRUE(verify(badBase.build()).has_value());
+
+    std::vector<std::unique_ptr<ast::Expression>> args;
+    args.push_back(ast::makeConstant(Value{Integer{1}}));
+    ast::StatementsBuilder badArity;
+    badArity.addStatement(ast::makeAssignment(
+        ast::makeVariable(Name{"count"}),
+        ast::makeCallable(ast::makeVariable(Name{"cards"}), std::move(args), ast::Callable::Kind::SIZE)
+    ));
+    EXPECT_TRUE(verify(badArity.build()).has_value());
+
+    ast::StatementsBuilder noScores;
+    noScores.addStatement(ast::makeScores({}));
+    EXPECT_TRUE(verify(noScores.build()).has_value());
+}
+
+
+TEST(VerifierTest, VerifiedProgramRunsTheSame)
+{
+    auto makeProgram = [](bool verified) {
+        std::vector<std::unique_ptr<ast::Expression>> args;
+        args.push_back(ast::makeConstant(Value{Integer{1}}));
+
+        ast::StatementsBuilder builder;
+        Program program{builder.addStatement(ast::makeAssignment(
+            ast::makeVariable(Name{"numbers"}),
+            ast::makeCallable(ast::makeConstant(Value{Integer{4}}), std::move(args), ast::Callable::Kind::UP_FROM)
+        )).addStatement(
+            ast::makeReverse(ast::makeVariable(Name{"numbers"}))
+        ).addStatement(ast::makeAssignment(
+            ast::makeAttribute(ast::makeVariable(Name{"player"}), String{"count"}),
+            ast::makeCallable(ast::makeVariable(Name{"numbers"}), {}, ast::Callable::Kind::SIZE)
+        )).build()};
+
+        EXPECT_FALSE(ast::verifyStructure(program.raw().statements).has_value());
+        program.verified = verified;
+        return program;
+    };
+
+    for (bool verified : {false, true})
+    {
+        InputManager inputManager;
+        GameInterpreter interpreter(inputManager, makeProgram(verified));
+        interpreter.storeVariable(Name{"player"}, Value{Map<String, Value>{}});
+
+        interpreter.execute();
+        ASSERT_TRUE(interpreter.isDone());
+        EXPECT_FALSE(interpreter.getError().has_value());
+
+        List<Value> expected{Value{Integer{4}}, Value{Integer{3}}, Value{Integer{2}}, Value{Integer{1}}};
+        EXPECT_EQ(*interpreter.findVariable(Name{"numbers"}), Value{expected});
+
+        Map<String, Value> player{};
+        player.setAttribute(String{"count"}, Value{Integer{4}});
+        EXPECT_EQ(*interpreter.findVariable(Name{"player"}), Value{player});
+    }
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include "Helpers.h"
+#include "GameInterpreter.h"
+#include "InputManager.h"
+#include "VoteTally.h"
+
+
+namespace
+{
+    List<Value>
+    makeChoices()
+    {
+        return List<Value>{Value{String{"rock"}}, Value{String{"paper"}}, Value{String{"scissors"}}};
+    }
+
+    Value
+    makeVoters(size_t count)
+    {
+        List<Value> voters{};
+        for (size_t i = 0; i < count; ++i)
+        {
+            Map<String, Value> voter{};
+            voter.setAttribute(String{"id"}, Value{String{std::to_string(i)}});
+            voters.value.push_back(Value{voter});
+        }
+        return Value{voters};
+    }
+
+    GameMessage
+    makeVote(size_t voter, std::string choice)
+    {
+        return GameMessage{VoteInputMessage{String{std::to_string(voter)}, String{"Throw?"}, String{std::move(choice)}}};
+    }
+}
+
+
+TEST(VoteTest, TallyTracksLeaderAndTopChoices)
+{
+    VoteTally tally{{String{"a"}, String{"b"}, String{"c"}, String{"a"}}, 6};
+    EXPECT_EQ(tally.getChoices().size(), 3);
+
+    EXPECT_TRUE(tally.cast(String{"c"}));
+    EXPECT_TRUE(tally.cast(String{"b"}));
+    EXPECT_TRUE(tally.cast(String{"c"}));
+    EXPECT_FALSE(tally.cast(String{"d"}));
+
+    EXPECT_EQ(tally.getVotesCast(), 3);
+    EXPECT_EQ(tally.getWinner(), String{"c"});
+    EXPECT_EQ(tally.top(2), (std::vector<std::pair<String, size_t>>{{String{"c"}, 2}, {String{"b"}, 1}}));
+    EXPECT_EQ(tally.top(10).size(), 3);
+
+    // b ties c, and would win a tie only if listed first
+    EXPECT_TRUE(tally.cast(String{"b"}));
+    EXPECT_EQ(tally.getWinner(), String{"b"});
+    EXPECT_FALSE(tally.isClosed());
+}
+
+
+TEST(VoteTest, TallyClosesOnceTheWinnerIsCertain)
+{
+    VoteTally tally{{String{"yes"}, String{"no"}}, 5};
+    tally.cast(String{"no"});
+    tally.cast(String{"no"});
+    EXPECT_FALSE(tally.isDecided());
+
+    tally.cast(String{"no"}); // 3 against at most 2
+    EXPECT_TRUE(tally.isClosed());
+    EXPECT_EQ(tally.getVotesRemaining(), 2);
+    EXPECT_EQ(tally.getWinner(), String{"no"});
+
+    VoteTally single{{String{"only"}}, 100};
+    EXPECT_TRUE(single.isClosed());
+    EXPECT_THROW((VoteTally{{}, 1}), std::invalid_argument);
+}
+
+
+TEST(VoteTest, GroupVoteCountsEachVoterOnce)
+{
+    InputManager inputManager;
+    std::vector<String> voters{String{"0"}, String{"1"}, String{"2"}, String{"1"}};
+    RequestID voteID = NO_REQUEST_ID;
+
+    EXPECT_FALSE(inputManager.getGroupVote(voters, String{"Throw?"}, makeChoices(), voteID));
+    InputWaitKey key{String{}, String{"Throw?"}, voteID};
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 3);
+    inputManager.clearPendingRequests();
+
+    inputManager.handleIncomingMessages({makeVote(0, "paper"), makeVote(0, "paper"), makeVote(1, "lizard")});
+    EXPECT_FALSE(inputManager.hasResponse(key));
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"0"}, String{"Throw?"}}));
+
+    // The invalid vote is asked for again
+    ASSERT_EQ(inputManager.getPendingRequests().size(), 1);
+    EXPECT_NE(std::get_if<GetVoteInputMessage>(&inputManager.getPendingRequests()[0].inner), nullptr);
+
+    inputManager.handleIncomingMessages({makeVote(1, "rock"), makeVote(2, "paper")});
+    ASSERT_TRUE(inputManager.hasResponse(key));
+
+    auto tally = inputManager.getGroupVote(voters, String{"Throw?"}, makeChoices(), voteID);
+    ASSERT_TRUE(tally);
+    EXPECT_EQ(tally->getWinner(), String{"paper"});
+    EXPECT_EQ(tally->getCount(String{"paper"}), 2);
+    EXPECT_FALSE(inputManager.hasResponse(key));
+}
+
+
+TEST(VoteTest, VotesOnTheSamePromptAreCountedApart)
+{
+    InputManager inputManager;
+    std::vector<String> red{String{"0"}, String{"1"}};
+    std::vector<String> blue{String{"2"}, String{"3"}};
+    RequestID redVote = NO_REQUEST_ID;
+    RequestID blueVote = NO_REQUEST_ID;
+
+    EXPECT_FALSE(inputManager.getGroupVote(red, String{"Throw?"}, makeChoices(), redVote));
+    EXPECT_FALSE(inputManager.getGroupVote(blue, String{"Throw?"}, makeChoices(), blueVote));
+    EXPECT_NE(redVote, blueVote);
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 4);
+
+    inputManager.handleIncomingMessages({makeVote(0, "rock"), makeVote(1, "rock"), makeVote(2, "paper")});
+    EXPECT_TRUE(inputManager.hasResponse(InputWaitKey{String{}, String{"Throw?"}, redVote}));
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{}, String{"Throw?"}, blueVote}));
+
+    auto redTally = inputManager.getGroupVote(red, String{"Throw?"}, makeChoices(), redVote);
+    ASSERT_TRUE(redTally);
+    EXPECT_EQ(redTally->getCount(String{"rock"}), 2);
+    EXPECT_EQ(redTally->getCount(String{"paper"}), 0);
+
+    inputManager.handleIncomingMessages({makeVote(3, "paper")});
+    auto blueTally = inputManager.getGroupVote(blue, String{"Throw?"}, makeChoices(), blueVote);
+    ASSERT_TRUE(blueTally);
+    EXPECT_EQ(blueTally->getWinner(), String{"paper"});
+    EXPECT_EQ(blueTally->getCount(String{"rock"}), 0);
+}
+
+TEST(VoteTest, VoteStatementStopsWaitingOnceDecided)
+{
+    ast::StatementsBuilder builder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeInputVote(
+                ast::makeVariable(Name{"players"}),
+                ast::makeVariable(Name{"throw"}),
+                String{"Throw?"},
+                ast::makeConstant(Value{makeChoices()})
+            )
+        ).build()}
+    );
+    interpreter.storeVariable(Name{"players"}, makeVoters(5));
+
+    interpreter.execute();
+    EXPECT_FALSE(interpreter.isDone());
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 5);
+
+    inputManager.handleIncomingMessages({makeVote(0, "scissors"), makeVote(1, "scissors")});
+    interpreter.execute();
+    EXPECT_FALSE(interpreter.isDone());
+
+    // Three of five: the last two can't change the outcome
+    inputManager.handleIncomingMessages({makeVote(4, "scissors")});
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+    EXPECT_EQ(*interpreter.findVariable(Name{"throw"}), Value{String{"scissors"}});
+
+    // Late votes for the closed vote aren't waited for or counted
+    inputManager.handleIncomingMessages({makeVote(2, "rock")});
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 0);
+    EXPECT_FALSE(inputManager.hasPendingRequests());
+}
+
+
+TEST(VoteTest, EachTeamVotesOnItsOwn)
+{
+    /**
+     * parallel for team in teams {
+     *   voters <- team.players
+     *   input vote to voters { prompt: "Throw?", target: pick }
+     *   message "{team.name} threw {pick}"
+     * }
+     */
+    ast::StatementsBuilder builder;
+    ast::StatementsBuilder bodyBuilder;
+    InputManager inputManager;
+    GameInterpreter interpreter(
+        inputManager,
+        Program{builder.addStatement(
+            ast::makeParallelFor(
+                ast::makeVariable(Name{"team"}),
+                ast::makeVariable(Name{"teams"}),
+                bodyBuilder.addStatement(
+                    ast::makeAssignment(
+                        ast::makeVariable(Name{"voters"}),
+                        ast::makeAttribute(ast::makeVariable(Name{"team"}), String{"players"})
+                    )
+                ).addStatement(
+                    ast::makeInputVote(
+                        ast::makeVariable(Name{"voters"}),
+                        ast::makeVariable(Name{"pick"}),
+                        String{"Throw?"},
+                        ast::makeConstant(Value{makeChoices()})
+                    )
+                ).addStatement(
+                    ast::makeMessage(nullptr, ast::compileMessageTemplate("{team.name} threw {pick}"))
+                ).build()
+            )
+        ).build()}
+    );
+    List<Value> teams{};
+    for (size_t first : {0, 2})
+    {
+        List<Value> players = makeVoters(first + 2).asList();
+        players.value.erase(players.value.begin(), players.value.begin() + first);
+        Map<String, Value> team{};
+        team.setAttribute(String{"name"}, Value{String{first == 0 ? "Red" : "Blue"}});
+        team.setAttribute(String{"players"}, Value{players});
+        teams.value.push_back(Value{team});
+    }
+    interpreter.storeVariable(Name{"teams"}, Value{teams});
+
+    interpreter.execute();
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 4);
+
+    // Red's vote is decided, Blue's has one of two votes in
+    inputManager.handleIncomingMessages({makeVote(0, "rock"), makeVote(1, "rock"), makeVote(2, "paper")});
+    interpreter.execute();
+    EXPECT_FALSE(interpreter.isDone());
+
+    inputManager.handleIncomingMessages({makeVote(3, "paper")});
+    interpreter.execute();
+    ASSERT_TRUE(interpreter.isDone());
+
+    auto outputs = inputManager.popPendingOutputs();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[0].text, "Red threw rock");
+    EXPECT_EQ(outputs[1].text, "Blue threw paper");
+}
+
+TEST(VoteTest, OpenVoteSurvivesASnapshot)
+{
+    InputManager inputManager;
+    std::vector<String> voters{String{"0"}, String{"1"}, String{"2"}};
+    RequestID voteID = NO_REQUEST_ID;
+    inputManager.getGroupVote(voters, String{"Throw?"}, makeChoices(), voteID);
+    inputManager.handleIncomingMessages({makeVote(0, "rock")});
+
+    SnapshotWriter writer;
+    inputManager.saveSnapshot(writer);
+    auto bytes = writer.take();
+    InputManager restored;
+    SnapshotReader reader{bytes};
+    restored.restoreSnapshot(reader);
+
+    restored.handleIncomingMessages({makeVote(1, "rock")});
+    auto tally = restored.getGroupVote(voters, String{"Throw?"}, makeChoices(), voteID);
+    ASSERT_TRUE(tally);
+    EXPECT_EQ(tally->getWinner(), String{"rock"});
+    EXPECT_EQ(tally->getCount(String{"rock"}), 2);
+}
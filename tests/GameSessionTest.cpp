@@ -156,6 +156,38 @@ TEST(GameSessionTest, TickGeneratesRequestsAfterInputRangeRule) {
     EXPECT_TRUE(tickOut.empty());
 }
 
+TEST(GameSessionTest, ChoiceRequestsCarryTheirChoices) {
+    std::vector<std::unique_ptr<Statement>> stmts;
+    stmts.push_back(
+        makeInputChoice(
+            makeVariable(Name{"player1"}),
+            makeVariable(Name{"pick"}),
+            String{"Pick"},
+            makeConstant(Value{List<Value>{Value{String{"Rock"}}, Value{Integer{2}}}})
+        )
+    );
+
+    GameRules rules{std::move(stmts)};
+
+    std::vector<LobbyMember> players = {
+        {1, "player", LobbyRole::Player, true}
+    };
+
+    GameSession session("lobby_test", std::move(rules), players);
+
+    bool foundRequest = false;
+    for (auto &msg : session.start()) {
+        if (msg.message.type == MessageType::RequestChoiceInput) {
+            const auto& request = std::get<RequestChoiceInputMessage>(msg.message.data);
+            ASSERT_TRUE(request.choices);
+            EXPECT_EQ(*request.choices, (std::vector<std::string>{"Rock", "2"}));
+            foundRequest = true;
+        }
+    }
+
+    EXPECT_TRUE(foundRequest);
+}
+
 TEST(GameSessionTest, TickRoutesInputAndContinuesExecution) {
     std::vector<LobbyMember> players = {
         {1, "player", LobbyRole::Player, true}
@@ -184,3 +216,28 @@ TEST(GameSessionTest, TickRoutesInputAndContinuesExecution) {
 
     ASSERT_TRUE(foundOver);
 }
+
+TEST(GameSessionTest, ForkFinishesWithoutTheOriginal) {
+    std::vector<LobbyMember> players = {
+        {1, "player", LobbyRole::Player, true}
+    };
+
+    auto rules = makeTrivialRules();
+    GameSession session("lobby_test", std::move(rules), players);
+    session.start();
+
+    auto fork = session.fork();
+    ASSERT_FALSE(fork->isFinished());
+
+    ClientMessage incoming{
+        1,
+        { MessageType::ResponseTextInput, ResponseTextInputMessage{"Hi!", "Hello!"} }
+    };
+    fork->tick({incoming});
+
+    EXPECT_TRUE(fork->isFinished());
+    EXPECT_FALSE(session.isFinished());
+
+    session.tick({incoming});
+    EXPECT_TRUE(session.isFinished());
+}
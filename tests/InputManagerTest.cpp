@@ -80,7 +80,7 @@ TEST_F(InputManagerTest, ChoiceRequest) {
     auto messages = inputManager.getPendingRequests();
     auto* getChoice = std::get_if<GetChoiceInputMessage>(&messages[0].inner);
     ASSERT_NE(getChoice, nullptr);
-    EXPECT_EQ(getChoice->choices.value.size(), 2);
+    EXPECT_EQ(getChoice->choices->value.size(), 2);
 }
 
 TEST_F(InputManagerTest, ChoiceResponse) {
@@ -117,9 +117,21 @@ TEST_F(InputManagerTest, RangeOnOutOfRange) {
     };
     inputManager.handleIncomingMessages(responses);
 
-    EXPECT_THROW({
-        inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10});
-    }, std::runtime_error);
+    // Dropped and asked for again
+    auto response = inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10});
+    EXPECT_FALSE(response.has_value());
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Pick"}}));
+
+    const auto& requests = inputManager.getPendingRequests();
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_TRUE(std::holds_alternative<GetRangeInputMessage>(requests[0].inner));
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{RangeInputMessage{String{"p1"}, String{"Pick"}, Integer{7}}}}
+    );
+    response = inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10});
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(*response, Integer{7});
 }
 
 TEST_F(InputManagerTest, ClearPendingRequests) {
@@ -134,6 +146,30 @@ TEST_F(InputManagerTest, ClearPendingRequests) {
     EXPECT_EQ(messages2.size(), 0);
 }
 
+TEST_F(InputManagerTest, DrainPendingRequests) {
+    EXPECT_FALSE(inputManager.hasPendingRequests());
+
+    inputManager.getTextInput(String{"p1"}, String{"Q1"});
+    inputManager.getTextInput(String{"p2"}, String{"Q2"});
+    EXPECT_TRUE(inputManager.hasPendingRequests());
+
+    std::vector<GameMessage> drained{
+        GameMessage{GetTextInputMessage{String{"stale"}, String{"stale"}}}
+    };
+    inputManager.drainPendingRequests(drained);
+
+    ASSERT_EQ(drained.size(), 2);
+    EXPECT_EQ(std::get<GetTextInputMessage>(drained[0].inner).playerID, String{"p1"});
+    EXPECT_EQ(std::get<GetTextInputMessage>(drained[1].inner).playerID, String{"p2"});
+    EXPECT_FALSE(inputManager.hasPendingRequests());
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 0);
+
+    inputManager.getTextInput(String{"p3"}, String{"Q3"});
+    inputManager.drainPendingRequests(drained);
+    ASSERT_EQ(drained.size(), 1);
+    EXPECT_EQ(std::get<GetTextInputMessage>(drained[0].inner).playerID, String{"p3"});
+}
+
 TEST_F(InputManagerTest, ResponsesPersistAfterClear) {
     inputManager.getTextInput(String{"p1"}, String{"Name?"});
 
@@ -148,6 +184,331 @@ TEST_F(InputManagerTest, ResponsesPersistAfterClear) {
     EXPECT_EQ(*response, String{"Alice"});
 }
 
+TEST_F(InputManagerTest, HasResponseMatchesPlayerAndPrompt) {
+    InputWaitKey key{String{"p1"}, String{"Name?"}};
+    EXPECT_FALSE(inputManager.hasResponse(key));
+
+    std::vector<GameMessage> responses = {
+        GameMessage{TextInputMessage{String{"p1"}, String{"Age?"}, String{"7"}}},
+        GameMessage{TextInputMessage{String{"p2"}, String{"Name?"}, String{"Bob"}}}
+    };
+    inputManager.handleIncomingMessages(responses);
+    EXPECT_FALSE(inputManager.hasResponse(key));
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{"Name?"}, String{"Alice"}}}}
+    );
+    EXPECT_TRUE(inputManager.hasResponse(key));
+
+    inputManager.getTextInput(String{"p1"}, String{"Name?"});
+    EXPECT_FALSE(inputManager.hasResponse(key));
+}
+
+TEST_F(InputManagerTest, PrefetchRequestSkipsSentAndAnswered) {
+    inputManager.prefetchRequest(GameMessage{GetTextInputMessage{String{"p1"}, String{"Name?"}}});
+    inputManager.getTextInput(String{"p1"}, String{"Name?"});
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 1);
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p2"}, String{"Name?"}, String{"Bob"}}}}
+    );
+    inputManager.prefetchRequest(GameMessage{GetTextInputMessage{String{"p2"}, String{"Name?"}}});
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 1);
+
+    // Prefetching never consumes the answer
+    auto response = inputManager.getTextInput(String{"p2"}, String{"Name?"});
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(*response, String{"Bob"});
+}
+
+TEST_F(InputManagerTest, RequestsGetIDsThatResponsesEcho) {
+    inputManager.getTextInput(String{"p1"}, String{"Name?"});
+    inputManager.getTextInput(String{"p2"}, String{"Name?"});
+    inputManager.getTextInput(String{"p1"}, String{"Name?"}); // still the same request
+
+    const auto& requests = inputManager.getPendingRequests();
+    ASSERT_EQ(requests.size(), 2);
+    RequestID first = std::get<GetTextInputMessage>(requests[0].inner).requestID;
+    RequestID second = std::get<GetTextInputMessage>(requests[1].inner).requestID;
+    EXPECT_NE(first, NO_REQUEST_ID);
+    EXPECT_NE(second, NO_REQUEST_ID);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(inputManager.findRequestID(String{"p2"}, String{"Name?"}), second);
+
+    // The ID alone identifies the request, so the prompt can be left out
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p2"}, String{}, String{"Bob"}, second}}}
+    );
+    EXPECT_TRUE(inputManager.hasResponse(InputWaitKey{String{"p2"}, String{"Name?"}, second}));
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Name?"}, first}));
+
+    auto response = inputManager.getTextInput(String{"p2"}, String{"Name?"});
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(*response, String{"Bob"});
+}
+
+TEST_F(InputManagerTest, CallersCanKeepTheRequestID) {
+    RequestID requestID = NO_REQUEST_ID;
+    EXPECT_FALSE(inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10}, requestID));
+    EXPECT_EQ(requestID, inputManager.findRequestID(String{"p1"}, String{"Pick"}));
+
+    RequestID asked = requestID;
+    EXPECT_FALSE(inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10}, requestID));
+    EXPECT_EQ(requestID, asked);
+    EXPECT_EQ(inputManager.getPendingRequests().size(), 1);
+
+    // Out of range: asked again under a new ID
+    inputManager.handleIncomingMessages({GameMessage{RangeInputMessage{String{"p1"}, String{}, Integer{11}, requestID}}});
+    EXPECT_FALSE(inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10}, requestID));
+    EXPECT_NE(requestID, asked);
+
+    inputManager.handleIncomingMessages({GameMessage{RangeInputMessage{String{"p1"}, String{}, Integer{7}, requestID}}});
+    EXPECT_TRUE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Pick"}, requestID}));
+    EXPECT_EQ(inputManager.getRangeInput(String{"p1"}, String{"Pick"}, Integer{1}, Integer{10}, requestID), Integer{7});
+    EXPECT_EQ(requestID, NO_REQUEST_ID);
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 0);
+}
+
+TEST_F(InputManagerTest, RequestsWithIDsAreNeverLookedUpByPrompt) {
+    RequestID first = NO_REQUEST_ID;
+    RequestID second = NO_REQUEST_ID;
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Name?"}, first));
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Name?"}, second));
+    EXPECT_NE(first, second);
+
+    // Each caller only gets the answer to its own request
+    inputManager.handleIncomingMessages({GameMessage{TextInputMessage{String{"p1"}, String{}, String{"Alice"}, first}}});
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Name?"}, second));
+    EXPECT_EQ(inputManager.getTextInput(String{"p1"}, String{"Name?"}, first), String{"Alice"});
+
+    // The newer request is still open for responses without an ID
+    inputManager.handleIncomingMessages({GameMessage{TextInputMessage{String{"p1"}, String{"Name?"}, String{"Bob"}}}});
+    EXPECT_EQ(inputManager.getTextInput(String{"p1"}, String{"Name?"}, second), String{"Bob"});
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 0);
+}
+
+TEST_F(InputManagerTest, CopiesAreAnsweredApart) {
+    RequestID requestID = NO_REQUEST_ID;
+    inputManager.getTextInput(String{"p1"}, String{"Name?"}, requestID);
+    RequestID voteID = NO_REQUEST_ID;
+    List<Value> choices{Value{String{"Yes"}}, Value{String{"No"}}};
+    inputManager.getGroupVote({String{"p2"}}, String{"Agree?"}, choices, voteID);
+
+    InputManager copy = inputManager;
+    copy.handleIncomingMessages({
+        GameMessage{TextInputMessage{String{"p1"}, String{}, String{"Alice"}, requestID}},
+        GameMessage{VoteInputMessage{String{"p2"}, String{"Agree?"}, String{"Yes"}}}
+    });
+    EXPECT_TRUE(copy.hasResponse(InputWaitKey{String{"p1"}, String{"Name?"}, requestID}));
+    EXPECT_TRUE(copy.hasResponse(InputWaitKey{String{}, String{"Agree?"}, voteID}));
+
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Name?"}, requestID}));
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{}, String{"Agree?"}, voteID}));
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 2);
+}
+
+TEST_F(InputManagerTest, DropsResponsesForAnotherPlayersRequest) {
+    inputManager.getTextInput(String{"p1"}, String{"Name?"});
+    RequestID requestID = inputManager.findRequestID(String{"p1"}, String{"Name?"});
+
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p2"}, String{"Name?"}, String{"Mallory"}, requestID}}}
+    );
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Name?"}, requestID}));
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Name?"}).has_value());
+}
+
+TEST_F(InputManagerTest, DropsResponsesToUnknownRequests) {
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{"Name?"}, String{"Alice"}, RequestID{42}}}}
+    );
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Name?"}).has_value());
+
+    RequestID requestID = inputManager.findRequestID(String{"p1"}, String{"Name?"});
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{}, String{"Alice"}, requestID}}}
+    );
+    auto response = inputManager.getTextInput(String{"p1"}, String{"Name?"});
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(*response, String{"Alice"});
+}
+
+TEST_F(InputManagerTest, ConsumedRequestsAreDroppedAndCanBeAskedAgain) {
+    for (int round = 0; round < 3; ++round) {
+        inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+        RequestID requestID = inputManager.findRequestID(String{"p1"}, String{"Guess?"});
+        ASSERT_NE(requestID, NO_REQUEST_ID);
+        EXPECT_EQ(inputManager.getOpenRequestCount(), 1);
+
+        std::vector<GameMessage> drained;
+        inputManager.drainPendingRequests(drained);
+        ASSERT_EQ(drained.size(), 1); // asked again every round
+        EXPECT_EQ(std::get<GetTextInputMessage>(drained[0].inner).requestID, requestID);
+
+        inputManager.handleIncomingMessages(
+            {GameMessage{TextInputMessage{String{"p1"}, String{}, String{std::to_string(round)}, requestID}}}
+        );
+        auto response = inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+        ASSERT_TRUE(response.has_value());
+        EXPECT_EQ(*response, String{std::to_string(round)});
+        EXPECT_EQ(inputManager.getOpenRequestCount(), 0);
+    }
+}
+
+TEST_F(InputManagerTest, RejectsRepeatedAndLateResponses) {
+    inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+    RequestID first = inputManager.findRequestID(String{"p1"}, String{"Guess?"});
+
+    inputManager.handleIncomingMessages({
+        GameMessage{TextInputMessage{String{"p1"}, String{}, String{"a"}, first}},
+        GameMessage{TextInputMessage{String{"p1"}, String{}, String{"b"}, first}},
+        GameMessage{TextInputMessage{String{"p1"}, String{"Guess?"}, String{"c"}}},
+    });
+    auto response = inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(*response, String{"a"});
+
+    // The next round's request has a new ID, so the old one is late
+    inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+    RequestID second = inputManager.findRequestID(String{"p1"}, String{"Guess?"});
+    EXPECT_NE(second, first);
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{}, String{"a again"}, first}}}
+    );
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Guess?"}, second}));
+}
+
+TEST_F(InputManagerTest, RejectsLateResponsesWithoutAnID) {
+    inputManager.getTextInput(String{"p1"}, String{"Guess?"});
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{"Guess?"}, String{"a"}}}}
+    );
+    ASSERT_EQ(inputManager.getTextInput(String{"p1"}, String{"Guess?"}), String{"a"});
+
+    // Sent again after it was consumed, so it doesn't answer the next round
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"p1"}, String{"Guess?"}, String{"a"}}}}
+    );
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{"Guess?"}}));
+    EXPECT_FALSE(inputManager.getTextInput(String{"p1"}, String{"Guess?"}).has_value());
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 1);
+}
+
+TEST_F(InputManagerTest, EarlyResponsesExpireOnceAsked) {
+    List<Value> choices{};
+    choices.value = {Value{String{"yes"}}, Value{String{"no"}}};
+    inputManager.handleIncomingMessages(
+        {GameMessage{TextInputMessage{String{"0"}, String{"Agree?"}, String{"yes"}}}}
+    );
+    ASSERT_TRUE(inputManager.hasResponse(InputWaitKey{String{"0"}, String{"Agree?"}}));
+
+    RequestID voteID = NO_REQUEST_ID;
+    inputManager.getGroupVote({String{"0"}}, String{"Agree?"}, choices, voteID);
+    RequestID ballotID = inputManager.findRequestID(String{"0"}, String{"Agree?"});
+    inputManager.handleIncomingMessages(
+        {GameMessage{VoteInputMessage{String{"0"}, String{"Agree?"}, String{"no"}, ballotID}}}
+    );
+    auto tally = inputManager.getGroupVote({String{"0"}}, String{"Agree?"}, choices, voteID);
+    ASSERT_TRUE(tally.has_value());
+    EXPECT_EQ(tally->getCount(String{"no"}), 1);
+
+    // The answer that came before the vote isn't kept for a later one
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"0"}, String{"Agree?"}}));
+}
+
+TEST_F(InputManagerTest, ClosedVoteExpiresItsRequests) {
+    List<Value> choices{};
+    choices.value = {Value{String{"yes"}}, Value{String{"no"}}};
+    std::vector<String> voters{String{"0"}, String{"1"}, String{"2"}};
+    RequestID voteID = NO_REQUEST_ID;
+    inputManager.getGroupVote(voters, String{"Agree?"}, choices, voteID);
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 3);
+
+    inputManager.clearPendingRequests();
+    inputManager.handleIncomingMessages({
+        GameMessage{VoteInputMessage{String{"0"}, String{"Agree?"}, String{"yes"}}},
+        GameMessage{VoteInputMessage{String{"1"}, String{"Agree?"}, String{"maybe"}}}, // asked again
+        GameMessage{VoteInputMessage{String{"2"}, String{"Agree?"}, String{"yes"}}},
+    });
+    ASSERT_EQ(inputManager.getPendingRequests().size(), 1);
+
+    // Decided, so the request that's still queued is never sent
+    ASSERT_TRUE(inputManager.getGroupVote(voters, String{"Agree?"}, choices, voteID).has_value());
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 0);
+    EXPECT_FALSE(inputManager.hasPendingRequests());
+}
+
+TEST_F(InputManagerTest, OpenRequestsBecomeBallots) {
+    List<Value> choices{Value{String{"Yes"}}, Value{String{"No"}}};
+    inputManager.prefetchRequest(
+        GameMessage{GetVoteInputMessage{String{"0"}, String{"Agree?"}, ChoiceSet::intern(choices)}});
+    inputManager.prefetchRequest(
+        GameMessage{GetVoteInputMessage{String{"1"}, String{"Agree?"}, ChoiceSet::intern(choices)}});
+    RequestID early = inputManager.findRequestID(String{"0"}, String{"Agree?"});
+    RequestID late = inputManager.findRequestID(String{"1"}, String{"Agree?"});
+    inputManager.handleIncomingMessages({GameMessage{VoteInputMessage{String{"0"}, String{}, String{"Yes"}, early}}});
+
+    // The answered request is counted as a vote, the open one is a ballot
+    RequestID voteID = NO_REQUEST_ID;
+    EXPECT_FALSE(inputManager.getGroupVote({String{"0"}, String{"1"}}, String{"Agree?"}, choices, voteID));
+    EXPECT_EQ(inputManager.getOpenRequestCount(), 1);
+
+    inputManager.handleIncomingMessages({GameMessage{VoteInputMessage{String{"1"}, String{}, String{"Yes"}, late}}});
+    auto tally = inputManager.getGroupVote({String{"0"}, String{"1"}}, String{"Agree?"}, choices, voteID);
+    ASSERT_TRUE(tally.has_value());
+    EXPECT_EQ(tally->getVotesCast(), 2);
+    EXPECT_EQ(tally->getCount(String{"Yes"}), 2);
+}
+
+TEST_F(InputManagerTest, BoundsResponsesToPromptsNotAskedYet) {
+    std::vector<GameMessage> responses;
+    for (size_t i = 0; i < InputManager::MAX_UNSOLICITED_RESPONSES + 10; ++i) {
+        responses.push_back(GameMessage{TextInputMessage{String{"p1"}, String{std::to_string(i)}, String{"x"}}});
+    }
+    inputManager.handleIncomingMessages(responses);
+
+    std::string last = std::to_string(InputManager::MAX_UNSOLICITED_RESPONSES - 1);
+    std::string over = std::to_string(InputManager::MAX_UNSOLICITED_RESPONSES);
+    EXPECT_TRUE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{last}}));
+    EXPECT_FALSE(inputManager.hasResponse(InputWaitKey{String{"p1"}, String{over}}));
+}
+
+TEST_F(InputManagerTest, EqualChoicesAreInternedOnce) {
+    size_t internedBefore = ChoiceSet::getInternedCount();
+    {
+        List<Value> choices{};
+        choices.value = {Value{String{"Rock"}}, Value{Integer{2}}};
+        ChoiceSet first = ChoiceSet::intern(choices);
+        ChoiceSet second = ChoiceSet::intern(List<Value>{choices});
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(&*first, &*second);
+        EXPECT_EQ(first.getTexts(), (std::vector<std::string>{"Rock", "2"}));
+
+        choices.value.pop_back();
+        EXPECT_NE(ChoiceSet::intern(choices), first);
+        EXPECT_EQ(ChoiceSet::getInternedCount(), internedBefore + 1);
+    }
+    // Freed with the last request holding them
+    EXPECT_EQ(ChoiceSet::getInternedCount(), internedBefore);
+    EXPECT_EQ(ChoiceSet::intern(List<Value>{}), ChoiceSet{});
+}
+
+TEST_F(InputManagerTest, VoteRequestsShareTheirChoices) {
+    List<Value> choices{};
+    choices.value = {Value{String{"yes"}}, Value{String{"no"}}};
+    std::vector<String> voters{String{"0"}, String{"1"}, String{"2"}};
+    RequestID voteID = NO_REQUEST_ID;
+    inputManager.getGroupVote(voters, String{"Agree?"}, choices, voteID);
+    inputManager.getVoteInput(String{"3"}, String{"Also agree?"}, choices);
+
+    const auto& requests = inputManager.getPendingRequests();
+    ASSERT_EQ(requests.size(), 4);
+    const List<Value>* shared = &*std::get<GetVoteInputMessage>(requests[0].inner).choices;
+    for (const auto& request : requests) {
+        EXPECT_EQ(&*std::get<GetVoteInputMessage>(request.inner).choices, shared);
+    }
+}
+
 TEST_F(InputManagerTest, EmptyMessageList) {
     std::vector<GameMessage> empty;
     EXPECT_NO_THROW(inputManager.handleIncomingMessages(empty));
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "MessageTranslator.h"
+
+TEST(MessageTranslatorTest, RequestIDsRoundTrip) {
+    std::string serialized = MessageTranslator::serialize(
+        Message{MessageType::RequestTextInput, RequestTextInputMessage{"Name?", 7}});
+    EXPECT_EQ(serialized, "#7:RequestTextInput:Name?");
+
+    Message request = MessageTranslator::deserialize(serialized);
+    ASSERT_EQ(request.type, MessageType::RequestTextInput);
+    EXPECT_EQ(std::get<RequestTextInputMessage>(request.data).prompt, "Name?");
+    EXPECT_EQ(std::get<RequestTextInputMessage>(request.data).requestID, 7u);
+
+    Message response = MessageTranslator::deserialize("#7:ResponseChoiceInput:Rock|");
+    ASSERT_EQ(response.type, MessageType::ResponseChoiceInput);
+    EXPECT_EQ(std::get<ResponseChoiceInputMessage>(response.data).choice, "Rock");
+    EXPECT_EQ(std::get<ResponseChoiceInputMessage>(response.data).requestID, 7u);
+}
+
+TEST(MessageTranslatorTest, ChoiceRequestsCarryTheirChoices) {
+    auto choices = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"Rock", "Paper"});
+    std::string serialized = MessageTranslator::serialize(
+        Message{MessageType::RequestChoiceInput, RequestChoiceInputMessage{"Pick", choices, 3}});
+    EXPECT_EQ(serialized, "#3:RequestChoiceInput:Pick|Rock|Paper");
+
+    Message request = MessageTranslator::deserialize(serialized);
+    ASSERT_EQ(request.type, MessageType::RequestChoiceInput);
+    const auto& choice = std::get<RequestChoiceInputMessage>(request.data);
+    EXPECT_EQ(choice.prompt, "Pick");
+    ASSERT_TRUE(choice.choices);
+    EXPECT_EQ(*choice.choices, *choices);
+    EXPECT_EQ(choice.requestID, 3u);
+}
+
+TEST(MessageTranslatorTest, PromptsWithoutAnIDAreKeptWhole) {
+    std::string serialized = MessageTranslator::serialize(
+        Message{MessageType::RequestTextInput, RequestTextInputMessage{"Pick A|#2 or B"}});
+    EXPECT_EQ(serialized, "RequestTextInput:Pick A|#2 or B");
+
+    Message request = MessageTranslator::deserialize(serialized);
+    ASSERT_EQ(request.type, MessageType::RequestTextInput);
+    EXPECT_EQ(std::get<RequestTextInputMessage>(request.data).prompt, "Pick A|#2 or B");
+    EXPECT_EQ(std::get<RequestTextInputMessage>(request.data).requestID, 0u);
+}
+
+TEST(MessageTranslatorTest, PromptReferencesStartingWithAHashAreNotIDs) {
+    Message response = MessageTranslator::deserialize("ResponseTextInput:Alice|#1 fan");
+    ASSERT_EQ(response.type, MessageType::ResponseTextInput);
+    const auto& text = std::get<ResponseTextInputMessage>(response.data);
+    EXPECT_EQ(text.input, "Alice");
+    EXPECT_EQ(text.promptReference, "#1 fan");
+    EXPECT_EQ(text.requestID, 0u);
+
+    Message range = MessageTranslator::deserialize("ResponseRangeInput:4|#5");
+    ASSERT_EQ(range.type, MessageType::ResponseRangeInput);
+    EXPECT_EQ(std::get<ResponseRangeInputMessage>(range.data).promptRef, "#5");
+    EXPECT_EQ(std::get<ResponseRangeInputMessage>(range.data).requestID, 0u);
+}
+
+TEST(MessageTranslatorTest, MalformedRequestIDsAreNotParsed) {
+    EXPECT_EQ(MessageTranslator::deserialize("#x:ResponseTextInput:Alice|Name?").type, MessageType::Empty);
+    EXPECT_EQ(MessageTranslator::deserialize("#12").type, MessageType::Empty);
+}
@@ -69,4 +69,62 @@ rules {
 
     ts_tree_delete(tree);
     ts_parser_delete(parser);
-}
\ No newline at end of file
+}
+
+TEST_F(GameSpecLoaderTest, ASTConverter_CollectValueCannotUseTheElement) {
+    std::string src = R"(
+configuration {
+  name: "Test"
+  player range: (1, 1)
+  audience: false
+  setup: {}
+}
+constants {}
+variables {}
+per-player {}
+per-audience {}
+rules {
+  x <- players.collect(p, p.team = team);
+  x <- players.collect(p, p.team = p.rival);
+  x <- players.collect(p, p.team = p.rival + 1);
+}
+    )";
+
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_socialgaming());
+    NodeType::init(tree_sitter_socialgaming());
+
+    TSTree *tree = ts_parser_parse_string(parser, nullptr, src.c_str(), (uint32_t)src.size());
+    TSNode root = ts_tree_root_node(tree);
+
+    TSNode rules = TSNode{};
+    uint32_t count = ts_node_child_count(root);
+    for (uint32_t i = 0; i < count; ++i) {
+        TSNode child = ts_node_child(root, i);
+        if (ts_node_symbol(child) == NodeType::RULES) {
+            rules = child;
+            break;
+        }
+    }
+    ASSERT_FALSE(ts_node_is_null(rules)) << "No rules block found";
+    TSNode body = ts_node_named_child(rules, 0);
+
+    // The value is worked out before the loop, so it can't mention p
+    std::vector<TSNode> assignments;
+    uint32_t n = ts_node_named_child_count(body);
+    for (uint32_t i = 0; i < n; ++i) {
+        TSNode st = ts_node_named_child(body, i);
+        if (ts_node_symbol(st) == NodeType::RULE)
+            st = ts_node_named_child(st, 0);
+        if (ts_node_symbol(st) == NodeType::ASSIGNMENT)
+            assignments.push_back(st);
+    }
+    ASSERT_EQ(assignments.size(), 3u);
+
+    EXPECT_NE(ASTConverter::convertAssignment(src, assignments[0]), nullptr);
+    EXPECT_THROW(ASTConverter::convertAssignment(src, assignments[1]), std::runtime_error);
+    EXPECT_THROW(ASTConverter::convertAssignment(src, assignments[2]), std::runtime_error);
+
+    ts_tree_delete(tree);
+    ts_parser_delete(parser);
+}
@@ -333,7 +333,7 @@ rules {
     EXPECT_EQ(spec.rulesProgram.size(), 1);
 }
 
-TEST(RPSTest, UnsupportedMessageSkipped) {
+TEST(RPSTest, MessageTemplateIsSplitOnLoad) {
     std::string gameSpec = R"(
 configuration {
   name: "Test Message"
@@ -346,13 +346,24 @@ variables {}
 per-player {}
 per-audience {}
 rules {
-  message all "Hello!";
+  message all "Round {round} of {rounds}";
 }
 )";
 
     GameSpecLoader loader;
     GameSpec spec = loader.loadString(gameSpec);
-    EXPECT_EQ(spec.rulesProgram.size(), 0) << "Message should be skipped (unsupported)";
+    ASSERT_EQ(spec.rulesProgram.size(), 1);
+
+    auto* message = ast::castStatementToMessage(spec.rulesProgram[0].get());
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->getPlayers(), nullptr);
+
+    auto segments = message->getSegments();
+    ASSERT_EQ(segments.size(), 4);
+    EXPECT_EQ(segments[0].text, "Round ");
+    EXPECT_NE(ast::castExpressionToVariable(segments[1].expression.get()), nullptr);
+    EXPECT_EQ(segments[2].text, " of ");
+    EXPECT_NE(ast::castExpressionToVariable(segments[3].expression.get()), nullptr);
 }
 
 TEST(RPSTest, UnsupportedMethodCallSkipped) {
@@ -103,3 +103,30 @@ TEST(RulesTest, MakeInputTextStatementWithAttributeTarget)
     EXPECT_NE(baseVar, nullptr);
     EXPECT_EQ(baseVar->getName(), Name{"playerMap"});
 }
+
+TEST(RulesTest, MentionsVariableLooksInEveryOperand)
+{
+    auto sum = ast::makeArithmeticOperation(
+        ast::makeAttribute(ast::makeVariable(Name{"p"}), String{"wins"}),
+        ast::makeConstant(Value{Integer{1}}),
+        ast::ArithmeticOperation::Kind::ADD
+    );
+    EXPECT_TRUE(ast::mentionsVariable(sum.get(), Name{"p"}));
+    EXPECT_FALSE(ast::mentionsVariable(sum.get(), Name{"q"}));
+
+    auto negation = ast::makeUnaryOperation(
+        ast::makeAttribute(ast::makeVariable(Name{"p"}), String{"ready"}),
+        ast::UnaryOperation::Kind::NOT
+    );
+    EXPECT_TRUE(ast::mentionsVariable(negation.get(), Name{"p"}));
+
+    ast::ExpressionsBuilder argsBuilder;
+    auto contains = ast::makeCallable(
+        ast::makeVariable(Name{"winners"}),
+        argsBuilder.addExpression(ast::makeVariable(Name{"p"})).build(),
+        ast::Callable::Kind::CONTAINS
+    );
+    EXPECT_TRUE(ast::mentionsVariable(contains.get(), Name{"p"}));
+    EXPECT_TRUE(ast::mentionsVariable(contains.get(), Name{"winners"}));
+    EXPECT_FALSE(ast::mentionsVariable(ast::makeConstant(Value{Integer{1}}).get(), Name{"p"}));
+}
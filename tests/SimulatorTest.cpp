@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include "GameSession/GameSession.h"
+#include "Simulator/Simulator.h"
+#include "Simulator/WorkStealingPool.h"
+
+using namespace ast;
+
+// Player 1 picks a colour, which is the game's outcome
+static SharedProgram makePickColourProgram() {
+    GameRules rules;
+    rules.statements.push_back(makeInputChoice(
+        makeVariable(Name{"player1"}),
+        makeVariable(Name{"game_result"}),
+        String{"Pick a colour"},
+        makeConstant(Value{List<Value>{Value{String{"red"}}, Value{String{"blue"}}}})
+    ));
+    return GameSession::compileRules(std::move(rules));
+}
+
+TEST(SimulatorTest, PoolRunsEveryTaskOnce) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> runs(1000);
+
+    pool.run(runs.size(), [&](size_t, size_t index) { ++runs[index]; });
+
+    for (const auto& count : runs) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(SimulatorTest, ScriptedAnswersDecideEveryGame) {
+    auto policy = std::make_shared<ScriptedBotPolicy>(
+        std::unordered_map<std::string, std::string>{{"Pick a colour", "blue"}},
+        std::make_shared<RandomBotPolicy>()
+    );
+    Simulator simulator(makePickColourProgram(), policy);
+
+    SimulationConfig config;
+    config.games = 200;
+    config.threads = 3;
+    SimulationReport report = simulator.run(config);
+
+    EXPECT_EQ(report.games, 200);
+    EXPECT_EQ(report.outcomes, (std::map<std::string, size_t>{{"blue", 200}}));
+}
+
+TEST(SimulatorTest, RandomOutcomesDontDependOnThreads) {
+    Simulator simulator(makePickColourProgram(), std::make_shared<RandomBotPolicy>());
+
+    SimulationConfig config;
+    config.games = 500;
+    config.seed = 7;
+    config.threads = 1;
+    SimulationReport serial = simulator.run(config);
+    config.threads = 4;
+    SimulationReport parallel = simulator.run(config);
+
+    EXPECT_EQ(serial.outcomes, parallel.outcomes);
+    EXPECT_EQ(serial.outcomes["red"] + serial.outcomes["blue"], 500);
+    EXPECT_GT(serial.outcomes["red"], 0);
+    EXPECT_GT(serial.outcomes["blue"], 0);
+}
+
+TEST(SimulatorTest, GameWithoutOutcomeIsReported) {
+    Simulator simulator(makePickColourProgram(), std::make_shared<RandomBotPolicy>());
+
+    SimulationConfig config;
+    config.games = 10;
+    config.outcomeVariable = "winner";
+    SimulationReport report = simulator.run(config);
+
+    EXPECT_EQ(report.outcomes, (std::map<std::string, size_t>{{"(no winner)", 10}}));
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+#include "TaskPool.h"
+
+TEST(TaskPoolTest, RunsEveryIndexOnce)
+{
+    TaskPool pool{4};
+    EXPECT_EQ(pool.getThreadCount(), 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    pool.run(runs.size(), [&runs](size_t index) {
+        runs[index]++;
+    });
+
+    for (const auto& count : runs)
+    {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(TaskPoolTest, NestedRunsStayOnTheirThread)
+{
+    TaskPool pool{3};
+
+    std::atomic<int> total{0};
+    pool.run(8, [&pool, &total](size_t) {
+        pool.run(10, [&total](size_t) { total++; });
+    });
+
+    EXPECT_EQ(total.load(), 80);
+}
+
+TEST(TaskPoolTest, CallersShareThePool)
+{
+    TaskPool pool{2};
+
+    std::atomic<int> total{0};
+    std::vector<std::jthread> callers;
+    for (int caller = 0; caller < 4; caller++)
+    {
+        callers.emplace_back([&pool, &total] {
+            for (int batch = 0; batch < 50; batch++)
+            {
+                pool.run(16, [&total](size_t) { total++; });
+            }
+        });
+    }
+    callers.clear(); // joins
+
+    EXPECT_EQ(total.load(), 4 * 50 * 16);
+}
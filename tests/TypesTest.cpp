@@ -225,3 +225,68 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(Value{Map<String, Value>{}}, Value{Map<String, Value>{}}, std::nullopt)
     )
 );
+
+namespace
+{
+    // Long enough to take the parallel paths
+    List<Value>
+    makeLargeList()
+    {
+        List<Value> list;
+        for (size_t i = 0; i < PARALLEL_LIST_SIZE * 2 + 7; i++)
+        {
+            list.value.push_back(Value{Integer{static_cast<int>((i * 7919) % 100003)}});
+        }
+        return list;
+    }
+}
+
+TEST(TypesTest, SortLargeList)
+{
+    List<Value> list = makeLargeList();
+
+    List<Value> sorted = sortList(list);
+
+    std::vector<Value> expected = list.value;
+    std::sort(expected.begin(), expected.end(), [](const Value& a, const Value& b) {
+        return a.asInteger().value < b.asInteger().value;
+    });
+    EXPECT_EQ(sorted.value, expected);
+}
+
+TEST(TypesTest, ShuffleLargeListKeepsElements)
+{
+    List<Value> list = makeLargeList();
+    List<Value> shuffled = list;
+
+    shuffled.shuffle();
+
+    EXPECT_EQ(shuffled.value.size(), list.value.size());
+    EXPECT_FALSE(shuffled == list);
+    EXPECT_EQ(sortList(shuffled), sortList(list));
+}
+
+TEST(TypesTest, CompareLargeLists)
+{
+    List<Value> list = makeLargeList();
+    List<Value> copy = list;
+    EXPECT_TRUE(list == copy);
+    EXPECT_TRUE(Value{list} == Value{copy});
+
+    copy.value.back() = Value{String{"different"}};
+    EXPECT_FALSE(list == copy);
+    copy.value.pop_back();
+    EXPECT_FALSE(list == copy);
+}
+
+TEST(TypesTest, ExtendLargeListWithItself)
+{
+    List<Value> list = makeLargeList();
+    List<Value> original = list;
+
+    list.extend(list);
+
+    ASSERT_EQ(list.value.size(), original.value.size() * 2);
+    EXPECT_TRUE(std::equal(original.value.begin(), original.value.end(), list.value.begin()));
+    EXPECT_TRUE(std::equal(original.value.begin(), original.value.end(), list.value.begin() + original.value.size()));
+}